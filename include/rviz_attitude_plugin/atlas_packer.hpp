@@ -0,0 +1,85 @@
+/*
+ * RViz Attitude Display Plugin - Overlay Atlas Shelf Packer
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__ATLAS_PACKER_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__ATLAS_PACKER_HPP_
+
+#include <QRect>
+#include <QSize>
+
+#include <vector>
+
+namespace rviz_attitude_plugin
+{
+
+/**
+ * @brief Shelf layout of the shared overlay atlas.
+ *
+ * Rectangles go on the tightest shelf with room left, or on a new shelf
+ * below the last one when that shelf is much taller than the rectangle (and
+ * a new shelf still fits). Space is never freed piecemeal; repack() lays out
+ * the surviving rectangles from scratch instead.
+ *
+ * Region sizes are over-allocated in steps so that resizing rarely moves a
+ * region: coarse steps for the whole-HUD panel, which follows interactive
+ * resizes, and fine ones for component panels, which are many and small.
+ */
+class AtlasPacker
+{
+public:
+  static constexpr int ATLAS_WIDTH_PX = 2048;
+  static constexpr int ATLAS_MAX_HEIGHT_PX = 4096;
+
+  static constexpr unsigned int HUD_BUCKET_PX = 128;
+  static constexpr unsigned int COMPONENT_BUCKET_PX = 16;
+  static constexpr unsigned int MAX_BUCKETED_EXTENT_PX = 800;
+
+  explicit AtlasPacker(int width = ATLAS_WIDTH_PX, int max_height = ATLAS_MAX_HEIGHT_PX);
+
+  /**
+   * @brief Round extent up to a multiple of step.
+   *
+   * Rounding stops at MAX_BUCKETED_EXTENT_PX; larger extents are kept as is.
+   */
+  static unsigned int bucketedExtent(unsigned int extent, unsigned int step);
+
+  /**
+   * @brief Place a width x height rectangle.
+   * @return false if no shelf has room and no new shelf fits
+   */
+  bool pack(int width, int height, QRect & rect);
+
+  /**
+   * @brief Lay out sizes from scratch (tallest first), then place width x height.
+   * @param sizes Rectangles to keep
+   * @param placed Set to the new rectangle of each size, in the order given
+   * @return false if they do not all fit; the layout is then left untouched
+   */
+  bool repack(
+    const std::vector<QSize> & sizes, std::vector<QRect> & placed,
+    int width, int height, QRect & rect);
+
+  /**
+   * @brief Rows down to the bottom of the last shelf.
+   */
+  int usedHeight() const;
+
+  void clear() { shelves_.clear(); }
+
+private:
+  struct Shelf
+  {
+    int top;
+    int height;
+    int cursor;
+  };
+
+  int width_;
+  int max_height_;
+  std::vector<Shelf> shelves_;
+};
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__ATLAS_PACKER_HPP_
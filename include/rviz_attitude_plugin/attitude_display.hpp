@@ -8,21 +8,29 @@
 
 #include <rviz_common/display.hpp>
 #include <rviz_common/properties/enum_property.hpp>
+#include <rviz_common/properties/float_property.hpp>
 #include <rviz_common/properties/bool_property.hpp>
 #include <rviz_common/properties/int_property.hpp>
 #include <rviz_common/properties/string_property.hpp>
+#include <geometry_msgs/msg/pose.hpp>
 #include <geometry_msgs/msg/quaternion.hpp>
 
 #include <QEvent>
 
 #include <rclcpp/rclcpp.hpp>
 #include "rviz_attitude_plugin/topic_utilities.hpp"
+#include "rviz_attitude_plugin/attitude_history.hpp"
+#include "rviz_attitude_plugin/attitude_trail.hpp"
+#include "rviz_attitude_plugin/glyph_batch.hpp"
 #include "rviz_attitude_plugin/overlay_system.hpp"
+#include "rviz_attitude_plugin/perf_stats.hpp"
+#include "rviz_attitude_plugin/spectrum_analyzer.hpp"
 
 #include <memory>
 #include <string>
 #include <vector>
 #include <array>
+#include <cstdint>
 
 namespace rviz_common
 {
@@ -69,31 +77,54 @@ protected:
   void onDisable() override;
 
   void update(float wall_dt, float ros_dt) override;
+  void fixedFrameChanged() override;
 
 private Q_SLOTS:
   void updateAngleUnit();
   void updateDisplayMode();
+  void updateCompassCache();
   void updateOverlayProperties();
   void onRefreshTopics();
+  void onTopicScopeChanged();
   void onTopicChanged();
+  void updateShowTapes();
+  void updateTrail();
+  void updateShowStatistics();
+  void updateStatisticsWindow();
+  void updateShowSpectrum();
+  void updateShowPerformance();
+  void onProfilerChanged();
+  void onDumpTrace();
 
 private:
   void setupProperties();
   void updateDisplay(double x, double y, double z, double w);
+  void requestRender();
+  void updateGlyph();
+  void pushTrail(const AttitudeSample & sample);
+  bool transformPose(
+    const std::string & frame, int64_t stamp_ns, const geometry_msgs::msg::Pose & pose,
+    Ogre::Vector3 & position, Ogre::Quaternion & orientation);
   void attachOverlay();
   bool eventFilter(QObject * object, QEvent * event) override;
   void refreshSupportedTopics();
   void subscribeToSelected();
-  // Unified handler for normalized orientation messages
-  void onOrientation(const geometry_msgs::msg::Quaternion & q);
+  // Unified handler for every supported message type
+  void onOrientation(const AttitudeSample & sample);
 
   std::unique_ptr<EulerConverter> converter_;
   std::unique_ptr<AttitudeWidget> widget_;
 
   // Properties
   rviz_common::properties::EnumProperty * topic_property_;
+  rviz_common::properties::StringProperty * topic_namespace_property_;
+  rviz_common::properties::StringProperty * topic_filter_property_;
+  rviz_common::properties::EnumProperty * topic_type_property_;
   rviz_common::properties::BoolProperty * refresh_button_property_;
   rviz_common::properties::StringProperty * current_type_property_;
+  rviz_common::properties::BoolProperty * intra_process_property_;
+  rviz_common::properties::EnumProperty * imu_filter_property_;
+  rviz_common::properties::FloatProperty * imu_filter_gain_property_;
   rviz_common::properties::IntProperty * overlay_width_property_;
   rviz_common::properties::IntProperty * overlay_height_property_;
   rviz_common::properties::BoolProperty * show_overlay_property_;
@@ -102,13 +133,50 @@ private:
   rviz_common::properties::EnumProperty * overlay_anchor_property_;
   rviz_common::properties::EnumProperty * angle_unit_property_;
   rviz_common::properties::EnumProperty * display_mode_property_;
+  rviz_common::properties::EnumProperty * compass_cache_property_;
+  rviz_common::properties::BoolProperty * show_tapes_property_;
+  rviz_common::properties::BoolProperty * show_glyph_property_;
+  rviz_common::properties::FloatProperty * glyph_length_property_;
+  rviz_common::properties::FloatProperty * roll_alarm_property_;
+  rviz_common::properties::FloatProperty * pitch_alarm_property_;
+  rviz_common::properties::BoolProperty * show_trail_property_;
+  rviz_common::properties::IntProperty * trail_length_property_;
+  rviz_common::properties::FloatProperty * trail_tick_property_;
+  rviz_common::properties::BoolProperty * show_statistics_property_;
+  rviz_common::properties::FloatProperty * statistics_window_property_;
+  rviz_common::properties::BoolProperty * show_spectrum_property_;
+  rviz_common::properties::EnumProperty * spectrum_source_property_;
+  rviz_common::properties::BoolProperty * show_performance_property_;
+  rviz_common::properties::BoolProperty * profiler_property_;
+  rviz_common::properties::StringProperty * trace_file_property_;
+  rviz_common::properties::BoolProperty * dump_trace_property_;
 
   // State
   std::array<double, 4> last_quaternion_;  // x, y, z, w
+  int64_t last_stamp_ns_;                  // header stamp of the last sample, for tracing
+  std::array<double, 3> last_euler_;       // roll, pitch, yaw (rad) of the last sample
+  std::string last_frame_id_;              // header frame of the last sample
+  uint64_t last_frame_hash_;               // hashFrameId(last_frame_id_)
+  std::array<double, 3> last_position_;    // x, y, z in last_frame_id_ (zero without a pose)
   bool has_data_;
   rviz_common::RenderPanel * render_panel_;
   std::unique_ptr<OverlayManager> overlay_manager_;
   bool overlay_event_filter_installed_;
+  bool overlay_layout_pending_;
+  bool render_pending_;
+  bool overlay_atlas_full_;               // "Overlay" status is raised
+  PerfStats perf_stats_;
+  int64_t last_perf_refresh_ns_;
+  AttitudeHistory attitude_history_;
+  int64_t last_stats_refresh_ns_;
+  SpectrumAnalyzer spectrum_analyzer_;
+  std::shared_ptr<GlyphBatch> glyph_batch_;
+  int glyph_;
+  bool glyph_transform_failed_;
+  std::unique_ptr<AttitudeTrail> trail_;
+  bool trail_transform_failed_;
+  bool profiler_acquired_;                 // holds a Profiler::acquire() reference
+  SpectrumResult spectrum_result_;
 
   // Managers for separated concerns
   AttitudeTopicManager topic_manager_;
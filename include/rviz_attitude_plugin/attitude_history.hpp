@@ -0,0 +1,209 @@
+/*
+ * RViz Attitude Display Plugin - Attitude History and Windowed Statistics
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__ATTITUDE_HISTORY_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__ATTITUDE_HISTORY_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "rviz_attitude_plugin/euler_converter.hpp"
+
+namespace rviz_attitude_plugin
+{
+
+/**
+ * @brief Statistics of the samples inside the history window (radians).
+ */
+struct AttitudeStats
+{
+  size_t count{0};
+  double span_s{0.0};   // time covered by the samples
+
+  double roll_mean{0.0};
+  double roll_stddev{0.0};
+  double roll_min{0.0};
+  double roll_max{0.0};
+
+  double pitch_mean{0.0};
+  double pitch_stddev{0.0};
+  double pitch_min{0.0};
+  double pitch_max{0.0};
+
+  double yaw_mean{0.0};        // circular mean, (-pi, pi]
+  double yaw_stddev{0.0};      // circular standard deviation, sqrt(-2 ln R)
+  double yaw_resultant{0.0};   // mean resultant length R; 1 = no dispersion
+};
+
+/**
+ * @brief Compressed attitude samples with O(1) sliding-window statistics.
+ *
+ * Samples are stored in fixed-size blocks: quaternions in 48 bits
+ * (quaternion_codec) and times as 32-bit microsecond offsets from the
+ * block's base time, 10 bytes per sample instead of about 40. Blocks that
+ * leave the window are recycled, so a steady stream does not allocate.
+ *
+ * Samples older than the window (or beyond MAX_SAMPLES) leave from the
+ * front and are subtracted from the accumulators as they go, so every
+ * push is O(1) amortized whatever the window length:
+ *  - roll/pitch mean and variance with Welford's update and its inverse
+ *  - roll/pitch min/max with monotonic queues
+ *  - yaw as sums of sin/cos, giving the circular mean and dispersion
+ * Statistics see the decoded samples, so what is added and later removed
+ * is bit-identical. Subtraction still accumulates rounding, so once as
+ * many samples were removed as the window holds, a second set of sums is
+ * built a few samples per push, newest to oldest, and swapped in when it
+ * covers the window. No single push decodes the whole window.
+ */
+class AttitudeHistory
+{
+public:
+  static constexpr size_t BLOCK_SIZE = 64;
+  static constexpr size_t MAX_SAMPLES = size_t(1) << 22;  // ~2.9 h at 400 Hz, ~42 MB
+
+  AttitudeHistory();
+
+  /**
+   * @brief Length of the statistics window; shrinking it evicts at once.
+   */
+  void setWindow(double seconds);
+  double window() const { return window_ns_ * 1e-9; }
+
+  void clear();
+
+  /**
+   * @brief Append a sample; a step back in time starts a new history.
+   */
+  void push(int64_t time_ns, double x, double y, double z, double w);
+
+  size_t size() const { return size_; }
+
+  AttitudeStats stats() const;
+
+  /**
+   * @brief Index (0 = oldest) of the first sample at or after time_ns.
+   * @return size() if every sample is older
+   */
+  size_t lowerBound(int64_t time_ns) const;
+
+  /**
+   * @brief Decode samples [first, first + count) into separate arrays.
+   *
+   * Whole blocks are decoded with the vectorized codec path.
+   * @return Number of samples written
+   */
+  size_t read(
+    size_t first, size_t count, int64_t * time_ns,
+    float * x, float * y, float * z, float * w) const;
+
+private:
+  struct Block
+  {
+    int64_t base_ns;
+    size_t count;
+    std::array<uint32_t, BLOCK_SIZE> offset_us;
+    std::array<uint16_t, BLOCK_SIZE> a;   // quaternion_codec words
+    std::array<uint16_t, BLOCK_SIZE> b;
+    std::array<uint16_t, BLOCK_SIZE> c;
+
+    int64_t time(size_t i) const { return base_ns + int64_t(offset_us[i]) * 1000; }
+  };
+
+  struct Angles
+  {
+    double roll;
+    double pitch;
+    double yaw;
+  };
+
+  struct Welford
+  {
+    double count{0.0};
+    double mean{0.0};
+    double m2{0.0};
+
+    void add(double x);
+    void remove(double x);
+    double stddev() const;
+  };
+
+  struct Sums
+  {
+    Welford roll;
+    Welford pitch;
+    double yaw_sin{0.0};
+    double yaw_cos{0.0};
+
+    void add(const Angles & angles);
+    void remove(const Angles & angles);
+  };
+
+  /**
+   * @brief (position, value) pairs with monotonic values (front = extreme).
+   *
+   * A growable ring: it only allocates while the window grows.
+   */
+  class MonotonicQueue
+  {
+  public:
+    explicit MonotonicQueue(bool keep_max);
+
+    void clear();
+    void push(uint64_t position, double value);
+    void expire(uint64_t begin);
+    double front() const;
+
+  private:
+    struct Entry
+    {
+      uint64_t position;
+      double value;
+    };
+
+    void grow();
+
+    bool keep_max_;
+    std::vector<Entry> entries_;   // power-of-two size
+    uint64_t head_;
+    uint64_t tail_;
+  };
+
+  Angles angles(const Block & block, size_t i) const;
+  const Block & blockAt(size_t index, size_t & offset) const;
+  void evictOldest();
+
+  /**
+   * @brief Extend rebuilt_ by up to count samples towards the oldest.
+   *
+   * rebuilt_ replaces sums_ once it reaches the oldest sample.
+   */
+  void continueRebuild(size_t count);
+
+  EulerConverter converter_;
+  std::deque<std::unique_ptr<Block>> blocks_;
+  std::vector<std::unique_ptr<Block>> spare_blocks_;
+  size_t first_;        // oldest sample inside blocks_.front()
+  size_t size_;
+  uint64_t begin_;      // running position of the oldest sample
+  int64_t window_ns_;
+
+  Sums sums_;
+  size_t removals_;
+  Sums rebuilt_;            // sums over positions [rebuild_front_, end)
+  bool rebuilding_;
+  uint64_t rebuild_front_;
+
+  MonotonicQueue roll_min_;
+  MonotonicQueue roll_max_;
+  MonotonicQueue pitch_min_;
+  MonotonicQueue pitch_max_;
+};
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__ATTITUDE_HISTORY_HPP_
@@ -0,0 +1,109 @@
+/*
+ * RViz Attitude Display Plugin - 3D Attitude Trail
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__ATTITUDE_TRAIL_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__ATTITUDE_TRAIL_HPP_
+
+#include <OgreMaterial.h>
+#include <OgreQuaternion.h>
+#include <OgreVector3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Ogre
+{
+class SceneManager;
+class SceneNode;
+}
+
+namespace rviz_attitude_plugin
+{
+
+// ============================================================================
+// AttitudeTrail - Orientation history along the path
+// ============================================================================
+
+/**
+ * @brief Body-axis ticks (x red, y green, z blue) at past poses, joined by the path.
+ *
+ * Vertices live in one fixed-capacity dynamic vertex buffer used as a ring:
+ * a sample owns VERTICES_PER_SAMPLE consecutive vertices, the newest sample
+ * overwrites the oldest slot, and flush() writes only the slots pushed since
+ * the last frame (at most two ranges when they wrap). Every sample is drawn
+ * as independent line segments, so draw order does not matter and the whole
+ * filled buffer is one draw call; a 10k-sample trail costs the same per
+ * frame as a 100-sample one.
+ *
+ * Positions are baked in the fixed frame; the owner clears the trail when
+ * that frame changes.
+ */
+class AttitudeTrail
+{
+public:
+  static constexpr size_t VERTICES_PER_SAMPLE = 8;   // path segment + three ticks
+  static constexpr size_t MAX_CAPACITY = 100000;     // 12.8 MB of vertices
+
+  AttitudeTrail(Ogre::SceneManager * scene_manager, Ogre::SceneNode * parent);
+  ~AttitudeTrail();
+
+  AttitudeTrail(const AttitudeTrail &) = delete;
+  AttitudeTrail & operator=(const AttitudeTrail &) = delete;
+
+  /**
+   * @brief Number of samples kept; reallocates the buffer and clears the trail.
+   */
+  void setCapacity(size_t samples);
+  size_t capacity() const { return capacity_; }
+  size_t size() const { return size_; }
+
+  /**
+   * @brief Tick length in metres; applies to samples pushed afterwards.
+   */
+  void setTickLength(float length) { tick_length_ = length; }
+
+  void setVisible(bool visible);
+  void clear();
+
+  /**
+   * @brief Append a pose in the fixed frame, replacing the oldest when full.
+   */
+  void push(const Ogre::Vector3 & position, const Ogre::Quaternion & orientation);
+
+  /**
+   * @brief Write the samples pushed since the last flush to the vertex buffer.
+   * @return true if anything was written
+   */
+  bool flush();
+
+private:
+  class Renderable;
+
+  struct Vertex
+  {
+    float x, y, z;
+    uint32_t colour;   // VET_COLOUR_ABGR
+  };
+
+  void writeSlots(size_t first_slot, const Vertex * vertices, size_t samples);
+
+  Ogre::SceneManager * scene_manager_;
+  Ogre::SceneNode * node_;
+  Ogre::MaterialPtr material_;
+  std::unique_ptr<Renderable> renderable_;
+  size_t capacity_;
+  size_t size_;
+  size_t head_;                    // slot the next sample goes to
+  std::vector<Vertex> pending_;    // samples pushed since flush(), at most capacity_
+  size_t pending_samples_;
+  Ogre::Vector3 last_position_;
+  float tick_length_;
+  bool visible_;
+};
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__ATTITUDE_TRAIL_HPP_
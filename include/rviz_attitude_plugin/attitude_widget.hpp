@@ -10,6 +10,11 @@
 #include <memory>
 #include <array>
 
+#include "rviz_attitude_plugin/attitude_history.hpp"
+#include "rviz_attitude_plugin/perf_stats.hpp"
+#include "rviz_attitude_plugin/spectrum_analyzer.hpp"
+#include "rviz_attitude_plugin/widgets/component_frame.hpp"
+
 namespace rviz_attitude_plugin
 {
 namespace widgets
@@ -17,6 +22,10 @@ namespace widgets
 class AttitudeIndicator;
 class HeadingIndicator;
 class AngleReadout;
+class PerfStrip;
+class SpectrumPanel;
+class StatsReadout;
+class TapeIndicator;
 
 /**
  * @brief Frame widget with capsule/rounded background styling
@@ -26,6 +35,14 @@ class CapsuleFrame : public QWidget
   Q_OBJECT
 public:
   explicit CapsuleFrame(QWidget * parent = nullptr);
+
+  /**
+   * @brief The frame itself (not its children) at the current size.
+   */
+  ComponentFrame frame() const;
+
+  static void paintCapsule(QPainter & painter, const QSize & size);
+
 protected:
   void paintEvent(QPaintEvent * event) override;
 };
@@ -41,6 +58,38 @@ enum class DisplayMode
   Compact   // Heading and attitude only (minimal/compact display)
 };
 
+/**
+ * @brief Separately rendered parts of the attitude widget.
+ *
+ * Each component is uploaded to its own overlay panel, so a change to one
+ * input only re-rasters the component that shows it.
+ */
+enum class HudComponent : unsigned int
+{
+  Background = 0,   // Capsule frame behind the indicators
+  Heading,
+  Attitude,
+  SpeedTape,        // Tapes either side of the attitude indicator
+  AltitudeTape,
+  RollReadout,
+  PitchReadout,
+  YawReadout,
+  RollStats,        // Windowed statistics under the readouts
+  PitchStats,
+  YawStats,
+  Spectrum,         // Roll/pitch rate vibration spectrum
+  Perf,             // Pipeline performance strip (debugging aid)
+  Count
+};
+
+constexpr unsigned int componentBit(HudComponent component)
+{
+  return 1u << static_cast<unsigned int>(component);
+}
+
+constexpr unsigned int ALL_HUD_COMPONENTS =
+  (1u << static_cast<unsigned int>(HudComponent::Count)) - 1u;
+
 /**
  * @brief Main widget combining all attitude visualization components.
  * 
@@ -51,6 +100,7 @@ enum class DisplayMode
  * - Attitude indicator display (pitch, roll)
  * - Heading indicator
  * - Numeric readouts for roll, pitch, yaw (in Full mode)
+ * - Optional speed and altitude tapes around the attitude indicator
  * 
  * Supports two display modes:
  * - Full: Shows heading, attitude, and numeric angle readouts (complete information)
@@ -86,14 +136,71 @@ public:
   std::string getUnit() const;
   void setUnit(const std::string & unit);
 
+  /**
+   * @brief Draw the compass rose from pre-rotated sprites instead of one
+   *        rotated blit, for roses small enough to cache (see HeadingIndicator).
+   */
+  void setPreRotatedCompass(bool enabled);
+
   // Update visualization
   void updateAngles(double roll_rad, double pitch_rad, double yaw_rad);
 
+  // Speed (left) and altitude (right) tapes around the attitude indicator
+  bool showTapes() const { return show_tapes_; }
+  void setShowTapes(bool show);
+  void setSpeed(double speed);
+  void setAltitude(double altitude);
+  void clearSpeed();
+  void clearAltitude();
+
+  // Windowed statistics under the angle readouts
+  bool showStatistics() const { return show_statistics_; }
+  void setShowStatistics(bool show);
+  void setStatistics(const AttitudeStats & stats);
+
+  // Vibration spectrum below the readouts
+  bool showSpectrum() const { return show_spectrum_; }
+  void setShowSpectrum(bool show);
+  void setSpectrum(const SpectrumResult & result);
+
+  // Performance strip below the readouts
+  bool showPerformance() const { return show_performance_; }
+  void setShowPerformance(bool show);
+  void setPerfSnapshot(const PerfSnapshot & snapshot);
+
+  /**
+   * @brief Widget drawing a HUD component.
+   *
+   * For HudComponent::Background only the frame itself is meant to be
+   * painted, not its children.
+   */
+  QWidget * componentWidget(HudComponent component) const;
+
+  /**
+   * @brief Snapshot of a HUD component, to paint on any thread.
+   *
+   * Painted at the origin with the size of componentWidget(). Taking a
+   * frame counts its content as painted for the pixel-quantum checks of
+   * the setters.
+   */
+  widgets::ComponentFrame componentFrame(HudComponent component);
+
+  /**
+   * @brief Components whose appearance changed since the last call.
+   * @return Bit mask of componentBit() values; the mask is cleared
+   */
+  unsigned int takeDirtyComponents();
+
+  void markDirty(unsigned int components) { dirty_components_ |= components; }
+
 private:
   void buildUI();
   QWidget * buildIndicatorFrame();
   QWidget * buildReadoutFrame();
+  QWidget * buildSpectrumPanel();
+  QWidget * buildPerfStrip();
   void refreshReadouts();
+  void refreshStatistics();
   void updateDisplayMode();
   QString formatValue(double value, const QString & suffix) const;
 
@@ -101,20 +208,35 @@ private:
   QWidget * indicator_container_;
   widgets::AttitudeIndicator * attitude_indicator_;
   widgets::HeadingIndicator * heading_;
+  widgets::TapeIndicator * speed_tape_;
+  widgets::TapeIndicator * altitude_tape_;
   widgets::AngleReadout * roll_readout_;
   widgets::AngleReadout * pitch_readout_;
   widgets::AngleReadout * yaw_readout_;
+  widgets::StatsReadout * roll_stats_;
+  widgets::StatsReadout * pitch_stats_;
+  widgets::StatsReadout * yaw_stats_;
   widgets::CapsuleFrame * indicator_frame_;
   QWidget * readout_frame_;
+  widgets::SpectrumPanel * spectrum_panel_;
+  widgets::PerfStrip * perf_strip_;
 
   // State
   DisplayMode display_mode_;
   bool show_pitch_ladder_;
   bool show_roll_indicator_;
   bool show_heading_text_;
+  bool show_tapes_;
+  bool show_statistics_;
+  bool show_spectrum_;
+  bool show_performance_;
   std::string display_unit_;
   std::array<double, 3> angles_rad_;  // roll, pitch, yaw
   std::array<double, 3> angles_deg_;  // roll, pitch, yaw
+  std::array<long long, 3> readout_values_;  // values last formatted, in display resolution
+  bool readouts_valid_;
+  AttitudeStats statistics_;
+  unsigned int dirty_components_;
 };
 
 }  // namespace rviz_attitude_plugin
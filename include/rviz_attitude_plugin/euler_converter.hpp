@@ -18,6 +18,8 @@
     #include <tf2/LinearMath/Matrix3x3.h>
 #endif
 
+#include "rviz_attitude_plugin/profiler.hpp"
+
 namespace rviz_attitude_plugin
 {
 
@@ -35,6 +37,7 @@ public:
   inline void convert(double x, double y, double z, double w,
                       double & roll, double & pitch, double & yaw) const
   {
+    ATTITUDE_PROFILE_SCOPE("EulerConverter::convert");
     tf2::Quaternion q(x, y, z, w);
     if (q.length2() <= 0.0) {
       q.setValue(0.0, 0.0, 0.0, 1.0);
@@ -0,0 +1,125 @@
+/*
+ * RViz Attitude Display Plugin - Batched 3D Attitude Glyphs
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__GLYPH_BATCH_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__GLYPH_BATCH_HPP_
+
+#include <OgreColourValue.h>
+#include <OgreFrameListener.h>
+#include <OgreMaterial.h>
+#include <OgreQuaternion.h>
+#include <OgreVector3.h>
+
+#include <memory>
+#include <vector>
+
+namespace Ogre
+{
+class ManualObject;
+class SceneManager;
+class SceneNode;
+}
+
+namespace rviz_attitude_plugin
+{
+
+/**
+ * @brief Attitude alarm level, from roll/pitch against their limits.
+ */
+enum class AttitudeAlarm
+{
+  Normal,
+  Caution,   // beyond CAUTION_FRACTION of a limit
+  Alarm      // at or beyond a limit
+};
+
+/**
+ * @brief Classify roll/pitch (radians) against limits (radians; <= 0 disables).
+ */
+AttitudeAlarm classifyAttitude(double roll, double pitch, double roll_limit, double pitch_limit);
+
+// ============================================================================
+// GlyphBatch - Process-wide batched scene glyphs
+// ============================================================================
+
+/**
+ * @brief Small airplane glyphs for every attitude display, in one mesh.
+ *
+ * Like OverlayAtlas for the HUDs, one batch is shared by all displays:
+ * each display owns a glyph slot and sets its pose and colour; when any
+ * changed, the batch bakes every visible glyph into world-space vertices
+ * of one dynamic ManualObject at the start of the frame. Fifty vehicles
+ * cost one vertex buffer write and one draw call, not fifty objects.
+ *
+ * Vertex colours carry the alarm state, so a single unlit material serves
+ * every glyph.
+ */
+class GlyphBatch : public Ogre::FrameListener
+{
+public:
+  /**
+   * @brief Get the shared batch, creating it in scene_manager on first use.
+   *
+   * The batch is destroyed when the last holder releases it.
+   */
+  static std::shared_ptr<GlyphBatch> acquire(Ogre::SceneManager * scene_manager);
+
+  ~GlyphBatch() override;
+
+  GlyphBatch(const GlyphBatch &) = delete;
+  GlyphBatch & operator=(const GlyphBatch &) = delete;
+
+  /**
+   * @brief Reserve a glyph slot (initially hidden).
+   */
+  int add();
+  void remove(int glyph);
+
+  /**
+   * @brief Place a glyph; length is the nose-to-tail size in metres.
+   * @return true if the glyph moved, resized or changed colour
+   */
+  bool set(
+    int glyph, const Ogre::Vector3 & position, const Ogre::Quaternion & orientation,
+    float length, AttitudeAlarm alarm);
+
+  /**
+   * @return true if the glyph was visible
+   */
+  bool hide(int glyph);
+
+  /**
+   * @brief Rewrite the vertex buffer if any glyph changed.
+   */
+  void flush();
+
+  bool frameStarted(const Ogre::FrameEvent & event) override;
+
+  static Ogre::ColourValue colour(AttitudeAlarm alarm);
+
+private:
+  struct Glyph
+  {
+    bool used{false};
+    bool visible{false};
+    Ogre::Vector3 position{Ogre::Vector3::ZERO};
+    Ogre::Quaternion orientation{Ogre::Quaternion::IDENTITY};
+    float length{1.0f};
+    AttitudeAlarm alarm{AttitudeAlarm::Normal};
+  };
+
+  explicit GlyphBatch(Ogre::SceneManager * scene_manager);
+
+  Ogre::SceneManager * scene_manager_;
+  Ogre::SceneNode * node_;
+  Ogre::ManualObject * object_;
+  Ogre::MaterialPtr material_;
+  std::vector<Glyph> glyphs_;
+  std::vector<int> free_slots_;
+  bool dirty_;
+};
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__GLYPH_BATCH_HPP_
@@ -0,0 +1,219 @@
+/*
+ * RViz Attitude Display Plugin - IMU Orientation Filter (Header-Only)
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__IMU_FILTER_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__IMU_FILTER_HPP_
+
+#include <cmath>
+#include <cstdint>
+
+#include <geometry_msgs/msg/quaternion.hpp>
+#include <sensor_msgs/msg/imu.hpp>
+
+namespace rviz_attitude_plugin
+{
+
+enum class ImuFilterMode
+{
+  Off,            // Show the orientation field as published
+  Madgwick,       // Gradient-descent gravity correction (beta = gain, rad/s)
+  Complementary   // Mahony-style proportional correction (Kp = gain, 1/s)
+};
+
+struct ImuFilterConfig
+{
+  ImuFilterMode mode{ImuFilterMode::Off};
+  double gain{0.1};
+};
+
+/**
+ * @brief Attitude estimate from raw gyro and accelerometer samples.
+ *
+ * Used for sensor_msgs/Imu messages that carry no orientation
+ * (orientation_covariance[0] == -1). Each sample integrates the angular
+ * velocity and pulls the estimate towards the measured gravity direction;
+ * yaw is unobservable without a magnetometer and drifts with the gyro bias.
+ * Updates are O(1) and touch only the filter state, so the filter can run
+ * in the subscription callback at IMU rate.
+ */
+class ImuOrientationFilter
+{
+public:
+  // Gaps longer than this restart the estimate from the accelerometer
+  static constexpr double MAX_STEP_S = 0.5;
+
+  explicit ImuOrientationFilter(const ImuFilterConfig & config = ImuFilterConfig())
+  : config_(config)
+  {
+  }
+
+  /**
+   * @brief True if the message has no orientation of its own.
+   */
+  static bool needsEstimate(const sensor_msgs::msg::Imu & msg)
+  {
+    return msg.orientation_covariance[0] == -1.0;
+  }
+
+  const ImuFilterConfig & config() const { return config_; }
+
+  void reset()
+  {
+    q0_ = 1.0;
+    q1_ = q2_ = q3_ = 0.0;
+    last_stamp_ns_ = 0;
+    initialized_ = false;
+  }
+
+  /**
+   * @brief Advance the estimate by one sample.
+   * @param stamp_ns Sample time; header stamp, or receipt time if unstamped
+   */
+  geometry_msgs::msg::Quaternion update(const sensor_msgs::msg::Imu & msg, int64_t stamp_ns)
+  {
+    const double gx = msg.angular_velocity.x;
+    const double gy = msg.angular_velocity.y;
+    const double gz = msg.angular_velocity.z;
+    double ax = msg.linear_acceleration.x;
+    double ay = msg.linear_acceleration.y;
+    double az = msg.linear_acceleration.z;
+
+    const double dt = initialized_ ? (stamp_ns - last_stamp_ns_) * 1e-9 : 0.0;
+    last_stamp_ns_ = stamp_ns;
+
+    const double a_norm = std::sqrt(ax * ax + ay * ay + az * az);
+    const bool has_gravity = a_norm > 1e-6;
+    if (has_gravity) {
+      ax /= a_norm;
+      ay /= a_norm;
+      az /= a_norm;
+    }
+
+    if (!initialized_ || dt <= 0.0 || dt > MAX_STEP_S) {
+      if (has_gravity) {
+        levelFromGravity(ax, ay, az);
+      }
+      initialized_ = true;
+      return current();
+    }
+
+    if (config_.mode == ImuFilterMode::Complementary) {
+      stepComplementary(gx, gy, gz, ax, ay, az, has_gravity, dt);
+    } else {
+      stepMadgwick(gx, gy, gz, ax, ay, az, has_gravity, dt);
+    }
+    return current();
+  }
+
+private:
+  geometry_msgs::msg::Quaternion current() const
+  {
+    geometry_msgs::msg::Quaternion q;
+    q.w = q0_;
+    q.x = q1_;
+    q.y = q2_;
+    q.z = q3_;
+    return q;
+  }
+
+  // Roll and pitch from gravity alone, zero yaw
+  void levelFromGravity(double ax, double ay, double az)
+  {
+    const double roll = std::atan2(ay, az);
+    const double pitch = std::atan2(-ax, std::sqrt(ay * ay + az * az));
+    const double cr = std::cos(roll * 0.5), sr = std::sin(roll * 0.5);
+    const double cp = std::cos(pitch * 0.5), sp = std::sin(pitch * 0.5);
+    q0_ = cr * cp;
+    q1_ = sr * cp;
+    q2_ = cr * sp;
+    q3_ = -sr * sp;
+  }
+
+  // q += 0.5 * q (x) (0, g) * dt, plus an optional correction rate
+  void integrate(
+    double gx, double gy, double gz, double dt,
+    double s0 = 0.0, double s1 = 0.0, double s2 = 0.0, double s3 = 0.0)
+  {
+    const double d0 = 0.5 * (-q1_ * gx - q2_ * gy - q3_ * gz) - s0;
+    const double d1 = 0.5 * (q0_ * gx + q2_ * gz - q3_ * gy) - s1;
+    const double d2 = 0.5 * (q0_ * gy - q1_ * gz + q3_ * gx) - s2;
+    const double d3 = 0.5 * (q0_ * gz + q1_ * gy - q2_ * gx) - s3;
+    q0_ += d0 * dt;
+    q1_ += d1 * dt;
+    q2_ += d2 * dt;
+    q3_ += d3 * dt;
+    normalize();
+  }
+
+  void normalize()
+  {
+    const double n = std::sqrt(q0_ * q0_ + q1_ * q1_ + q2_ * q2_ + q3_ * q3_);
+    if (n < 1e-12) {
+      reset();
+      return;
+    }
+    q0_ /= n;
+    q1_ /= n;
+    q2_ /= n;
+    q3_ /= n;
+  }
+
+  void stepMadgwick(
+    double gx, double gy, double gz, double ax, double ay, double az,
+    bool has_gravity, double dt)
+  {
+    if (!has_gravity) {
+      integrate(gx, gy, gz, dt);
+      return;
+    }
+
+    // Gradient of the gravity alignment error (Madgwick 2010, IMU form)
+    const double _2q0 = 2.0 * q0_, _2q1 = 2.0 * q1_, _2q2 = 2.0 * q2_, _2q3 = 2.0 * q3_;
+    const double _4q0 = 4.0 * q0_, _4q1 = 4.0 * q1_, _4q2 = 4.0 * q2_;
+    const double _8q1 = 8.0 * q1_, _8q2 = 8.0 * q2_;
+    const double q0q0 = q0_ * q0_, q1q1 = q1_ * q1_, q2q2 = q2_ * q2_, q3q3 = q3_ * q3_;
+
+    double s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+    double s1 = _4q1 * q3q3 - _2q3 * ax + 4.0 * q0q0 * q1_ - _2q0 * ay - _4q1 +
+      _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+    double s2 = 4.0 * q0q0 * q2_ + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 +
+      _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+    double s3 = 4.0 * q1q1 * q3_ - _2q1 * ax + 4.0 * q2q2 * q3_ - _2q2 * ay;
+
+    const double s_norm = std::sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+    if (s_norm > 1e-12) {
+      const double scale = config_.gain / s_norm;
+      s0 *= scale;
+      s1 *= scale;
+      s2 *= scale;
+      s3 *= scale;
+    }
+    integrate(gx, gy, gz, dt, s0, s1, s2, s3);
+  }
+
+  void stepComplementary(
+    double gx, double gy, double gz, double ax, double ay, double az,
+    bool has_gravity, double dt)
+  {
+    if (has_gravity) {
+      // Estimated gravity direction in the body frame, crossed with the measured one
+      const double vx = 2.0 * (q1_ * q3_ - q0_ * q2_);
+      const double vy = 2.0 * (q0_ * q1_ + q2_ * q3_);
+      const double vz = q0_ * q0_ - q1_ * q1_ - q2_ * q2_ + q3_ * q3_;
+      gx += config_.gain * (ay * vz - az * vy);
+      gy += config_.gain * (az * vx - ax * vz);
+      gz += config_.gain * (ax * vy - ay * vx);
+    }
+    integrate(gx, gy, gz, dt);
+  }
+
+  ImuFilterConfig config_;
+  double q0_{1.0}, q1_{0.0}, q2_{0.0}, q3_{0.0};  // w, x, y, z
+  int64_t last_stamp_ns_{0};
+  bool initialized_{false};
+};
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__IMU_FILTER_HPP_
@@ -8,27 +8,39 @@
 #include <Overlay/OgreOverlay.h>
 #include <Overlay/OgreOverlayManager.h>
 #include <Overlay/OgrePanelOverlayElement.h>
+#include <OgreFrameListener.h>
 #include <OgreMaterialManager.h>
 #include <OgrePass.h>
 #include <OgreTechnique.h>
 #include <OgreTextureManager.h>
 
 #include <QImage>
+#include <QPoint>
+#include <QRect>
 #include <QSize>
 
+#include "rviz_attitude_plugin/atlas_packer.hpp"
+#include "rviz_attitude_plugin/attitude_widget.hpp"
+#include "rviz_attitude_plugin/render_pool.hpp"
+#include "rviz_attitude_plugin/tile_hash.hpp"
+
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace rviz_common { class DisplayContext; class RenderPanel; }
+class QPainter;
 class QWidget;
 
 namespace rviz_attitude_plugin
 {
 
-class AttitudeWidget;
-
 class OverlayGeometryManager
 {
 public:
@@ -73,7 +85,8 @@ private:
  * @brief RAII wrapper for Ogre pixel buffer access.
  * 
  * Automatically locks buffer on construction and unlocks on destruction.
- * Provides safe QImage access to the buffer contents.
+ * The lock discards the previous contents; it is meant for filling a
+ * whole write-only buffer.
  */
 class ScopedPixelBuffer
 {
@@ -86,12 +99,208 @@ public:
   ~ScopedPixelBuffer();
 
   bool valid() const;
-  QImage getQImage(unsigned int width, unsigned int height);
+  void clear();
 
 private:
   Ogre::HardwarePixelBufferSharedPtr buffer_;
 };
 
+/**
+ * @brief Origin of a region's pixels, reported when they are uploaded.
+ */
+struct UploadTag
+{
+  const void * display{nullptr};  // display id for the tracepoints
+  int64_t stamp_ns{0};            // stamp of the sample being drawn
+  PerfStats * stats{nullptr};     // receives upload cost and latency, if set
+};
+
+// ============================================================================
+// OverlayAtlas - Process-wide shared overlay texture
+// ============================================================================
+
+/**
+ * @brief Texture atlas shared by every attitude HUD in the process.
+ *
+ * All overlay panels sample sub-regions of one Ogre texture through one
+ * material and one overlay, so many displays cost one texture bind. Panels
+ * submit paint jobs, which run on the RenderPool into CPU-side staging
+ * images while the GUI thread moves on to the next display; the atlas
+ * gathers them and uploads the dirty rectangles once per frame, each
+ * written straight into the write-only texture. Pixels are premultiplied
+ * end to end and blended with (ONE, ONE_MINUS_SRC_ALPHA).
+ *
+ * Uploads are skipped for content that hashes the same as what was last
+ * marked, so re-rendering an unchanged frame costs no upload.
+ *
+ * Regions are packed on shelves by an AtlasPacker and over-allocated in
+ * steps chosen by the caller (coarse for the background capsule, fine
+ * for the other component panels), so resizing a HUD rarely reallocates. Released regions
+ * are reused when large enough; once the shelves run out, the live regions
+ * are re-packed to reclaim the fragmented space.
+ */
+class OverlayAtlas : public Ogre::FrameListener
+{
+public:
+  /**
+   * @brief Get the shared atlas, creating it on first use.
+   *
+   * The atlas is destroyed when the last holder releases it.
+   */
+  static std::shared_ptr<OverlayAtlas> acquire();
+
+  ~OverlayAtlas() override;
+
+  bool valid() const { return overlay_ != nullptr; }
+  Ogre::Overlay * overlay() const { return overlay_; }
+  const std::string & materialName() const { return material_name_; }
+
+  /**
+   * @brief Reserve a region able to hold width x height pixels.
+   * @param bucket Step the region size is rounded up to (see AtlasPacker)
+   * @param panel Panel whose UVs track the region (may be nullptr)
+   * @return Region handle, or -1 if the atlas is full
+   */
+  int allocate(
+    unsigned int width, unsigned int height, unsigned int bucket,
+    Ogre::PanelOverlayElement * panel);
+  void release(int region);
+
+  /**
+   * @brief Number of release() calls so far.
+   *
+   * An allocation that failed can only succeed once this has changed, or
+   * for a smaller size.
+   */
+  uint64_t releases() const { return releases_; }
+
+  QSize capacity(int region) const;
+
+  /**
+   * @brief Set the used part of a region and update its panel UVs.
+   */
+  void setContentSize(int region, unsigned int width, unsigned int height);
+
+  /**
+   * @brief CPU-side pixels of a region (content size, shares memory).
+   */
+  QImage stagingImage(int region);
+
+  /**
+   * @brief Paint a region's content on the RenderPool.
+   *
+   * paint gets a painter on the staging pixels (content size, cleared to
+   * transparent) and may run on any thread, so it must only use what it
+   * holds (see widgets::ComponentFrame). A region still being painted is
+   * gathered first. Without threaded font rendering the job runs here.
+   * @param tag Passed to markDirty() once the job has run
+   */
+  void submit(int region, std::function<void(QPainter &)> paint, const UploadTag & tag);
+
+  /**
+   * @brief Wait for submitted paints and mark their regions dirty.
+   *
+   * Called by flush() and before a region's staging image is replaced. Each
+   * display's PerfStats gets the summed paint time of its regions as one
+   * frame; regions tagged without PerfStats are not counted.
+   */
+  void gather();
+
+  /**
+   * @brief Queue a rectangle (region coordinates) for upload.
+   *
+   * At the next flush the staging pixels are hashed in tiles and only tiles
+   * that differ from the last upload are sent; an identical frame sends
+   * nothing. The tag is reported to the upload_end tracepoint and to its
+   * PerfStats once the rectangle is uploaded.
+   */
+  void markDirty(int region, const QRect & rect, const UploadTag & tag = UploadTag());
+
+  /**
+   * @brief Upload every dirty rectangle.
+   *
+   * Submitted paints are gathered first. Regions marked since the last
+   * flush are then hashed in parallel on the RenderPool, so all displays'
+   * frames land in one batch. Each region's dirty rectangle is then blitted
+   * on its own, without locking (or reading back) the texture.
+   */
+  void flush();
+
+  bool frameStarted(const Ogre::FrameEvent & event) override;
+
+private:
+  struct Region
+  {
+    QRect rect;
+    QSize content;
+    QImage staging;
+    TileHashGrid tiles;
+    QRect pending;    // marked by the panel, not yet hashed
+    QRect dirty;      // changed tiles awaiting upload
+    Ogre::PanelOverlayElement * panel{nullptr};
+    bool in_use{false};
+    bool painting{false};   // submitted, not yet gathered
+    bool uploaded{false};   // written by the current flush
+    size_t upload_bytes{0};
+    int64_t upload_ns{0};   // hashing and writing in the current flush
+    UploadTag tag;          // from the last markDirty()
+  };
+
+  // A submitted paint job; its raster time is written by the job
+  struct Paint
+  {
+    int region;
+    QRect rect;
+    UploadTag tag;
+    int64_t raster_ns;
+  };
+
+  // Upload of one display's regions within a flush
+  struct UploadTotal
+  {
+    PerfStats * stats;
+    size_t bytes;
+    int64_t ns;
+  };
+
+  // Paint time of one display's regions within a gather
+  struct RasterTotal
+  {
+    const void * display;
+    int64_t stamp_ns;
+    PerfStats * stats;
+    int64_t raster_ns;
+  };
+
+  OverlayAtlas();
+
+  /**
+   * @brief Re-pack every live region from scratch, then place width x height.
+   *
+   * Used when AtlasPacker::pack() fails: released regions and emptied
+   * shelves are reclaimed and moved regions are re-uploaded. Handles stay
+   * valid. On failure the layout is left untouched.
+   */
+  bool repack(int width, int height, QRect & rect);
+  void growTexture(unsigned int needed_height);
+  void allocateTexture(unsigned int height);
+  void updateUV(const Region & region) const;
+  static void writeRegion(Ogre::HardwarePixelBuffer & buffer, const Region & region);
+
+  Ogre::Overlay * overlay_;
+  Ogre::MaterialPtr material_;
+  Ogre::TexturePtr texture_;
+  std::string material_name_;
+  std::vector<Region> regions_;
+  AtlasPacker packer_;
+  std::vector<UploadTotal> upload_totals_;   // per flush, reused
+  std::deque<Paint> paints_;                 // submitted since the last gather
+  std::vector<RasterTotal> raster_totals_;   // per gather, reused
+  RenderBatch batch_;
+  bool has_dirty_;
+  uint64_t releases_;
+};
+
 // ============================================================================
 // OverlayPanel - Low-level Ogre overlay panel management
 // ============================================================================
@@ -100,13 +309,18 @@ private:
  * @brief Ogre overlay panel for rendering Qt widgets.
  * 
  * Manages an Ogre overlay panel that can be positioned and sized on screen.
- * Provides Qt-compatible pixel buffer access for custom rendering.
- * Handles Ogre resources (overlay, panel, material, texture).
+ * Its pixels live in a region of the shared OverlayAtlas; submit() paints
+ * them on the RenderPool and has them uploaded.
+ *
+ * A panel created with a parent is positioned relative to it and drawn
+ * above it. The parent must outlive its children. A panel without a region
+ * (none allocated yet, or the atlas was full) draws nothing itself, only
+ * its children.
  */
 class OverlayPanel
 {
 public:
-  explicit OverlayPanel(const std::string & name);
+  explicit OverlayPanel(const std::string & name, OverlayPanel * parent = nullptr);
   ~OverlayPanel();
 
   void show();
@@ -117,18 +331,49 @@ public:
   void setDimensions(unsigned int width, unsigned int height);
   void updateTextureSize(unsigned int width, unsigned int height);
 
-  ScopedPixelBuffer getPixelBuffer();
-  unsigned int textureWidth() const;
-  unsigned int textureHeight() const;
+  /**
+   * @brief Repaint the panel content (see OverlayAtlas::submit()).
+   */
+  void submit(std::function<void(QPainter &)> paint, const UploadTag & tag = UploadTag());
+
+  unsigned int contentWidth() const { return content_width_; }
+  unsigned int contentHeight() const { return content_height_; }
+
+  /**
+   * @brief False while the panel has no atlas region to draw from.
+   */
+  bool hasTexture() const { return region_ >= 0; }
 
 private:
   std::string name_;
-  Ogre::Overlay * overlay_;
+  std::shared_ptr<OverlayAtlas> atlas_;
+  OverlayPanel * parent_;
   Ogre::PanelOverlayElement * panel_;
-  Ogre::MaterialPtr material_;
-  Ogre::TexturePtr texture_;
+  int region_;
+  unsigned int content_width_;
+  unsigned int content_height_;
+
+  // Last failed allocation; not retried until the atlas releases a region
+  bool allocation_failed_;
+  uint64_t failed_releases_;
+  QSize failed_size_;
 };
 
+/**
+ * @brief Renders an AttitudeWidget onto the RViz viewport.
+ *
+ * The widget is split into its HudComponent parts: the background capsule
+ * is the root panel, placed and sized where the capsule sits in the widget,
+ * and every other component is a child panel placed relative to it. No
+ * region covers the whole HUD, so the atlas holds only painted pixels. Only
+ * components reported dirty by the widget (or resized) are re-rastered and
+ * re-uploaded.
+ *
+ * Layout stays on the GUI thread; each dirty component is snapshotted
+ * (AttitudeWidget::componentFrame()) and painted on the RenderPool, so the
+ * components of every display raster in parallel until the atlas gathers
+ * them at the next flush.
+ */
 class OverlayManager
 {
 public:
@@ -144,13 +389,32 @@ public:
                    OverlayGeometryManager::Anchor anchor);
 
   void setVisible(bool visible);
-  void render(AttitudeWidget & widget);
+  /**
+   * @brief Submit dirty components to the atlas to be re-rastered.
+   * @param tag Reported by the raster/upload tracepoints; its PerfStats
+   *        gets the raster cost of frames with new content (the perf strip
+   *        itself is not counted)
+   */
+  void render(AttitudeWidget & widget, const UploadTag & tag = UploadTag());
+
+  /**
+   * @brief True if a shown component got no atlas region at the last render.
+   */
+  bool atlasFull() const { return atlas_full_; }
 
   rviz_common::RenderPanel * getRenderPanel() const { return render_panel_; }
 
 private:
+  static constexpr size_t COMPONENT_COUNT = static_cast<size_t>(HudComponent::Count);
+
   rviz_common::RenderPanel * render_panel_;
+  QSize hud_size_;                // whole widget, from setGeometry()
+  QPoint hud_position_;           // top-left of the widget on the render panel
+  QPoint background_offset_;      // capsule position inside the widget
+  bool atlas_full_;
   std::unique_ptr<OverlayPanel> overlay_panel_;
+  std::array<std::unique_ptr<OverlayPanel>, COMPONENT_COUNT> component_panels_;
+  std::array<QSize, COMPONENT_COUNT> component_sizes_;
 };
 
 }  // namespace rviz_attitude_plugin
@@ -0,0 +1,93 @@
+/*
+ * RViz Attitude Display Plugin - Pipeline Performance Counters
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__PERF_STATS_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__PERF_STATS_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace rviz_attitude_plugin
+{
+
+/**
+ * @brief Pipeline figures over the last reporting window.
+ */
+struct PerfSnapshot
+{
+  static constexpr size_t SPARKLINE_LENGTH = 48;
+
+  double message_hz{0.0};           // messages received per second
+  double render_fps{0.0};           // frames rastered per second
+  double coalescing{0.0};           // messages per rastered frame
+  double latency_p99_ms{0.0};       // message receipt to texture upload
+  double raster_ms{0.0};            // mean raster cost per frame
+  double upload_ms{0.0};            // mean hash + write cost per upload
+  double upload_bytes_per_s{0.0};   // texture bytes written per second
+
+  // Raster + upload cost of the latest frames, oldest first
+  std::array<float, SPARKLINE_LENGTH> frame_cost_ms{};
+  size_t frame_cost_count{0};
+};
+
+/**
+ * @brief Counters fed from the display's instrumentation points.
+ *
+ * The message, raster and upload hooks only bump counters and write into
+ * fixed arrays; percentiles and rates are computed once per snapshot(). All
+ * hooks run on the GUI thread. Times are Profiler::now() nanoseconds.
+ */
+class PerfStats
+{
+public:
+  static constexpr size_t LATENCY_CAPACITY = 512;
+
+  PerfStats();
+
+  void reset();
+
+  void messageReceived(int64_t now_ns);
+
+  /**
+   * @brief A frame with new content was rastered (HUD overhead excluded).
+   */
+  void frameRastered(int64_t duration_ns, int64_t end_ns);
+
+  /**
+   * @brief The atlas uploaded this display's pixels.
+   * @param duration_ns Time spent hashing and writing this display's regions
+   */
+  void frameUploaded(size_t bytes, int64_t duration_ns, int64_t end_ns);
+
+  /**
+   * @brief Close the current window and report it.
+   */
+  const PerfSnapshot & snapshot(int64_t now_ns);
+
+private:
+  int64_t window_begin_ns_;
+  size_t messages_;
+  size_t frames_;
+  size_t uploads_;
+  size_t upload_bytes_;
+  int64_t raster_ns_;
+  int64_t upload_ns_;
+
+  int64_t pending_ingest_ns_;   // first message not yet rastered (0 = none)
+  int64_t rastered_ingest_ns_;  // first message of the frame awaiting upload
+
+  std::array<float, LATENCY_CAPACITY> latencies_ms_;
+  size_t latency_count_;
+
+  std::array<float, PerfSnapshot::SPARKLINE_LENGTH> costs_ms_;  // ring
+  size_t cost_head_;
+  size_t cost_count_;
+
+  PerfSnapshot snapshot_;
+};
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__PERF_STATS_HPP_
@@ -0,0 +1,152 @@
+/*
+ * RViz Attitude Display Plugin - In-Process Scoped-Timer Profiler
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__PROFILER_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__PROFILER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rviz_attitude_plugin
+{
+
+/**
+ * @brief Process-wide profiler writing Chrome trace (Perfetto) JSON.
+ *
+ * Scopes marked with ATTITUDE_PROFILE_SCOPE record a complete event into a
+ * ring owned by the calling thread. Each ring has a single writer, so
+ * recording is a few relaxed stores and one release store; nothing is
+ * locked or allocated after a thread's first event. When profiling is off a
+ * scope costs one relaxed load. dumpChromeTrace() snapshots all rings (the
+ * last RING_CAPACITY events per thread) into a file that chrome://tracing
+ * and ui.perfetto.dev open directly. A thread's ring goes back to a free
+ * list when the thread exits and is handed to the next new thread, so
+ * pool workers that expire and respawn do not add rings; the exited
+ * thread's events stay in the dump until then.
+ */
+class Profiler
+{
+public:
+  static constexpr size_t RING_CAPACITY = 1u << 14;
+
+  static Profiler & instance();
+
+  static bool active()
+  {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Ask for recording in every thread; each call needs a release().
+   *
+   * Recording runs while at least one caller holds it. The first acquire
+   * drops events left from an earlier session.
+   */
+  void acquire();
+
+  /**
+   * @brief Undo one acquire(); recording stops with the last one.
+   */
+  void release();
+
+  /**
+   * @brief Nanoseconds on the profiler's steady clock.
+   */
+  static int64_t now();
+
+  /**
+   * @brief Append a complete event to the calling thread's ring.
+   * @param name String with static storage duration
+   */
+  void record(const char * name, int64_t begin_ns, int64_t end_ns);
+
+  /**
+   * @brief Drop everything recorded so far.
+   */
+  void clear();
+
+  /**
+   * @brief Write the recorded events as Chrome trace JSON.
+   * @param error Set to a description when the file cannot be written
+   * @return Number of events written, or -1 on failure
+   */
+  int dumpChromeTrace(const std::string & path, std::string & error);
+
+private:
+  struct Slot
+  {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<int64_t> begin_ns{0};
+    std::atomic<int64_t> duration_ns{0};
+  };
+
+  struct ThreadRing
+  {
+    uint32_t tid{0};
+    std::string thread_name;
+    std::atomic<uint64_t> head{0};   // events ever written
+    std::atomic<uint64_t> floor{0};  // head at the last clear()
+    std::array<Slot, RING_CAPACITY> slots;
+  };
+
+  Profiler() = default;
+
+  ThreadRing & localRing();
+  void releaseRing(ThreadRing * ring);
+
+  static std::atomic<bool> enabled_;
+
+  std::mutex enable_mutex_;
+  int enable_count_{0};           // outstanding acquire() calls
+
+  std::mutex registry_mutex_;
+  std::vector<std::unique_ptr<ThreadRing>> rings_;  // never shrinks; threads may hold pointers
+  std::vector<ThreadRing *> free_rings_;            // rings of exited threads, for reuse
+  uint32_t next_tid_{0};
+};
+
+/**
+ * @brief Records the lifetime of a scope while profiling is enabled.
+ */
+class ScopedTimer
+{
+public:
+  explicit ScopedTimer(const char * name)
+  : name_(Profiler::active() ? name : nullptr),
+    begin_ns_(name_ ? Profiler::now() : 0)
+  {
+  }
+
+  ~ScopedTimer()
+  {
+    if (name_) {
+      Profiler::instance().record(name_, begin_ns_, Profiler::now());
+    }
+  }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer & operator=(const ScopedTimer &) = delete;
+
+private:
+  const char * name_;
+  int64_t begin_ns_;
+};
+
+}  // namespace rviz_attitude_plugin
+
+#define ATTITUDE_PROFILE_CONCAT_INNER(a, b) a ## b
+#define ATTITUDE_PROFILE_CONCAT(a, b) ATTITUDE_PROFILE_CONCAT_INNER(a, b)
+
+/**
+ * ATTITUDE_PROFILE_SCOPE("Name") times the rest of the enclosing scope.
+ */
+#define ATTITUDE_PROFILE_SCOPE(name) \
+  ::rviz_attitude_plugin::ScopedTimer ATTITUDE_PROFILE_CONCAT(attitude_profile_scope_, __LINE__)(name)
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__PROFILER_HPP_
@@ -0,0 +1,62 @@
+/*
+ * RViz Attitude Display Plugin - Smallest-Three Quaternion Codec
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__QUATERNION_CODEC_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__QUATERNION_CODEC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rviz_attitude_plugin
+{
+
+/**
+ * @brief Unit quaternions in 48 bits ("smallest three").
+ *
+ * The largest-magnitude component is dropped (its sign is made positive,
+ * since q and -q are the same rotation) and rebuilt from the unit norm.
+ * The other three lie in [-1/sqrt(2), 1/sqrt(2)] and are quantized to 15
+ * bits each; the 2-bit index of the dropped component rides in the top bits
+ * of the first two words.
+ *
+ * Words are kept as three separate arrays so decoding runs four quaternions
+ * per SSE2 step. Each kept component is off by at most STEP / 2 (2.2e-5);
+ * the rebuilt one by at most 3x that, which bounds the rotation error by
+ * MAX_ANGLE_ERROR_RAD (about 0.009 deg), an order of magnitude below the
+ * 0.1 deg / 0.001 rad readout resolution.
+ */
+namespace quaternion_codec
+{
+
+static constexpr int FIELD_BITS = 15;
+static constexpr uint16_t FIELD_MAX = (1u << FIELD_BITS) - 1u;
+static constexpr float RANGE = 0.70710678f;  // 1/sqrt(2)
+static constexpr float STEP = 2.0f * RANGE / FIELD_MAX;
+static constexpr double MAX_ANGLE_ERROR_RAD = 1.5e-4;
+
+/**
+ * @brief Encode a quaternion (normalized here; zero maps to identity).
+ */
+void encode(double x, double y, double z, double w, uint16_t & a, uint16_t & b, uint16_t & c);
+
+/**
+ * @brief Decode one quaternion.
+ */
+void decode(uint16_t a, uint16_t b, uint16_t c, float & x, float & y, float & z, float & w);
+
+/**
+ * @brief Decode count quaternions into separate component arrays.
+ *
+ * Vectorized with SSE2 where available; the scalar path evaluates the same
+ * float expressions and handles the remainder.
+ */
+void decode(
+  const uint16_t * a, const uint16_t * b, const uint16_t * c, size_t count,
+  float * x, float * y, float * z, float * w);
+
+}  // namespace quaternion_codec
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__QUATERNION_CODEC_HPP_
@@ -0,0 +1,76 @@
+/*
+ * RViz Attitude Display Plugin - Shared Render Worker Pool
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__RENDER_POOL_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__RENDER_POOL_HPP_
+
+#include <QThreadPool>
+
+#include <functional>
+#include <memory>
+
+namespace rviz_attitude_plugin
+{
+
+/**
+ * @brief Process-wide worker pool for HUD pixel work.
+ *
+ * One pool, sized to the available cores, is shared by every attitude
+ * display. Only pure image work runs on it: HUD components painted into
+ * QImages from state snapshots (see widgets::ComponentFrame), rasterizing
+ * and hashing. Nothing on the pool touches a QWidget.
+ */
+class RenderPool
+{
+public:
+  static QThreadPool & instance();
+
+  /**
+   * @brief Run job(0) .. job(count - 1) across the pool and wait.
+   *
+   * The calling thread takes jobs as well, and only idle workers join in,
+   * so a busy or single-core pool degrades to a plain loop. The call
+   * returns once every job has run; it never waits on queued work, which
+   * also makes nesting on a pool thread safe. Jobs must not touch shared
+   * state.
+   */
+  static void parallelFor(int count, const std::function<void(int)> & job);
+
+  /**
+   * @brief Run job on the pool without waiting for it.
+   *
+   * The job must keep alive whatever it touches (e.g. by owning a
+   * shared_ptr), since its submitter may be gone when it runs.
+   */
+  static void post(std::function<void()> job);
+};
+
+/**
+ * @brief Jobs started on the RenderPool together and waited for together.
+ *
+ * add() queues a job and returns at once, so the caller can go on
+ * preparing the next one while workers run. wait() runs every job no
+ * worker has picked up yet on the calling thread, then waits for the ones
+ * already running; like parallelFor() it never blocks on queued work. The
+ * destructor waits as well.
+ */
+class RenderBatch
+{
+public:
+  RenderBatch();
+  ~RenderBatch();
+  RenderBatch(const RenderBatch &) = delete;
+  RenderBatch & operator=(const RenderBatch &) = delete;
+
+  void add(std::function<void()> job);
+  void wait();
+
+private:
+  struct State;
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__RENDER_POOL_HPP_
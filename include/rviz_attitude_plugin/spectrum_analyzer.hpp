@@ -0,0 +1,115 @@
+/*
+ * RViz Attitude Display Plugin - Roll/Pitch Rate Spectrum Analyzer
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__SPECTRUM_ANALYZER_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__SPECTRUM_ANALYZER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace rviz_attitude_plugin
+{
+
+static constexpr size_t SPECTRUM_WINDOW = 256;                  // samples per FFT
+static constexpr size_t SPECTRUM_BINS = SPECTRUM_WINDOW / 2 + 1;
+static constexpr size_t SPECTRUM_PEAKS = 3;
+
+struct SpectrumPeak
+{
+  float frequency_hz{0.0f};
+  float power_db{0.0f};
+};
+
+/**
+ * @brief One-sided PSD of the roll and pitch rates, with dominant peaks.
+ */
+struct SpectrumResult
+{
+  bool valid{false};
+  double sample_rate_hz{0.0};
+  std::array<float, SPECTRUM_BINS> roll_db{};    // 10 log10((rad/s)^2/Hz)
+  std::array<float, SPECTRUM_BINS> pitch_db{};
+  std::array<SpectrumPeak, SPECTRUM_PEAKS> roll_peaks{};   // strongest first
+  std::array<SpectrumPeak, SPECTRUM_PEAKS> pitch_peaks{};
+  size_t roll_peak_count{0};
+  size_t pitch_peak_count{0};
+};
+
+/**
+ * @brief Sliding-window PSD of roll and pitch rates.
+ *
+ * Samples go into a fixed ring (O(1) per sample, no allocation). Every HOP
+ * samples the full window is copied into a small segment queue, so
+ * consecutive segments overlap by 75% whatever the sample rate. At most
+ * every MIN_INTERVAL_NS the queued segments are transformed on the
+ * RenderPool: mean removed, Hann-windowed, both channels packed into one
+ * complex radix-2 FFT. The published PSD is the plain mean of the newest
+ * periodograms (Welch). Each segment's sample rate is taken from its
+ * timestamps. Peaks are local maxima at least 6 dB above the mean level,
+ * refined by a parabolic fit.
+ *
+ * push(), poll() and takeResult() are called from the GUI thread; the
+ * worker only touches state shared through a reference-counted block, so a
+ * job in flight outlives the analyzer safely.
+ */
+class SpectrumAnalyzer
+{
+public:
+  static constexpr size_t HOP = SPECTRUM_WINDOW / 4;     // samples between segments
+  static constexpr int64_t MIN_INTERVAL_NS = 250000000;  // publish at most 4 Hz
+
+  SpectrumAnalyzer();
+  ~SpectrumAnalyzer();
+
+  SpectrumAnalyzer(const SpectrumAnalyzer &) = delete;
+  SpectrumAnalyzer & operator=(const SpectrumAnalyzer &) = delete;
+
+  void reset();
+
+  /**
+   * @brief Add measured body rates (rad/s).
+   */
+  void push(int64_t time_ns, double roll_rate, double pitch_rate);
+
+  /**
+   * @brief Add roll/pitch angles (rad); rates are obtained by differencing.
+   */
+  void pushAngles(int64_t time_ns, double roll, double pitch);
+
+  /**
+   * @brief Transform the queued segments on the RenderPool if a result is due.
+   */
+  void poll(int64_t now_ns);
+
+  /**
+   * @brief Copy the newest finished result.
+   * @return false if nothing finished since the last call
+   */
+  bool takeResult(SpectrumResult & result);
+
+private:
+  struct Shared;
+  std::shared_ptr<Shared> shared_;
+
+  std::array<float, SPECTRUM_WINDOW> roll_;
+  std::array<float, SPECTRUM_WINDOW> pitch_;
+  std::array<int64_t, SPECTRUM_WINDOW> time_ns_;
+  size_t head_;
+  size_t count_;
+  size_t since_segment_;   // samples since the last segment was queued
+  size_t queued_;          // segments queued since the last job
+  int64_t last_job_ns_;
+
+  // Differencing state
+  bool has_previous_angles_;
+  int64_t previous_time_ns_;
+  double previous_roll_;
+  double previous_pitch_;
+};
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__SPECTRUM_ANALYZER_HPP_
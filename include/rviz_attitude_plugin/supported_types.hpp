@@ -1,14 +1,20 @@
 /*
- * Supported message types and helpers for extracting orientation quaternions.
+ * Supported message types and helpers for extracting attitude samples.
  */
 #ifndef RVIZ_ATTITUDE_PLUGIN__SUPPORTED_TYPES_HPP_
 #define RVIZ_ATTITUDE_PLUGIN__SUPPORTED_TYPES_HPP_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include <geometry_msgs/msg/point.hpp>
 #include <geometry_msgs/msg/quaternion.hpp>
+#include <geometry_msgs/msg/vector3.hpp>
 #include <geometry_msgs/msg/quaternion_stamped.hpp>
 #include <geometry_msgs/msg/pose.hpp>
 #include <geometry_msgs/msg/pose_stamped.hpp>
@@ -65,37 +71,200 @@ struct SupportedTypes
   }
 };
 
-inline geometry_msgs::msg::Quaternion extract(const geometry_msgs::msg::Quaternion & msg)
+/**
+ * @brief Everything the display uses from one message, filled in one pass.
+ *
+ * Each subscription callback deserializes the message once and extract()
+ * copies the orientation plus whatever else the type carries: body rates,
+ * body velocity, position (altitude is position.z) and which covariances
+ * are known. Elements such as rate of turn, speed and altitude read the
+ * same sample, so they cost no second subscription.
+ *
+ * frame_id views the message's header and is only valid during the
+ * callback; frame_hash lets receivers copy it only when the frame changes.
+ */
+struct AttitudeSample
+{
+  // flags
+  static constexpr uint16_t HAS_RATES = 1u << 0;              // angular_velocity is set
+  static constexpr uint16_t HAS_VELOCITY = 1u << 1;           // linear_velocity is set
+  static constexpr uint16_t HAS_POSITION = 1u << 2;           // position is set
+  static constexpr uint16_t ORIENTATION_ESTIMATED = 1u << 3;  // from the IMU filter, not the message
+  static constexpr uint16_t ORIENTATION_COVARIANCE = 1u << 4;  // covariance known (not 0/-1)
+  static constexpr uint16_t RATES_COVARIANCE = 1u << 5;
+  static constexpr uint16_t VELOCITY_COVARIANCE = 1u << 6;
+  static constexpr uint16_t POSITION_COVARIANCE = 1u << 7;
+
+  int64_t stamp_ns{0};                           // header stamp; 0 without a header
+  uint64_t frame_hash{0};                        // hashFrameId(frame_id); 0 without a frame
+  std::string_view frame_id;
+  uint16_t flags{0};
+  geometry_msgs::msg::Quaternion orientation;
+  geometry_msgs::msg::Vector3 angular_velocity;  // body rates (rad/s)
+  geometry_msgs::msg::Vector3 linear_velocity;   // body frame (m/s)
+  geometry_msgs::msg::Point position;            // in frame_id
+
+  bool has(uint16_t flag) const { return (flags & flag) != 0; }
+};
+
+/**
+ * @brief FNV-1a hash of a frame id; the empty frame hashes to 0.
+ */
+inline uint64_t hashFrameId(std::string_view frame_id)
+{
+  if (frame_id.empty()) {
+    return 0;
+  }
+  uint64_t hash = 14695981039346656037ull;
+  for (const char c : frame_id) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+/**
+ * @brief Header stamp in nanoseconds, or 0 for message types without a header.
+ */
+template<typename MessageT>
+inline int64_t stampNanoseconds(const MessageT & msg)
+{
+  if constexpr (std::is_same_v<MessageT, geometry_msgs::msg::Quaternion> ||
+    std::is_same_v<MessageT, geometry_msgs::msg::Pose> ||
+    std::is_same_v<MessageT, geometry_msgs::msg::PoseWithCovariance>)
+  {
+    (void)msg;
+    return 0;
+  } else {
+    return static_cast<int64_t>(msg.header.stamp.sec) * 1000000000LL + msg.header.stamp.nanosec;
+  }
+}
+
+namespace detail
+{
+
+template<typename HeaderT>
+inline void extractHeader(const HeaderT & header, AttitudeSample & sample)
+{
+  sample.stamp_ns = static_cast<int64_t>(header.stamp.sec) * 1000000000LL + header.stamp.nanosec;
+  sample.frame_id = header.frame_id;
+  sample.frame_hash = hashFrameId(sample.frame_id);
+}
+
+/**
+ * @brief ROS marks a covariance unknown with all zeros, and absent with -1.
+ */
+template<size_t N>
+inline bool covarianceKnown(const std::array<double, N> & covariance)
+{
+  if (covariance[0] == -1.0) {
+    return false;
+  }
+  for (const double value : covariance) {
+    if (value != 0.0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Whether a 6x6 pose/twist covariance has a positive variance on
+ * the three axes starting at first_axis (0 = linear, 3 = angular).
+ */
+inline bool varianceKnown(const std::array<double, 36> & covariance, size_t first_axis)
+{
+  for (size_t axis = first_axis; axis < first_axis + 3; ++axis) {
+    if (covariance[axis * 7] > 0.0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void extractPoseWithCovariance(
+  const geometry_msgs::msg::PoseWithCovariance & msg, AttitudeSample & sample)
+{
+  sample.orientation = msg.pose.orientation;
+  sample.position = msg.pose.position;
+  sample.flags |= AttitudeSample::HAS_POSITION;
+  if (varianceKnown(msg.covariance, 0)) {
+    sample.flags |= AttitudeSample::POSITION_COVARIANCE;
+  }
+  if (varianceKnown(msg.covariance, 3)) {
+    sample.flags |= AttitudeSample::ORIENTATION_COVARIANCE;
+  }
+}
+
+}  // namespace detail
+
+inline void extract(const geometry_msgs::msg::Quaternion & msg, AttitudeSample & sample)
 {
-  return msg;
+  sample.orientation = msg;
 }
-inline geometry_msgs::msg::Quaternion extract(const geometry_msgs::msg::QuaternionStamped & msg)
+
+inline void extract(const geometry_msgs::msg::QuaternionStamped & msg, AttitudeSample & sample)
 {
-  return msg.quaternion;
+  detail::extractHeader(msg.header, sample);
+  sample.orientation = msg.quaternion;
 }
-inline geometry_msgs::msg::Quaternion extract(const geometry_msgs::msg::Pose & msg)
+
+inline void extract(const geometry_msgs::msg::Pose & msg, AttitudeSample & sample)
 {
-  return msg.orientation;
+  sample.orientation = msg.orientation;
+  sample.position = msg.position;
+  sample.flags |= AttitudeSample::HAS_POSITION;
 }
-inline geometry_msgs::msg::Quaternion extract(const geometry_msgs::msg::PoseStamped & msg)
+
+inline void extract(const geometry_msgs::msg::PoseStamped & msg, AttitudeSample & sample)
 {
-  return msg.pose.orientation;
+  detail::extractHeader(msg.header, sample);
+  extract(msg.pose, sample);
 }
-inline geometry_msgs::msg::Quaternion extract(const geometry_msgs::msg::PoseWithCovariance & msg)
+
+inline void extract(const geometry_msgs::msg::PoseWithCovariance & msg, AttitudeSample & sample)
 {
-  return msg.pose.orientation;
+  detail::extractPoseWithCovariance(msg, sample);
 }
-inline geometry_msgs::msg::Quaternion extract(const geometry_msgs::msg::PoseWithCovarianceStamped & msg)
+
+inline void extract(
+  const geometry_msgs::msg::PoseWithCovarianceStamped & msg, AttitudeSample & sample)
 {
-  return msg.pose.pose.orientation;
+  detail::extractHeader(msg.header, sample);
+  detail::extractPoseWithCovariance(msg.pose, sample);
 }
-inline geometry_msgs::msg::Quaternion extract(const sensor_msgs::msg::Imu & msg)
+
+inline void extract(const sensor_msgs::msg::Imu & msg, AttitudeSample & sample)
 {
-  return msg.orientation;
+  detail::extractHeader(msg.header, sample);
+  sample.orientation = msg.orientation;
+  // angular_velocity_covariance[0] == -1 marks the rates as not provided
+  if (msg.angular_velocity_covariance[0] != -1.0) {
+    sample.angular_velocity = msg.angular_velocity;
+    sample.flags |= AttitudeSample::HAS_RATES;
+  }
+  if (detail::covarianceKnown(msg.orientation_covariance)) {
+    sample.flags |= AttitudeSample::ORIENTATION_COVARIANCE;
+  }
+  if (detail::covarianceKnown(msg.angular_velocity_covariance)) {
+    sample.flags |= AttitudeSample::RATES_COVARIANCE;
+  }
 }
-inline geometry_msgs::msg::Quaternion extract(const nav_msgs::msg::Odometry & msg)
+
+inline void extract(const nav_msgs::msg::Odometry & msg, AttitudeSample & sample)
 {
-  return msg.pose.pose.orientation;
+  detail::extractHeader(msg.header, sample);
+  detail::extractPoseWithCovariance(msg.pose, sample);
+
+  // The twist is in child_frame_id, the body frame
+  sample.angular_velocity = msg.twist.twist.angular;
+  sample.linear_velocity = msg.twist.twist.linear;
+  sample.flags |= AttitudeSample::HAS_RATES | AttitudeSample::HAS_VELOCITY;
+  if (detail::varianceKnown(msg.twist.covariance, 0)) {
+    sample.flags |= AttitudeSample::VELOCITY_COVARIANCE;
+  }
+  if (detail::varianceKnown(msg.twist.covariance, 3)) {
+    sample.flags |= AttitudeSample::RATES_COVARIANCE;
+  }
 }
 
 }  // namespace rviz_attitude_plugin
@@ -0,0 +1,189 @@
+/*
+ * RViz Attitude Display Plugin - Tile Content Hashing (Header-Only)
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__TILE_HASH_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__TILE_HASH_HPP_
+
+#include <QImage>
+#include <QRect>
+#include <QSize>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace rviz_attitude_plugin
+{
+
+namespace tile_hash_detail
+{
+
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint32_t PRIME32_1 = 0x9E3779B1U;
+constexpr uint64_t KEY_0 = 0xBE4BA423396CFEB8ULL;
+constexpr uint64_t KEY_1 = 0x1CAD21F72C81017CULL;
+
+inline uint64_t read64(const unsigned char * p)
+{
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint64_t rotl64(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t avalanche(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * @brief Hash a rectangle of 32-bit pixels.
+ *
+ * Rows are consumed in 16 byte stripes by two 64-bit accumulator lanes
+ * (multiply of the 32-bit halves plus the swapped input, as in XXH3), so the
+ * SSE2 path handles a stripe per instruction group and the scalar path keeps
+ * two independent dependency chains. Lanes are scrambled after every row and
+ * folded at the end.
+ */
+inline uint64_t hashPixels(
+  const unsigned char * first_row, size_t bytes_per_line, int width, int height)
+{
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  const size_t stripe_bytes = row_bytes & ~static_cast<size_t>(15);
+  alignas(16) uint64_t acc[2] = {PRIME64_1, PRIME64_2};
+
+  for (int y = 0; y < height; ++y) {
+    const unsigned char * row = first_row + static_cast<size_t>(y) * bytes_per_line;
+
+#if defined(__SSE2__)
+    __m128i acc_vec = _mm_load_si128(reinterpret_cast<const __m128i *>(acc));
+    const __m128i key_vec = _mm_set_epi64x(
+      static_cast<long long>(KEY_1), static_cast<long long>(KEY_0));
+    for (size_t i = 0; i < stripe_bytes; i += 16) {
+      const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+      const __m128i data_key = _mm_xor_si128(data, key_vec);
+      const __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+      const __m128i product = _mm_mul_epu32(data_key, data_key_hi);
+      const __m128i data_swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      acc_vec = _mm_add_epi64(product, _mm_add_epi64(acc_vec, data_swap));
+    }
+    _mm_store_si128(reinterpret_cast<__m128i *>(acc), acc_vec);
+#else
+    for (size_t i = 0; i < stripe_bytes; i += 16) {
+      const uint64_t data0 = read64(row + i);
+      const uint64_t data1 = read64(row + i + 8);
+      const uint64_t key0 = data0 ^ KEY_0;
+      const uint64_t key1 = data1 ^ KEY_1;
+      acc[0] += data1 + (key0 & 0xFFFFFFFFULL) * (key0 >> 32);
+      acc[1] += data0 + (key1 & 0xFFFFFFFFULL) * (key1 >> 32);
+    }
+#endif
+
+    // Up to three trailing pixels
+    for (size_t i = stripe_bytes; i < row_bytes; i += 4) {
+      uint32_t pixel;
+      std::memcpy(&pixel, row + i, sizeof(pixel));
+      acc[0] = rotl64(acc[0] ^ (pixel * static_cast<uint64_t>(PRIME32_1)), 27) * PRIME64_1;
+    }
+
+    for (auto & lane : acc) {
+      lane ^= lane >> 47;
+      lane *= PRIME32_1;
+    }
+  }
+
+  return avalanche(acc[0] + rotl64(acc[1], 31) + row_bytes * static_cast<uint64_t>(height));
+}
+
+}  // namespace tile_hash_detail
+
+/**
+ * @brief Per-tile content hashes of an image, for change detection.
+ *
+ * update() rehashes the tiles touching a rectangle and reports the bounding
+ * box of the tiles whose pixels differ from the previous call, so an
+ * unchanged re-render produces no upload at all.
+ */
+class TileHashGrid
+{
+public:
+  static constexpr int TILE_PX = 32;
+
+  /**
+   * @brief Size the grid for an image and forget all previous hashes.
+   */
+  void reset(const QSize & size)
+  {
+    size_ = size;
+    columns_ = (size.width() + TILE_PX - 1) / TILE_PX;
+    rows_ = (size.height() + TILE_PX - 1) / TILE_PX;
+    hashes_.assign(static_cast<size_t>(columns_) * rows_, 0);
+    known_.assign(hashes_.size(), false);
+  }
+
+  /**
+   * @brief Rehash the tiles covering rect.
+   * @param image 32-bit image of the size given to reset()
+   * @param rect Area that may have changed, in image coordinates
+   * @return Bounding box of the changed tiles (clipped to rect), or empty
+   */
+  QRect update(const QImage & image, const QRect & rect)
+  {
+    const QRect area = rect.intersected(QRect(QPoint(0, 0), size_));
+    if (area.isEmpty() || image.isNull() || image.depth() != 32) {
+      return area;
+    }
+
+    QRect changed;
+    const int first_column = area.left() / TILE_PX;
+    const int last_column = area.right() / TILE_PX;
+    const int first_row = area.top() / TILE_PX;
+    const int last_row = area.bottom() / TILE_PX;
+
+    for (int ty = first_row; ty <= last_row; ++ty) {
+      for (int tx = first_column; tx <= last_column; ++tx) {
+        const QRect tile =
+          QRect(tx * TILE_PX, ty * TILE_PX, TILE_PX, TILE_PX).intersected(area);
+        const uint64_t hash = tile_hash_detail::hashPixels(
+          image.constScanLine(tile.top()) + tile.left() * 4,
+          static_cast<size_t>(image.bytesPerLine()),
+          tile.width(),
+          tile.height());
+
+        const size_t index = static_cast<size_t>(ty) * columns_ + tx;
+        if (!known_[index] || hashes_[index] != hash) {
+          hashes_[index] = hash;
+          known_[index] = true;
+          changed |= tile;
+        }
+      }
+    }
+    return changed;
+  }
+
+private:
+  QSize size_;
+  int columns_{0};
+  int rows_{0};
+  std::vector<uint64_t> hashes_;
+  std::vector<bool> known_;
+};
+
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__TILE_HASH_HPP_
@@ -5,9 +5,13 @@
 #ifndef RVIZ_ATTITUDE_PLUGIN__TOPIC_UTILITIES_HPP_
 #define RVIZ_ATTITUDE_PLUGIN__TOPIC_UTILITIES_HPP_
 
+#include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
+#include <regex>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,42 +27,235 @@
 #include <sensor_msgs/msg/imu.hpp>
 #include <nav_msgs/msg/odometry.hpp>
 
+#include "rviz_attitude_plugin/imu_filter.hpp"
 #include "rviz_attitude_plugin/supported_types.hpp"
+#include "rviz_attitude_plugin/tracing.hpp"
 
 namespace rviz_attitude_plugin
 {
 
+/**
+ * @brief Finds topics of supported types, scoped and cached across refreshes.
+ *
+ * Only topics under the namespace scope are visited: the graph map is sorted,
+ * so the scope is a single lower_bound range. Each visited topic is kept in
+ * a cache with its type list, supported type and filter verdict, so a refresh
+ * re-examines only topics that appeared or changed type. A type -> topics
+ * index backs the type filter. When the ROS graph has not changed since the
+ * last refresh and the scope is unchanged, the previous list is returned
+ * without querying the graph.
+ */
 class TopicDiscovery
 {
 public:
-  inline std::vector<std::pair<std::string, std::string>> list(rclcpp::Node * node) const
+  using TopicList = std::vector<std::pair<std::string, std::string>>;
+
+  /**
+   * @brief Restrict discovery to a namespace and a name pattern.
+   * @param ns Namespace prefix ("" or "/" for all), e.g. "/robot1"
+   * @param pattern ECMAScript regex searched in the topic name ("" for all)
+   * @return false if the pattern is not a valid regex (it is then ignored)
+   */
+  inline bool setScope(const std::string & ns, const std::string & pattern)
+  {
+    std::string prefix = ns;
+    if (!prefix.empty() && prefix.front() != '/') prefix.insert(prefix.begin(), '/');
+    if (!prefix.empty() && prefix.back() != '/') prefix.push_back('/');
+    if (prefix == "/") prefix.clear();
+
+    bool valid = true;
+    std::optional<std::regex> regex;
+    if (!pattern.empty()) {
+      try {
+        regex.emplace(pattern, std::regex::ECMAScript | std::regex::optimize);
+      } catch (const std::regex_error &) {
+        valid = false;
+      }
+    }
+
+    if (prefix != prefix_ || pattern != pattern_) {
+      prefix_ = prefix;
+      pattern_ = pattern;
+      regex_ = std::move(regex);
+      invalidate();
+    }
+    return valid;
+  }
+
+  /**
+   * @brief Only list topics whose supported type is `type` ("" for any).
+   */
+  inline void setTypeFilter(const std::string & type)
+  {
+    if (type != type_filter_) {
+      type_filter_ = type;
+      stale_ = true;
+    }
+  }
+
+  inline const TopicList & list(rclcpp::Node * node)
+  {
+    if (!node) {
+      invalidate();
+      result_.clear();
+      return result_;
+    }
+
+    // A graph event subscription tells whether anything changed since last time
+    if (node != node_) {
+      node_ = node;
+      graph_event_ = node->get_graph_event();
+      invalidate();
+    }
+    const bool graph_changed = !graph_event_ || graph_event_->check_and_clear();
+    if (!graph_changed && !stale_) {
+      return result_;
+    }
+
+    if (graph_changed) {
+      sync(node->get_topic_names_and_types());
+    }
+    rebuildResult();
+    stale_ = false;
+    return result_;
+  }
+
+  /**
+   * @brief Supported type of a topic from the last refresh, or "".
+   */
+  inline std::string cachedType(const std::string & topic) const
+  {
+    auto it = entries_.find(topic);
+    return (it != entries_.end() && it->second.matched) ? it->second.chosen : std::string();
+  }
+
+private:
+  struct Entry
+  {
+    std::vector<std::string> types;
+    std::string chosen;    // first supported type, "" if none
+    bool matched{false};   // passes the name pattern
+  };
+
+  inline bool inNamespace(const std::string & name) const
+  {
+    return name.compare(0, prefix_.size(), prefix_) == 0;
+  }
+
+  inline void invalidate()
+  {
+    entries_.clear();
+    by_type_.clear();
+    if (graph_event_) graph_event_->set();  // force a graph query on next list()
+    stale_ = true;
+  }
+
+  inline void index(const std::string & name, const Entry & entry)
+  {
+    if (entry.matched && !entry.chosen.empty()) by_type_[entry.chosen].insert(name);
+  }
+
+  inline void unindex(const std::string & name, const Entry & entry)
+  {
+    if (entry.matched && !entry.chosen.empty()) {
+      auto it = by_type_.find(entry.chosen);
+      if (it != by_type_.end()) {
+        it->second.erase(name);
+        if (it->second.empty()) by_type_.erase(it);
+      }
+    }
+  }
+
+  /**
+   * @brief Merge the in-scope part of the graph into the cache.
+   */
+  inline void sync(const std::map<std::string, std::vector<std::string>> & graph)
   {
-    std::vector<std::pair<std::string, std::string>> result;
-    if (!node) return result;
+    auto cached = entries_.begin();
+    for (auto it = graph.lower_bound(prefix_); it != graph.end() && inNamespace(it->first); ++it) {
+      const std::string & name = it->first;
+
+      // Cached topics sorting before this one have left the graph
+      while (cached != entries_.end() && cached->first < name) {
+        unindex(cached->first, cached->second);
+        cached = entries_.erase(cached);
+      }
 
-    std::map<std::string, std::vector<std::string>> topics = node->get_topic_names_and_types();
+      if (cached != entries_.end() && cached->first == name) {
+        if (cached->second.types != it->second) {
+          unindex(name, cached->second);
+          cached->second.types = it->second;
+          cached->second.chosen = SupportedTypes::firstSupported(it->second);
+          index(name, cached->second);
+        }
+        ++cached;
+        continue;
+      }
 
-    for (const auto & kv : topics) {
-      const auto & name = kv.first;
-      const auto & types = kv.second;
-      const std::string chosen = SupportedTypes::firstSupported(types);
-      if (!chosen.empty()) {
-        result.emplace_back(name, chosen);
+      Entry entry;
+      entry.types = it->second;
+      entry.chosen = SupportedTypes::firstSupported(it->second);
+      entry.matched = !regex_ || std::regex_search(name, *regex_);
+      index(name, entry);
+      entries_.emplace_hint(cached, name, std::move(entry));
+    }
+
+    while (cached != entries_.end()) {
+      unindex(cached->first, cached->second);
+      cached = entries_.erase(cached);
+    }
+  }
+
+  inline void rebuildResult()
+  {
+    result_.clear();
+    if (!type_filter_.empty()) {
+      auto it = by_type_.find(type_filter_);
+      if (it != by_type_.end()) {
+        for (const auto & name : it->second) result_.emplace_back(name, type_filter_);
       }
+      return;
+    }
+    for (const auto & [name, entry] : entries_) {
+      if (entry.matched && !entry.chosen.empty()) result_.emplace_back(name, entry.chosen);
     }
-    return result;
   }
+
+  std::string prefix_;
+  std::string pattern_;
+  std::optional<std::regex> regex_;
+  std::string type_filter_;
+
+  rclcpp::Node * node_{nullptr};
+  rclcpp::Event::SharedPtr graph_event_;
+  bool stale_{true};
+
+  std::map<std::string, Entry> entries_;                  // in-namespace topics
+  std::map<std::string, std::set<std::string>> by_type_;  // supported type -> topics
+  TopicList result_;
 };
 
 class AttitudeSubscriber
 {
 public:
-  using OrientationCallback = std::function<void(const geometry_msgs::msg::Quaternion &)>;
+  using OrientationCallback = std::function<void(const AttitudeSample &)>;
 
+  /**
+   * @brief Subscribe to a topic of a supported type.
+   * @param intra_process Take messages from publishers in this process by
+   *        shared pointer, skipping serialization. Both QoS profiles used
+   *        here (keep-last, volatile) are intra-process compatible. Loaned
+   *        messages are taken automatically when the middleware offers them.
+   * @param trace_id Display id carried by the tracepoints (see tracing.hpp)
+   * @param imu_filter Estimator for Imu messages without an orientation
+   */
   inline void start(rclcpp::Node * node,
                     const std::string & topic,
                     const std::string & type,
-                    const OrientationCallback & on_orientation)
+                    const OrientationCallback & on_orientation,
+                    bool intra_process = false,
+                    const void * trace_id = nullptr,
+                    const ImuFilterConfig & imu_filter = ImuFilterConfig())
   {
     stop();
     if (!node) return;
@@ -67,40 +264,44 @@ public:
     auto qos_default = rclcpp::QoS(10);
     auto qos_imu = rclcpp::SensorDataQoS();
 
-    using rviz_attitude_plugin::extract;
+    rclcpp::SubscriptionOptions options;
+    options.use_intra_process_comm = intra_process
+      ? rclcpp::IntraProcessSetting::Enable
+      : rclcpp::IntraProcessSetting::NodeDefault;
 
     if (type == SupportedTypes::Quaternion) {
       sub_ = node->create_subscription<geometry_msgs::msg::Quaternion>(
         topic, qos_default,
-        [on_orientation](geometry_msgs::msg::Quaternion::ConstSharedPtr m){ on_orientation(*m); });
+        [on_orientation, trace_id](geometry_msgs::msg::Quaternion::ConstSharedPtr m){ deliver(*m, trace_id, on_orientation); }, options);
     } else if (type == SupportedTypes::QuaternionStamped) {
       sub_ = node->create_subscription<geometry_msgs::msg::QuaternionStamped>(
         topic, qos_default,
-        [on_orientation](geometry_msgs::msg::QuaternionStamped::ConstSharedPtr m){ on_orientation(extract(*m)); });
+        [on_orientation, trace_id](geometry_msgs::msg::QuaternionStamped::ConstSharedPtr m){ deliver(*m, trace_id, on_orientation); }, options);
     } else if (type == SupportedTypes::Pose) {
       sub_ = node->create_subscription<geometry_msgs::msg::Pose>(
         topic, qos_default,
-        [on_orientation](geometry_msgs::msg::Pose::ConstSharedPtr m){ on_orientation(extract(*m)); });
+        [on_orientation, trace_id](geometry_msgs::msg::Pose::ConstSharedPtr m){ deliver(*m, trace_id, on_orientation); }, options);
     } else if (type == SupportedTypes::PoseStamped) {
       sub_ = node->create_subscription<geometry_msgs::msg::PoseStamped>(
         topic, qos_default,
-        [on_orientation](geometry_msgs::msg::PoseStamped::ConstSharedPtr m){ on_orientation(extract(*m)); });
+        [on_orientation, trace_id](geometry_msgs::msg::PoseStamped::ConstSharedPtr m){ deliver(*m, trace_id, on_orientation); }, options);
     } else if (type == SupportedTypes::PoseWithCovariance) {
       sub_ = node->create_subscription<geometry_msgs::msg::PoseWithCovariance>(
         topic, qos_default,
-        [on_orientation](geometry_msgs::msg::PoseWithCovariance::ConstSharedPtr m){ on_orientation(extract(*m)); });
+        [on_orientation, trace_id](geometry_msgs::msg::PoseWithCovariance::ConstSharedPtr m){ deliver(*m, trace_id, on_orientation); }, options);
     } else if (type == SupportedTypes::PoseWithCovarianceStamped) {
       sub_ = node->create_subscription<geometry_msgs::msg::PoseWithCovarianceStamped>(
         topic, qos_default,
-        [on_orientation](geometry_msgs::msg::PoseWithCovarianceStamped::ConstSharedPtr m){ on_orientation(extract(*m)); });
+        [on_orientation, trace_id](geometry_msgs::msg::PoseWithCovarianceStamped::ConstSharedPtr m){ deliver(*m, trace_id, on_orientation); }, options);
     } else if (type == SupportedTypes::Imu) {
       sub_ = node->create_subscription<sensor_msgs::msg::Imu>(
         topic, qos_imu,
-        [on_orientation](sensor_msgs::msg::Imu::ConstSharedPtr m){ on_orientation(extract(*m)); });
+        [on_orientation, trace_id, filter = std::make_shared<ImuOrientationFilter>(imu_filter)](
+          sensor_msgs::msg::Imu::ConstSharedPtr m){ deliverImu(*m, trace_id, *filter, on_orientation); }, options);
     } else if (type == SupportedTypes::Odometry) {
       sub_ = node->create_subscription<nav_msgs::msg::Odometry>(
         topic, qos_default,
-        [on_orientation](nav_msgs::msg::Odometry::ConstSharedPtr m){ on_orientation(extract(*m)); });
+        [on_orientation, trace_id](nav_msgs::msg::Odometry::ConstSharedPtr m){ deliver(*m, trace_id, on_orientation); }, options);
     }
   }
 
@@ -113,13 +314,46 @@ public:
   }
 
 private:
+  template<typename MessageT>
+  static void deliver(
+    const MessageT & msg, [[maybe_unused]] const void * trace_id,
+    const OrientationCallback & on_orientation)
+  {
+    ATTITUDE_TRACEPOINT(
+      callback_entry, trace_id, static_cast<const void *>(&msg), stampNanoseconds(msg));
+    AttitudeSample sample;
+    extract(msg, sample);
+    ATTITUDE_TRACEPOINT(orientation_extracted, trace_id, sample.stamp_ns);
+    on_orientation(sample);
+  }
+
+  // Raw IMU streams get their orientation from the filter, in the callback
+  static void deliverImu(
+    const sensor_msgs::msg::Imu & msg, [[maybe_unused]] const void * trace_id,
+    ImuOrientationFilter & filter, const OrientationCallback & on_orientation)
+  {
+    ATTITUDE_TRACEPOINT(
+      callback_entry, trace_id, static_cast<const void *>(&msg), stampNanoseconds(msg));
+    AttitudeSample sample;
+    extract(msg, sample);
+    if (filter.config().mode != ImuFilterMode::Off && ImuOrientationFilter::needsEstimate(msg)) {
+      const int64_t filter_time_ns = sample.stamp_ns != 0 ? sample.stamp_ns :
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+      sample.orientation = filter.update(msg, filter_time_ns);
+      sample.flags |= AttitudeSample::ORIENTATION_ESTIMATED;
+    }
+    ATTITUDE_TRACEPOINT(orientation_extracted, trace_id, sample.stamp_ns);
+    on_orientation(sample);
+  }
+
   rclcpp::SubscriptionBase::SharedPtr sub_;
 };
 
 class AttitudeTopicManager
 {
 public:
-  using OrientationCallback = std::function<void(const geometry_msgs::msg::Quaternion &)>;
+  using OrientationCallback = AttitudeSubscriber::OrientationCallback;
   using TopicList = std::vector<std::pair<std::string, std::string>>;
 
   /**
@@ -127,17 +361,29 @@ public:
    * @param node ROS2 node to query
    * @return Vector of (topic_name, type_string) pairs
    */
-  inline TopicList refreshTopics(rclcpp::Node * node)
+  inline const TopicList & refreshTopics(rclcpp::Node * node)
   {
-    if (!node) {
-      cached_topics_.clear();
-      return {};
-    }
-
     cached_topics_ = topic_discovery_.list(node);
     return cached_topics_;
   }
 
+  /**
+   * @brief Scope discovery to a namespace and a topic name regex.
+   * @return false if the regex is invalid (it is then ignored)
+   */
+  inline bool setScope(const std::string & ns, const std::string & pattern)
+  {
+    return topic_discovery_.setScope(ns, pattern);
+  }
+
+  /**
+   * @brief List only topics of one supported type ("" for any).
+   */
+  inline void setTypeFilter(const std::string & type)
+  {
+    topic_discovery_.setTypeFilter(type);
+  }
+
   /**
    * @brief Get the cached list of topics (avoids repeated queries).
    * @return Vector of (topic_name, type_string) pairs
@@ -157,6 +403,9 @@ public:
   {
     if (!node || topic.empty()) return {};
 
+    const std::string cached = topic_discovery_.cachedType(topic);
+    if (!cached.empty()) return cached;
+
     auto topics = node->get_topic_names_and_types();
     auto it = topics.find(topic);
     if (it == topics.end()) return {};
@@ -164,10 +413,32 @@ public:
     return SupportedTypes::firstSupported(it->second);
   }
 
+  /**
+   * @brief Use intra-process delivery for subsequent subscriptions.
+   */
+  inline void setIntraProcess(bool enable)
+  {
+    intra_process_ = enable;
+  }
+
+  inline bool intraProcess() const
+  {
+    return intra_process_;
+  }
+
+  /**
+   * @brief Orientation estimation for raw Imu streams, for subsequent subscriptions.
+   */
+  inline void setImuFilter(const ImuFilterConfig & config)
+  {
+    imu_filter_ = config;
+  }
+
   inline bool subscribe(rclcpp::Node * node,
                         const std::string & topic,
                         const std::string & type,
-                        const OrientationCallback & callback)
+                        const OrientationCallback & callback,
+                        const void * trace_id = nullptr)
   {
     if (!node || topic.empty() || type.empty()) return false;
     if (!SupportedTypes::isSupported(type)) return false;
@@ -176,7 +447,7 @@ public:
     unsubscribe();
 
     // Start new subscription
-    attitude_subscriber_.start(node, topic, type, callback);
+    attitude_subscriber_.start(node, topic, type, callback, intra_process_, trace_id, imu_filter_);
 
     // Update state
     active_topic_ = topic;
@@ -237,6 +508,8 @@ private:
   TopicList cached_topics_;
   std::string active_topic_;
   std::string active_type_;
+  bool intra_process_{false};
+  ImuFilterConfig imu_filter_;
 };
 
 }  // namespace rviz_attitude_plugin
@@ -0,0 +1,31 @@
+/*
+ * RViz Attitude Display Plugin - Optional LTTng Tracepoints (Header-Only)
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__TRACING_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__TRACING_HPP_
+
+/**
+ * ATTITUDE_TRACEPOINT(event, args...) emits an LTTng-UST event of the
+ * rviz_attitude_plugin provider when the plugin is built with
+ * -DRVIZ_ATTITUDE_PLUGIN_TRACING=ON, and expands to nothing otherwise (the
+ * arguments are not evaluated).
+ *
+ * Every event carries the display pointer as display id and the message
+ * header stamp in nanoseconds (0 for headerless messages), so a sample can
+ * be followed from rclcpp's take/callback events to the texture upload:
+ *
+ *   callback_entry         subscription callback entered (also message pointer)
+ *   orientation_extracted  quaternion pulled out of the message
+ *   euler_converted        roll/pitch/yaw computed
+ *   raster_start/_end      HUD components painted into the atlas staging
+ *   upload_end             staging pixels written to the overlay texture
+ */
+#ifdef RVIZ_ATTITUDE_PLUGIN_TRACING
+#include "rviz_attitude_plugin/tracing/attitude_tracepoints.h"
+#define ATTITUDE_TRACEPOINT(event, ...) tracepoint(rviz_attitude_plugin, event, __VA_ARGS__)
+#else
+#define ATTITUDE_TRACEPOINT(event, ...) do {} while (0)
+#endif
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__TRACING_HPP_
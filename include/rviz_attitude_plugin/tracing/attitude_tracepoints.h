@@ -0,0 +1,57 @@
+/*
+ * RViz Attitude Display Plugin - LTTng-UST tracepoint provider
+ *
+ * Only included when the plugin is built with RVIZ_ATTITUDE_PLUGIN_TRACING.
+ */
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER rviz_attitude_plugin
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "rviz_attitude_plugin/tracing/attitude_tracepoints.h"
+
+#if !defined(RVIZ_ATTITUDE_PLUGIN__TRACING__ATTITUDE_TRACEPOINTS_H_) || \
+  defined(TRACEPOINT_HEADER_MULTI_READ)
+#define RVIZ_ATTITUDE_PLUGIN__TRACING__ATTITUDE_TRACEPOINTS_H_
+
+#include <lttng/tracepoint.h>
+#include <stdint.h>
+
+TRACEPOINT_EVENT(
+  rviz_attitude_plugin,
+  callback_entry,
+  TP_ARGS(
+    const void *, display_arg,
+    const void *, message_arg,
+    int64_t, stamp_ns_arg),
+  TP_FIELDS(
+    ctf_integer_hex(const void *, display, display_arg)
+    ctf_integer_hex(const void *, message, message_arg)
+    ctf_integer(int64_t, stamp_ns, stamp_ns_arg))
+)
+
+TRACEPOINT_EVENT_CLASS(
+  rviz_attitude_plugin,
+  sample_stage,
+  TP_ARGS(
+    const void *, display_arg,
+    int64_t, stamp_ns_arg),
+  TP_FIELDS(
+    ctf_integer_hex(const void *, display, display_arg)
+    ctf_integer(int64_t, stamp_ns, stamp_ns_arg))
+)
+
+#define ATTITUDE_SAMPLE_STAGE(name) \
+  TRACEPOINT_EVENT_INSTANCE( \
+    rviz_attitude_plugin, sample_stage, name, \
+    TP_ARGS(const void *, display_arg, int64_t, stamp_ns_arg))
+
+ATTITUDE_SAMPLE_STAGE(orientation_extracted)
+ATTITUDE_SAMPLE_STAGE(euler_converted)
+ATTITUDE_SAMPLE_STAGE(raster_start)
+ATTITUDE_SAMPLE_STAGE(raster_end)
+ATTITUDE_SAMPLE_STAGE(upload_end)
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__TRACING__ATTITUDE_TRACEPOINTS_H_
+
+#include <lttng/tracepoint-event.h>
@@ -7,12 +7,32 @@
 
 #include <QWidget>
 #include <QString>
+#include <QFont>
+#include <QGlyphRun>
+#include <QRawFont>
+#include <QStaticText>
+#include <QVector>
+
+#include <array>
+#include <memory>
+
+#include "rviz_attitude_plugin/widgets/component_frame.hpp"
 
 namespace rviz_attitude_plugin
 {
 namespace widgets
 {
 
+class AngleReadoutRenderer;
+
+/**
+ * @brief Labelled numeric readout in a small display bezel.
+ *
+ * Drawn by an AngleReadoutRenderer: fonts, the title and the glyphs of the
+ * value characters are laid out once per size; the value is drawn as a
+ * glyph run assembled from those cached glyphs, so no text layout happens
+ * per frame.
+ */
 class AngleReadout : public QWidget
 {
   Q_OBJECT
@@ -27,8 +47,9 @@ public:
   /**
    * @brief Update the displayed value.
    * @param text The text to display (typically a formatted number)
+   * @return true if the text changed and a repaint was scheduled
    */
-  void setValue(const QString & text);
+  bool setValue(const QString & text);
 
   /**
    * @brief Change the accent color.
@@ -36,6 +57,11 @@ public:
    */
   void setColor(const QString & color);
 
+  /**
+   * @brief Current value at the current size, to paint on any thread.
+   */
+  ComponentFrame frame() const;
+
   QSize minimumSizeHint() const override;
 
 protected:
@@ -48,6 +74,40 @@ private:
   QString title_;
   QString value_;
   int r_, g_, b_;  // Parsed RGB values
+  std::shared_ptr<AngleReadoutRenderer> renderer_;
+};
+
+/**
+ * @brief Widget-independent drawing of an AngleReadout.
+ */
+class AngleReadoutRenderer : public ComponentRenderer
+{
+public:
+  struct State
+  {
+    QString title;
+    QString value;
+    int r, g, b;
+  };
+
+  AngleReadoutRenderer();
+
+  void paint(QPainter & painter, const QSize & size, const State & state);
+
+private:
+  void rebuildTextCache(const QSize & size, const QString & title, double scale);
+  bool layoutValue(const QString & value, QGlyphRun & run, qreal & width);
+
+  // Per-size text cache
+  QSize text_cache_size_;
+  QString title_;
+  QFont title_font_;
+  QStaticText title_text_;
+  QRawFont value_font_;
+  std::array<quint32, 256> glyph_indexes_;   // Latin-1 code -> glyph (0 = unavailable)
+  std::array<qreal, 256> glyph_advances_;
+  QVector<quint32> run_indexes_;
+  QVector<QPointF> run_positions_;
 };
 
 }  // namespace widgets
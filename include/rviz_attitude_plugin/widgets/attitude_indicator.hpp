@@ -5,14 +5,38 @@
 #ifndef RVIZ_ATTITUDE_PLUGIN__WIDGETS__ATTITUDE_INDICATOR_HPP_
 #define RVIZ_ATTITUDE_PLUGIN__WIDGETS__ATTITUDE_INDICATOR_HPP_
 
+#include "rviz_attitude_plugin/widgets/component_frame.hpp"
+#include "rviz_attitude_plugin/widgets/horizon_rasterizer.hpp"
+
 #include <QWidget>
 #include <QColor>
+#include <QImage>
+#include <QLineF>
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QSize>
+#include <QVector>
+
+#include <memory>
 
 namespace rviz_attitude_plugin
 {
 namespace widgets
 {
 
+class ArtificialHorizonRenderer;
+class AircraftReferenceRenderer;
+class RollIndicatorRenderer;
+
+/**
+ * @brief Sky/ground disk with horizon line and pitch ladder.
+ *
+ * Drawn by an ArtificialHorizonRenderer. The disk (gradients and horizon
+ * line) is filled by HorizonRasterizer straight into an image and blitted
+ * without transform. The pitch ladder is rendered once per size into a
+ * tall strip image covering ±90° of pitch and drawn as a single rotated,
+ * translated and clipped blit.
+ */
 class ArtificialHorizon : public QWidget
 {
   Q_OBJECT
@@ -20,6 +44,9 @@ class ArtificialHorizon : public QWidget
   Q_PROPERTY(double rollAngle READ rollAngle WRITE setRollAngle)
   Q_PROPERTY(bool backgroundVisible READ backgroundVisible WRITE setBackgroundVisible)
   Q_PROPERTY(double backgroundOpacity READ backgroundOpacity WRITE setBackgroundOpacity)
+  Q_PROPERTY(bool showPitchLadder READ showPitchLadder WRITE setShowPitchLadder)
+  Q_PROPERTY(double ladderRange READ ladderRange WRITE setLadderRange)
+  Q_PROPERTY(double ladderStep READ ladderStep WRITE setLadderStep)
 
 public:
   explicit ArtificialHorizon(QWidget * parent = nullptr);
@@ -30,62 +57,95 @@ public:
   double rollAngle() const { return roll_; }
   bool backgroundVisible() const { return background_visible_; }
   double backgroundOpacity() const { return background_opacity_; }
+  bool showPitchLadder() const { return show_pitch_ladder_; }
+  double ladderRange() const { return ladder_range_; }
+  double ladderStep() const { return ladder_step_; }
 
   // Setters
   void setPitchAngle(double pitch);
   void setRollAngle(double roll);
-  void setAttitude(double pitch, double roll);  // Convenience method
   void setBackgroundVisible(bool visible);
   void setBackgroundOpacity(double opacity);
+  void setShowPitchLadder(bool show);
+  void setLadderRange(double max_degrees);  // ±30, ±60, ±90
+  void setLadderStep(double step);          // 5°, 10°, 15°, 20°
+
+  /**
+   * @brief Set pitch and roll, repainting only on a visible change.
+   * @return true if the horizon moves by at least the pixel quantum
+   */
+  bool setAttitude(double pitch, double roll);
+
+  /**
+   * @brief Current attitude at the current size, to paint on any thread.
+   *
+   * The attitude it shows counts as painted for setAttitude()'s pixel quantum.
+   */
+  ComponentFrame frame();
 
   QSize sizeHint() const override;
 
 protected:
   void paintEvent(QPaintEvent * event) override;
+  void resizeEvent(QResizeEvent * event) override;
 
 private:
-  void drawSkyGround(QPainter & painter, double radius);
-  void drawOuterRing(QPainter & painter, double radius);
-
   double pitch_;                // degrees, positive = nose up
   double roll_;                 // degrees, positive = right wing down
+  double painted_pitch_;        // pitch of the last frame
+  double painted_roll_;         // roll of the last frame
   bool background_visible_;     // show/hide background
   double background_opacity_;   // background opacity (0.0-1.0)
+  bool show_pitch_ladder_;      // include the ladder in the strip
+  double ladder_range_;         // maximum pitch angle to display
+  double ladder_step_;          // step between ladder lines
+  double radius_;               // disk radius at the current size
+  std::shared_ptr<ArtificialHorizonRenderer> renderer_;
 };
 
-class PitchLadder : public QWidget
+/**
+ * @brief Widget-independent drawing of an ArtificialHorizon.
+ */
+class ArtificialHorizonRenderer : public ComponentRenderer
 {
-  Q_OBJECT
-  Q_PROPERTY(double pitchAngle READ pitchAngle WRITE setPitchAngle)
-  Q_PROPERTY(double rollAngle READ rollAngle WRITE setRollAngle)
-  Q_PROPERTY(double ladderRange READ ladderRange WRITE setLadderRange)
-  Q_PROPERTY(double ladderStep READ ladderStep WRITE setLadderStep)
-  Q_PROPERTY(bool visible READ isVisible WRITE setVisible)
-
 public:
-  explicit PitchLadder(QWidget * parent = nullptr);
-  ~PitchLadder() override = default;
+  struct State
+  {
+    double pitch;
+    double roll;
+    bool background_visible;
+    double background_opacity;
+    bool show_pitch_ladder;
+    double ladder_range;
+    double ladder_step;
+  };
+
+  ArtificialHorizonRenderer();
+
+  /**
+   * @brief Disk radius of a horizon of the given size.
+   */
+  static double diskRadius(const QSize & size);
+
+  void paint(QPainter & painter, const QSize & size, const State & state);
 
-  // Getters
-  double pitchAngle() const { return pitch_; }
-  double rollAngle() const { return roll_; }
-  double ladderRange() const { return ladder_range_; }
-  double ladderStep() const { return ladder_step_; }
-
-  // Setters
-  void setPitchAngle(double pitch);
-  void setRollAngle(double roll);
-  void setLadderRange(double max_degrees);  // ±30, ±60, ±90
-  void setLadderStep(double step);          // 5°, 10°, 15°, 20°
+private:
+  void rebuildGeometryCache(const QSize & size);
+  bool stripMatches(const State & state) const;
+  void rebuildStrip(const State & state, double radius);
+  void drawPitchLadder(QPainter & painter, const State & state, double radius);
+  void drawOuterRing(QPainter & painter, double radius);
 
-protected:
-  void paintEvent(QPaintEvent * event) override;
+  QSize geometry_size_;         // size the geometry was built for
+  double radius_;               // disk radius
+  QPainterPath clip_path_;      // circular bezel clip
 
-private:
-  double pitch_;          // degrees, positive = nose up
-  double roll_;           // degrees, positive = right wing down
-  double ladder_range_;   // maximum pitch angle to display
-  double ladder_step_;    // step between ladder lines
+  HorizonRasterizer horizon_raster_;
+  QImage disk_;                 // rasterized sky/ground disk
+  QImage strip_;                // pre-rendered ±90° ladder strip
+  double strip_radius_;         // radius the strip was rendered for
+  double strip_horizon_y_;      // strip row of the 0° horizon
+  State strip_state_;           // appearance the strip was rendered for
 };
 
 class AircraftReference : public QWidget
@@ -104,11 +164,40 @@ public:
   // Setters
   void setColor(const QColor & color);
 
+  /**
+   * @brief The symbol at the current size, to paint on any thread.
+   */
+  ComponentFrame frame() const;
+
 protected:
   void paintEvent(QPaintEvent * event) override;
 
 private:
   QColor color_;
+  std::shared_ptr<AircraftReferenceRenderer> renderer_;
+};
+
+/**
+ * @brief Widget-independent drawing of an AircraftReference.
+ */
+class AircraftReferenceRenderer : public ComponentRenderer
+{
+public:
+  struct State
+  {
+    QColor color;
+  };
+
+  AircraftReferenceRenderer();
+
+  void paint(QPainter & painter, const QSize & size, const State & state);
+
+private:
+  void rebuildGeometryCache(const QSize & size);
+
+  QSize geometry_size_;         // size the geometry was built for
+  double radius_;
+  QVector<QLineF> wing_lines_;  // wing bars, centre-relative
 };
 
 class RollIndicator : public QWidget
@@ -127,12 +216,57 @@ public:
   // Setters
   void setRollAngle(double roll);
 
+  /**
+   * @brief Set roll, repainting only on a visible change.
+   * @return true if the pointer moves by at least the pixel quantum
+   */
+  bool updateRoll(double roll);
+
+  /**
+   * @brief Current roll at the current size, to paint on any thread.
+   *
+   * The roll it shows counts as painted for updateRoll()'s pixel quantum.
+   */
+  ComponentFrame frame();
+
 protected:
   void paintEvent(QPaintEvent * event) override;
+  void resizeEvent(QResizeEvent * event) override;
 
 private:
   double roll_;           // degrees, positive = right wing down
-  double scale_factor_;   // scaling based on widget size
+  double painted_roll_;   // roll of the last frame
+  double radius_;         // pointer radius at the current size
+  std::shared_ptr<RollIndicatorRenderer> renderer_;
+};
+
+/**
+ * @brief Widget-independent drawing of a RollIndicator.
+ */
+class RollIndicatorRenderer : public ComponentRenderer
+{
+public:
+  struct State
+  {
+    double roll;
+  };
+
+  RollIndicatorRenderer();
+
+  /**
+   * @brief Radius of the pointer track of an indicator of the given size.
+   */
+  static double trackRadius(const QSize & size);
+
+  void paint(QPainter & painter, const QSize & size, const State & state);
+
+private:
+  void rebuildGeometryCache(const QSize & size);
+
+  double scale_factor_;   // scaling based on size
+  QSize geometry_size_;   // size the geometry was built for
+  double radius_;
+  QPolygonF pointer_;     // roll pointer at zero roll
 };
 
 class AttitudeIndicator : public QWidget
@@ -149,7 +283,19 @@ class AttitudeIndicator : public QWidget
 public:
   explicit AttitudeIndicator(QWidget * parent = nullptr);
   ~AttitudeIndicator() override = default;
-  void setAttitude(double pitch, double roll);
+
+  /**
+   * @brief Update pitch and roll of all components.
+   * @return true if any component changed visibly
+   */
+  bool setAttitude(double pitch, double roll);
+
+  /**
+   * @brief Horizon, aircraft symbol and roll pointer as shown, to paint on
+   *        any thread. The components fill the indicator, so they are drawn
+   *        at its origin, bottom to top.
+   */
+  ComponentFrame frame();
 
   // Visibility getters
   bool showPitchLadder() const { return show_pitch_ladder_; }
@@ -184,7 +330,6 @@ private:
 
   // Component widgets
   ArtificialHorizon * horizon_;
-  PitchLadder * pitch_ladder_;
   AircraftReference * aircraft_ref_;
   RollIndicator * roll_indicator_;
 
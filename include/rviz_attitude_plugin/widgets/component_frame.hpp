@@ -0,0 +1,70 @@
+/*
+ * RViz Attitude Display Plugin - Widget-Independent Component Painting
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__WIDGETS__COMPONENT_FRAME_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__WIDGETS__COMPONENT_FRAME_HPP_
+
+#include <QPainter>
+#include <QSize>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+/**
+ * @brief One frame of a HUD component, ready to paint on any thread.
+ *
+ * A frame holds a copy of the widget state it shows and the renderer that
+ * draws it, never the widget, so it can paint into a QImage on the
+ * RenderPool while the GUI thread keeps updating the widget.
+ */
+using ComponentFrame = std::function<void(QPainter & painter)>;
+
+/**
+ * @brief Smallest on-screen motion (px) for which a component repaints.
+ *
+ * Widgets compare how far their moving parts would travel since the last
+ * painted frame against this before scheduling a repaint.
+ */
+static constexpr double PIXEL_QUANTUM = 0.5;
+
+/**
+ * @brief Base of the per-widget renderers, which own the paint caches.
+ *
+ * A renderer is shared by its widget and the widget's frames; the lock is
+ * held while a frame paints, so two frames never rebuild a cache at once.
+ */
+class ComponentRenderer
+{
+public:
+  std::mutex & mutex() { return mutex_; }
+
+private:
+  std::mutex mutex_;
+};
+
+/**
+ * @brief Frame painting state at the given size with renderer.
+ */
+template<typename Renderer>
+ComponentFrame makeFrame(
+  const std::shared_ptr<Renderer> & renderer, const QSize & size,
+  typename Renderer::State state)
+{
+  return [renderer, size, state = std::move(state)](QPainter & painter) {
+      std::lock_guard<std::mutex> lock(renderer->mutex());
+      renderer->paint(painter, size, state);
+    };
+}
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__WIDGETS__COMPONENT_FRAME_HPP_
@@ -5,34 +5,145 @@
 #ifndef RVIZ_ATTITUDE_PLUGIN__WIDGETS__HEADING_INDICATOR_HPP_
 #define RVIZ_ATTITUDE_PLUGIN__WIDGETS__HEADING_INDICATOR_HPP_
 
+#include <QFont>
+#include <QImage>
+#include <QLineF>
+#include <QPointF>
+#include <QSize>
+#include <QStaticText>
+#include <QVector>
 #include <QWidget>
 
+#include <memory>
+#include <vector>
+
+#include "rviz_attitude_plugin/widgets/component_frame.hpp"
+
 namespace rviz_attitude_plugin
 {
 namespace widgets
 {
+class HeadingIndicatorRenderer;
+
+/**
+ * @brief Compass dial with a heading pointer that rotates with yaw.
+ *
+ * Drawn by a HeadingIndicatorRenderer. The bezel (shadow rings, rim and
+ * background gradients) never changes and is rendered once per size into a
+ * widget-sized sprite blitted first. The rotating rose is rendered once per
+ * size into a sprite too. Each paint either blits the sprite with the
+ * current rotation (RotatedBlit) or picks a pre-rotated copy quantized to
+ * 0.5° (PreRotated, filled lazily; faster per frame at the cost of memory).
+ * PreRotated only applies while all 720 copies of one rose fit in 16 MiB
+ * (roses up to ~50 px radius); larger roses fall back to rotated blits. The
+ * copies of all indicators in the process share one 64 MiB budget, so with
+ * many displays the later ones may find it spent and also blit. The cache
+ * is dropped on resize.
+ */
 class HeadingIndicator : public QWidget
 {
   Q_OBJECT
+  Q_PROPERTY(RoseCacheMode roseCacheMode READ roseCacheMode WRITE setRoseCacheMode)
 
 public:
+  enum class RoseCacheMode
+  {
+    RotatedBlit,
+    PreRotated
+  };
+  Q_ENUM(RoseCacheMode)
+
   explicit HeadingIndicator(QWidget * parent = nullptr);
   ~HeadingIndicator() override = default;
 
-  void setHeading(double yaw);
+  /**
+   * @brief Set the heading, repainting only on a visible change.
+   * @return true if the rose turns by at least the pixel quantum
+   */
+  bool setHeading(double yaw);
+
+  RoseCacheMode roseCacheMode() const { return rose_cache_mode_; }
+  void setRoseCacheMode(RoseCacheMode mode);
+
+  /**
+   * @brief Current heading at the current size, to paint on any thread.
+   *
+   * The heading it shows counts as painted for setHeading()'s pixel quantum.
+   */
+  ComponentFrame frame();
 
   QSize sizeHint() const override;
 
 protected:
   void paintEvent(QPaintEvent * event) override;
+  void resizeEvent(QResizeEvent * event) override;
+
+private:
+  double yaw_;            // degrees, ROS convention (0 = East, 90 = North)
+  double painted_yaw_;    // heading of the last frame
+  double radius_;         // dial radius at the current size
+  RoseCacheMode rose_cache_mode_;
+  std::shared_ptr<HeadingIndicatorRenderer> renderer_;
+};
+
+/**
+ * @brief Widget-independent drawing of a HeadingIndicator.
+ */
+class HeadingIndicatorRenderer : public ComponentRenderer
+{
+public:
+  struct State
+  {
+    double yaw;
+    HeadingIndicator::RoseCacheMode rose_cache_mode;
+  };
+
+  HeadingIndicatorRenderer();
+  ~HeadingIndicatorRenderer();
+
+  /**
+   * @brief Dial radius of an indicator of the given size.
+   */
+  static double dialRadius(const QSize & size);
+
+  void paint(QPainter & painter, const QSize & size, const State & state);
 
 private:
+  void rebuildGeometryCache(const QSize & size);
+  void rebuildBezelSprite();
   void draw3DCompassBezel(QPainter & painter, double radius);
-  void drawFixedOuterRing(QPainter & painter, double radius);
-  void drawRotatingCompassRose(QPainter & painter, double radius);
+  void drawFixedOuterRing(QPainter & painter);
+  void drawRotatingCompassRose(QPainter & painter, double radius, const State & state);
+  void paintCompassRose(QPainter & painter, double radius);
+  void rebuildRoseSprite(double radius);
+  bool preRotatedFits() const;
+  const QImage * rotatedRose(double angle);  // nullptr once the shared budget is spent
+  void dropRotatedRoses();
+  void rebuildDialCache(double radius);
+
+  struct Label
+  {
+    QStaticText text;
+    QPointF top_left;
+  };
 
-  double yaw_;            // degrees, ROS convention (0 = East, 90 = North)
   double scale_factor_;   // scaling based on widget size
+
+  QImage rose_sprite_;                  // unrotated rose, centred
+  double rose_radius_;                  // radius the sprite was rendered for
+  std::vector<QImage> rotated_roses_;   // PreRotated cache, one per 0.5°
+  size_t rotated_bytes_;                // charged to the process-wide budget
+
+  // Dial geometry laid out once per size
+  QSize geometry_size_;
+  double radius_;
+  QImage bezel_sprite_;                 // shadow rings, rim and background
+  QVector<QLineF> major_ticks_;
+  QVector<QLineF> minor_ticks_;
+  QFont cardinal_font_;
+  QFont degree_font_;
+  std::vector<Label> cardinal_labels_;
+  std::vector<Label> degree_labels_;
 };
 
 }  // namespace widgets
@@ -0,0 +1,95 @@
+/*
+ * RViz Attitude Display Plugin - Artificial Horizon Disk Rasterizer
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__WIDGETS__HORIZON_RASTERIZER_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__WIDGETS__HORIZON_RASTERIZER_HPP_
+
+#include <QImage>
+#include <QPointF>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+/**
+ * @brief Scanline rasterizer for the sky/ground disk of the horizon.
+ *
+ * Inside the disk the colour depends only on the signed distance from the
+ * rotated horizon line, which changes by a constant amount per pixel along
+ * a scanline. The sky and ground gradients and the horizon line are
+ * therefore baked into a 1D premultiplied colour table (box-filtered at a
+ * quarter pixel), spans between the analytic circle extents are filled by
+ * stepping through the table, and only the pixels straddling the rim get a
+ * per-pixel coverage term. No paths, clips or gradient brushes are involved.
+ * Disks taller than one band are split into row bands on the RenderPool.
+ */
+class HorizonRasterizer
+{
+public:
+  HorizonRasterizer();
+
+  /**
+   * @brief Rebuild the colour table for a disk radius and opacity.
+   */
+  void configure(double radius, double opacity);
+
+  double radius() const { return radius_; }
+
+  /**
+   * @brief Side of a square image able to hold the disk with its rim.
+   */
+  static int imageSide(double radius);
+
+  /**
+   * @brief Rasterize the disk into a premultiplied 32-bit image.
+   * @param target Image of at least imageSide() square; fully overwritten
+   * @param centre Disk centre in target pixel coordinates
+   * @param pitch_offset Distance (px) from the centre to the horizon, in
+   *        the rolled frame; positive moves the horizon up
+   * @param roll Roll angle in degrees, positive = right wing down
+   */
+  void render(QImage & target, const QPointF & centre, double pitch_offset, double roll) const;
+
+  /**
+   * @brief Fill count pixels from a colour table, stepping the index by step.
+   *
+   * Indices are clamped to the table and rounded to the nearest entry. SSE2
+   * computes four indices per step; the result is bit-identical to
+   * fillSpanScalar(), which is kept as the reference for tests and
+   * benchmarks.
+   */
+  static void fillSpan(
+    const uint32_t * lut, size_t size, uint32_t * dest, int count, float index, float step);
+  static void fillSpanScalar(
+    const uint32_t * lut, size_t size, uint32_t * dest, int count, float index, float step);
+
+private:
+  struct Frame
+  {
+    unsigned char * pixels;
+    size_t bytes_per_line;
+    int width;
+    QPointF centre;
+    double pitch_offset;
+    double sin_r;
+    double cos_r;
+  };
+
+  void renderRows(const Frame & frame, int y_begin, int y_end) const;
+
+  double radius_;
+  double opacity_;
+  float lut_origin_;            // horizon distance of table entry 0
+  std::vector<uint32_t> lut_;   // premultiplied ARGB32, LUT_STEPS_PER_PX per pixel
+};
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__WIDGETS__HORIZON_RASTERIZER_HPP_
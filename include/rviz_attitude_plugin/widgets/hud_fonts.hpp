@@ -0,0 +1,38 @@
+/*
+ * RViz Attitude Display Plugin - HUD Font Resolution
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__WIDGETS__HUD_FONTS_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__WIDGETS__HUD_FONTS_HPP_
+
+#include <QFont>
+#include <QString>
+#include <QStringList>
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+/**
+ * @brief Fonts used by the HUD widgets, resolved once per process.
+ *
+ * Requesting a family that is not installed (e.g. "Consolas" on Linux)
+ * sends Qt through fontconfig substitution. The first installed candidate
+ * is picked once, falling back to the system font of the given kind.
+ * Safe to call from RenderPool workers, which lay out component text.
+ */
+class HudFonts
+{
+public:
+  static QFont sans(int point_size, int weight = QFont::Normal);
+  static QFont monospace(int point_size, int weight = QFont::Normal);
+
+private:
+  static QString resolveFamily(const QStringList & candidates, bool fixed_pitch);
+};
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__WIDGETS__HUD_FONTS_HPP_
@@ -0,0 +1,95 @@
+/*
+ * RViz Attitude Display Plugin - Performance Strip Widget
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__WIDGETS__PERF_STRIP_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__WIDGETS__PERF_STRIP_HPP_
+
+#include <QFont>
+#include <QPolygonF>
+#include <QSize>
+#include <QStaticText>
+#include <QString>
+#include <QWidget>
+
+#include <array>
+#include <memory>
+
+#include "rviz_attitude_plugin/perf_stats.hpp"
+#include "rviz_attitude_plugin/widgets/component_frame.hpp"
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+class PerfStripRenderer;
+
+/**
+ * @brief Two lines of pipeline figures with a frame-cost sparkline.
+ *
+ * Drawn by a PerfStripRenderer. Text is only re-laid out when a formatted
+ * figure changes, and the sparkline reuses one polygon, so a refresh costs
+ * a handful of drawStaticText calls and one polyline.
+ */
+class PerfStrip : public QWidget
+{
+  Q_OBJECT
+
+public:
+  explicit PerfStrip(QWidget * parent = nullptr);
+  ~PerfStrip() override = default;
+
+  /**
+   * @brief Show new figures.
+   * @return true if anything visible changed and a repaint was scheduled
+   */
+  bool setSnapshot(const PerfSnapshot & snapshot);
+
+  /**
+   * @brief Current figures at the current size, to paint on any thread.
+   */
+  ComponentFrame frame() const;
+
+  QSize sizeHint() const override;
+
+protected:
+  void paintEvent(QPaintEvent * event) override;
+
+private:
+  QString lines_[2];
+  int font_height_;
+  std::array<float, PerfSnapshot::SPARKLINE_LENGTH> costs_ms_;
+  size_t cost_count_;
+  std::shared_ptr<PerfStripRenderer> renderer_;
+};
+
+/**
+ * @brief Widget-independent drawing of a PerfStrip.
+ */
+class PerfStripRenderer : public ComponentRenderer
+{
+public:
+  struct State
+  {
+    QString lines[2];
+    std::array<float, PerfSnapshot::SPARKLINE_LENGTH> costs_ms;
+    size_t cost_count;
+  };
+
+  PerfStripRenderer();
+
+  void paint(QPainter & painter, const QSize & size, const State & state);
+
+private:
+  QFont font_;
+  int font_height_;
+  QString lines_[2];            // text of line_text_
+  QStaticText line_text_[2];
+  QPolygonF sparkline_;
+};
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__WIDGETS__PERF_STRIP_HPP_
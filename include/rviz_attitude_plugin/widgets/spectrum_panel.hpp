@@ -0,0 +1,99 @@
+/*
+ * RViz Attitude Display Plugin - Vibration Spectrum Panel Widget
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__WIDGETS__SPECTRUM_PANEL_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__WIDGETS__SPECTRUM_PANEL_HPP_
+
+#include <QFont>
+#include <QPolygonF>
+#include <QSize>
+#include <QStaticText>
+#include <QString>
+#include <QWidget>
+
+#include <memory>
+
+#include "rviz_attitude_plugin/spectrum_analyzer.hpp"
+#include "rviz_attitude_plugin/widgets/component_frame.hpp"
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+class SpectrumPanelRenderer;
+
+/**
+ * @brief Roll and pitch rate PSD traces with their dominant peaks.
+ *
+ * The traces share a dB scale spanning DYNAMIC_RANGE_DB below the highest
+ * bin; the strongest peaks of each axis are listed above the plot. Drawn
+ * by a SpectrumPanelRenderer.
+ */
+class SpectrumPanel : public QWidget
+{
+  Q_OBJECT
+
+public:
+  static constexpr float DYNAMIC_RANGE_DB = 60.0f;
+
+  explicit SpectrumPanel(QWidget * parent = nullptr);
+  ~SpectrumPanel() override = default;
+
+  /**
+   * @brief Show a new spectrum; schedules a repaint.
+   */
+  void setResult(const SpectrumResult & result);
+
+  /**
+   * @brief Current spectrum at the current size, to paint on any thread.
+   */
+  ComponentFrame frame() const;
+
+  QSize sizeHint() const override;
+
+protected:
+  void paintEvent(QPaintEvent * event) override;
+
+private:
+  static QString peakText(const char * axis, const std::array<SpectrumPeak, SPECTRUM_PEAKS> & peaks,
+    size_t count);
+
+  std::shared_ptr<const SpectrumResult> result_;
+  QString label_;
+  int font_height_;
+  std::shared_ptr<SpectrumPanelRenderer> renderer_;
+};
+
+/**
+ * @brief Widget-independent drawing of a SpectrumPanel.
+ */
+class SpectrumPanelRenderer : public ComponentRenderer
+{
+public:
+  struct State
+  {
+    std::shared_ptr<const SpectrumResult> result;   // shared, never modified
+    QString label;
+  };
+
+  SpectrumPanelRenderer();
+
+  void paint(QPainter & painter, const QSize & size, const State & state);
+
+private:
+  static void buildTrace(const std::array<float, SPECTRUM_BINS> & db, const QRectF & area,
+    float top_db, QPolygonF & trace);
+
+  QFont font_;
+  int font_height_;
+  QStaticText label_;
+  QPolygonF roll_trace_;
+  QPolygonF pitch_trace_;
+};
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__WIDGETS__SPECTRUM_PANEL_HPP_
@@ -0,0 +1,89 @@
+/*
+ * RViz Attitude Display Plugin - Statistics Readout Widget
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__WIDGETS__STATS_READOUT_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__WIDGETS__STATS_READOUT_HPP_
+
+#include <QColor>
+#include <QFont>
+#include <QSize>
+#include <QStaticText>
+#include <QString>
+#include <QWidget>
+
+#include <memory>
+
+#include "rviz_attitude_plugin/widgets/component_frame.hpp"
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+class StatsReadoutRenderer;
+
+/**
+ * @brief Two small lines of windowed statistics under an AngleReadout.
+ *
+ * Drawn by a StatsReadoutRenderer; like PerfStrip, a line is only re-laid
+ * out when its text changes.
+ */
+class StatsReadout : public QWidget
+{
+  Q_OBJECT
+
+public:
+  explicit StatsReadout(const QString & color = "#3B82F6", QWidget * parent = nullptr);
+  ~StatsReadout() override = default;
+
+  /**
+   * @brief Update the displayed lines.
+   * @return true if either line changed and a repaint was scheduled
+   */
+  bool setLines(const QString & first, const QString & second);
+
+  /**
+   * @brief Current lines at the current size, to paint on any thread.
+   */
+  ComponentFrame frame() const;
+
+  QSize sizeHint() const override;
+
+protected:
+  void paintEvent(QPaintEvent * event) override;
+
+private:
+  QColor color_;
+  QString lines_[2];
+  int font_height_;
+  std::shared_ptr<StatsReadoutRenderer> renderer_;
+};
+
+/**
+ * @brief Widget-independent drawing of a StatsReadout.
+ */
+class StatsReadoutRenderer : public ComponentRenderer
+{
+public:
+  struct State
+  {
+    QColor color;
+    QString lines[2];
+  };
+
+  StatsReadoutRenderer();
+
+  void paint(QPainter & painter, const QSize & size, const State & state);
+
+private:
+  QFont font_;
+  int font_height_;
+  QString lines_[2];            // text of line_text_
+  QStaticText line_text_[2];
+};
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__WIDGETS__STATS_READOUT_HPP_
@@ -0,0 +1,168 @@
+/*
+ * RViz Attitude Display Plugin - Speed/Altitude Tape Widget
+ */
+
+#ifndef RVIZ_ATTITUDE_PLUGIN__WIDGETS__TAPE_INDICATOR_HPP_
+#define RVIZ_ATTITUDE_PLUGIN__WIDGETS__TAPE_INDICATOR_HPP_
+
+#include <QFont>
+#include <QImage>
+#include <QRectF>
+#include <QSize>
+#include <QStaticText>
+#include <QString>
+#include <QWidget>
+
+#include <memory>
+
+#include "rviz_attitude_plugin/widgets/component_frame.hpp"
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+class TapeIndicatorRenderer;
+
+/**
+ * @brief Vertical moving scale with the current value boxed at its centre.
+ *
+ * Drawn by a TapeIndicatorRenderer. Ticks and labels are rendered into a
+ * strip image covering STRIP_PAGES times the visible span around the
+ * value. Each paint blits the window of the strip centred on the value and
+ * draws the value box on top; the strip is only re-rendered on resize, on a
+ * scale change, or when the value drifts to within half a span of the
+ * strip's ends.
+ */
+class TapeIndicator : public QWidget
+{
+  Q_OBJECT
+
+public:
+  /**
+   * @brief Side of the attitude indicator the tape sits on; ticks face it.
+   */
+  enum class Side
+  {
+    Left,
+    Right
+  };
+
+  explicit TapeIndicator(const QString & title, Side side, QWidget * parent = nullptr);
+  ~TapeIndicator() override = default;
+
+  /**
+   * @brief Scale layout.
+   * @param visible_span Value range shown over the tape height
+   * @param minor_step Value between ticks
+   * @param label_every Ticks per labelled (major) tick
+   * @param decimals Decimals of the value box
+   */
+  void setScale(double visible_span, double minor_step, int label_every, int decimals);
+
+  /**
+   * @brief Values below minimum get no ticks (e.g. 0 for speed).
+   */
+  void setMinimum(double minimum);
+
+  /**
+   * @brief Set the value, repainting only on a visible change.
+   *
+   * A non-finite value is shown as no value (see clearValue()).
+   * @return true if the scale moves by at least the pixel quantum or the text changes
+   */
+  bool setValue(double value);
+
+  /**
+   * @brief Show "---" and no scale, for topics without this quantity.
+   * @return true if a value was shown
+   */
+  bool clearValue();
+
+  /**
+   * @brief Current value at the current size, to paint on any thread.
+   *
+   * The value it shows counts as painted for setValue()'s pixel quantum.
+   */
+  ComponentFrame frame();
+
+  QSize sizeHint() const override;
+  QSize minimumSizeHint() const override;
+
+protected:
+  void paintEvent(QPaintEvent * event) override;
+  void resizeEvent(QResizeEvent * event) override;
+
+private:
+  void updatePixelsPerUnit();
+
+  QString title_;
+  Side side_;
+  double visible_span_;
+  double minor_step_;
+  int label_every_;
+  int decimals_;
+  double minimum_;
+
+  double value_;
+  double painted_value_;   // value of the last frame
+  bool has_value_;
+  QString text_;
+  double pixels_per_unit_;
+  std::shared_ptr<TapeIndicatorRenderer> renderer_;
+};
+
+/**
+ * @brief Widget-independent drawing of a TapeIndicator.
+ */
+class TapeIndicatorRenderer : public ComponentRenderer
+{
+public:
+  struct State
+  {
+    QString title;
+    TapeIndicator::Side side;
+    double visible_span;
+    double minor_step;
+    int label_every;
+    double minimum;
+    double value;
+    bool has_value;
+    QString text;
+  };
+
+  TapeIndicatorRenderer();
+
+  /**
+   * @brief Scale area below the title of a tape of the given size.
+   */
+  static QRectF tapeRect(const QSize & size, const QString & title);
+
+  void paint(QPainter & painter, const QSize & size, const State & state);
+
+private:
+  void rebuildGeometryCache(const QSize & size, const QString & title);
+  void rebuildStrip(const State & state, double centre);
+  bool stripMatches(const State & state) const;
+
+  // Laid out once per size
+  QSize geometry_size_;
+  QString title_;
+  QRectF tape_rect_;       // scale area below the title
+  QFont title_font_;
+  QFont label_font_;
+  QFont value_font_;
+  QStaticText title_text_;
+  QString text_;           // text of value_text_
+  QStaticText value_text_;
+
+  QImage strip_;           // pre-rendered scale, STRIP_PAGES tape heights tall
+  double strip_low_;       // value at the strip's bottom row
+  bool strip_dirty_;       // layout changed, rebuild on next paint
+  State strip_state_;      // scale the strip was rendered for
+};
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
+
+#endif  // RVIZ_ATTITUDE_PLUGIN__WIDGETS__TAPE_INDICATOR_HPP_
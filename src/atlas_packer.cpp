@@ -0,0 +1,91 @@
+#include "rviz_attitude_plugin/atlas_packer.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace rviz_attitude_plugin
+{
+
+// A rectangle opens a new shelf rather than using one more than
+// 1/SHELF_SLACK_DIVISOR taller than itself
+static constexpr int SHELF_SLACK_DIVISOR = 4;
+
+AtlasPacker::AtlasPacker(int width, int max_height)
+: width_(width),
+  max_height_(max_height)
+{
+}
+
+unsigned int AtlasPacker::bucketedExtent(unsigned int extent, unsigned int step)
+{
+  const unsigned int rounded = ((extent + step - 1) / step) * step;
+  return std::max(extent, std::min(rounded, MAX_BUCKETED_EXTENT_PX));
+}
+
+bool AtlasPacker::pack(int width, int height, QRect & rect)
+{
+  if (width > width_) {
+    return false;
+  }
+
+  // Tightest existing shelf with room left
+  Shelf * best = nullptr;
+  for (auto & shelf : shelves_) {
+    if (shelf.height >= height && width_ - shelf.cursor >= width &&
+      (!best || shelf.height < best->height))
+    {
+      best = &shelf;
+    }
+  }
+
+  // A much taller shelf would waste the rows above the rectangle; those are
+  // only used once no new shelf fits
+  const int top = usedHeight();
+  const bool wasteful = best && best->height - height > height / SHELF_SLACK_DIVISOR;
+  if (!best || (wasteful && top + height <= max_height_)) {
+    if (top + height > max_height_) {
+      return false;
+    }
+    shelves_.push_back({top, height, 0});
+    best = &shelves_.back();
+  }
+
+  rect = QRect(best->cursor, best->top, width, height);
+  best->cursor += width;
+  return true;
+}
+
+bool AtlasPacker::repack(
+  const std::vector<QSize> & sizes, std::vector<QRect> & placed,
+  int width, int height, QRect & rect)
+{
+  // Tallest first fills each shelf with rectangles of similar height
+  std::vector<size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), size_t(0));
+  std::stable_sort(
+    order.begin(), order.end(),
+    [&sizes](size_t a, size_t b) {return sizes[a].height() > sizes[b].height();});
+
+  std::vector<Shelf> previous;
+  previous.swap(shelves_);
+  std::vector<QRect> layout(sizes.size());
+  bool fits = true;
+  for (size_t k = 0; k < order.size() && fits; ++k) {
+    const QSize & size = sizes[order[k]];
+    fits = pack(size.width(), size.height(), layout[order[k]]);
+  }
+  if (!fits || !pack(width, height, rect)) {
+    shelves_.swap(previous);
+    return false;
+  }
+
+  placed.swap(layout);
+  return true;
+}
+
+int AtlasPacker::usedHeight() const
+{
+  return shelves_.empty() ? 0 : shelves_.back().top + shelves_.back().height;
+}
+
+}  // namespace rviz_attitude_plugin
@@ -6,15 +6,22 @@
  */
 
 #include "rviz_attitude_plugin/attitude_display.hpp"
+#include "rviz_attitude_plugin/attitude_trail.hpp"
 #include "rviz_attitude_plugin/attitude_widget.hpp"
 #include "rviz_attitude_plugin/euler_converter.hpp"
+#include "rviz_attitude_plugin/glyph_batch.hpp"
 #include "rviz_attitude_plugin/overlay_system.hpp"
+#include "rviz_attitude_plugin/perf_stats.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
 #include "rviz_attitude_plugin/supported_types.hpp"
+#include "rviz_attitude_plugin/tracing.hpp"
 
 #include <rviz_common/display_context.hpp>
+#include <rviz_common/frame_manager_iface.hpp>
 #include <rviz_common/view_manager.hpp>
 #include <rviz_common/render_panel.hpp>
 #include <rviz_common/properties/enum_property.hpp>
+#include <rviz_common/properties/float_property.hpp>
 #include <rviz_common/properties/bool_property.hpp>
 #include <rviz_common/properties/int_property.hpp>
 #include <rviz_common/properties/string_property.hpp>
@@ -22,7 +29,12 @@
 #include <rviz_common/load_resource.hpp>
 #include <rviz_rendering/render_system.hpp>
 
+#include <geometry_msgs/msg/pose.hpp>
+#include <OgreQuaternion.h>
+#include <OgreVector3.h>
+
 #include <algorithm>
+#include <cmath>
 #include <QColor>
 #include <QEvent>
 #include <QPainter>
@@ -36,12 +48,27 @@ namespace rviz_attitude_plugin
 // Timing constants for async operations
 static constexpr int TOPIC_DISCOVERY_DELAY_MS = 250;
 static constexpr int BUTTON_RESET_DELAY_MS = 100;
+static constexpr int64_t PERF_REFRESH_NS = 250000000;  // perf strip updates at 4 Hz
+static constexpr int64_t STATS_REFRESH_NS = 100000000;  // statistics readouts update at 10 Hz
 
 AttitudeDisplay::AttitudeDisplay()
 : last_quaternion_{{0.0, 0.0, 0.0, 1.0}},
+  last_stamp_ns_(0),
+  last_euler_{{0.0, 0.0, 0.0}},
+  last_frame_hash_(0),
+  last_position_{{0.0, 0.0, 0.0}},
   has_data_(false),
   render_panel_(nullptr),
-  overlay_event_filter_installed_(false)
+  overlay_event_filter_installed_(false),
+  overlay_layout_pending_(false),
+  render_pending_(false),
+  overlay_atlas_full_(false),
+  last_perf_refresh_ns_(0),
+  last_stats_refresh_ns_(0),
+  glyph_(-1),
+  glyph_transform_failed_(false),
+  trail_transform_failed_(false),
+  profiler_acquired_(false)
 {
   setupProperties();
 }
@@ -56,6 +83,18 @@ AttitudeDisplay::~AttitudeDisplay()
     widget_->hide();
     widget_.reset();
   }
+
+  // Releasing the panels gathers queued paints, which report into perf_stats_
+  overlay_manager_.reset();
+
+  if (glyph_batch_) {
+    glyph_batch_->remove(glyph_);
+  }
+  trail_.reset();
+
+  if (profiler_acquired_) {
+    Profiler::instance().release();
+  }
 }
 
 void AttitudeDisplay::setupProperties()
@@ -76,6 +115,34 @@ void AttitudeDisplay::setupProperties()
     this,
     SLOT(onTopicChanged()));
 
+  topic_namespace_property_ = new rviz_common::properties::StringProperty(
+    "Namespace",
+    "",
+    "Only list topics under this namespace (e.g. /robot1); empty for all",
+    topic_property_,
+    SLOT(onTopicScopeChanged()),
+    this);
+
+  topic_filter_property_ = new rviz_common::properties::StringProperty(
+    "Filter",
+    "",
+    "Only list topics whose name matches this regular expression; empty for all",
+    topic_property_,
+    SLOT(onTopicScopeChanged()),
+    this);
+
+  topic_type_property_ = new rviz_common::properties::EnumProperty(
+    "Type",
+    "Any",
+    "Only list topics of this message type",
+    topic_property_,
+    SLOT(onTopicScopeChanged()),
+    this);
+  topic_type_property_->addOption("Any", 0);
+  for (const auto & type : SupportedTypes::list()) {
+    topic_type_property_->addOption(QString::fromStdString(type));
+  }
+
   refresh_button_property_ = new rviz_common::properties::BoolProperty(
     "Refresh Topics",
     false,
@@ -89,6 +156,35 @@ void AttitudeDisplay::setupProperties()
     "Type of the currently selected topic",
     this);
 
+  intra_process_property_ = new rviz_common::properties::BoolProperty(
+    "Intra-Process",
+    false,
+    "Receive messages from publishers in this process (e.g. composed nodes) "
+    "by shared pointer, without serialization",
+    this,
+    SLOT(onTopicChanged()));
+
+  imu_filter_property_ = new rviz_common::properties::EnumProperty(
+    "IMU Orientation",
+    "Madgwick",
+    "Estimator used for sensor_msgs/Imu messages without an orientation "
+    "(orientation_covariance[0] == -1); messages with one are shown as published",
+    this,
+    SLOT(onTopicChanged()));
+  imu_filter_property_->addOption("Off", static_cast<int>(ImuFilterMode::Off));
+  imu_filter_property_->addOption("Madgwick", static_cast<int>(ImuFilterMode::Madgwick));
+  imu_filter_property_->addOption("Complementary", static_cast<int>(ImuFilterMode::Complementary));
+
+  imu_filter_gain_property_ = new rviz_common::properties::FloatProperty(
+    "Filter Gain",
+    0.1f,
+    "Accelerometer correction gain: beta (rad/s) for Madgwick, Kp (1/s) for "
+    "Complementary. Higher converges faster but passes more vibration",
+    imu_filter_property_,
+    SLOT(onTopicChanged()),
+    this);
+  imu_filter_gain_property_->setMin(0.0f);
+
   overlay_x_property_ = new rviz_common::properties::IntProperty(
     "Overlay X",
     16,
@@ -160,6 +256,148 @@ void AttitudeDisplay::setupProperties()
   display_mode_property_->addOption("Compact", 1);
   display_mode_property_->setString("Full"); // default to Full
 
+  compass_cache_property_ = new rviz_common::properties::EnumProperty(
+    "Compass Cache",
+    "Rotated Blit",
+    "How the compass rose is turned: one rotated blit per paint, or 720 pre-rotated "
+    "sprites (0.5° steps, faster per paint; at most 16 MiB per rose and 64 MiB across all "
+    "displays, beyond which rotated blits are used)",
+    this,
+    SLOT(updateCompassCache()));
+  compass_cache_property_->addOption("Rotated Blit", 0);
+  compass_cache_property_->addOption("Pre-rotated", 1);
+
+  show_tapes_property_ = new rviz_common::properties::BoolProperty(
+    "Show Tapes",
+    false,
+    "Show a speed tape (m/s, magnitude of the Odometry twist) left of the attitude "
+    "indicator and an altitude tape (m, position z in the message frame) right of it",
+    this,
+    SLOT(updateShowTapes()));
+
+  show_glyph_property_ = new rviz_common::properties::BoolProperty(
+    "Show 3D Glyph",
+    false,
+    "Draw an airplane glyph at the vehicle pose in the scene, coloured by the roll/pitch "
+    "alarm state. Topics without a position place it at their frame origin",
+    this);
+
+  glyph_length_property_ = new rviz_common::properties::FloatProperty(
+    "Glyph Length (m)",
+    1.0f,
+    "Nose-to-tail size of the glyph",
+    show_glyph_property_);
+  glyph_length_property_->setMin(0.01f);
+
+  roll_alarm_property_ = new rviz_common::properties::FloatProperty(
+    "Roll Alarm (deg)",
+    45.0f,
+    "Roll magnitude at which the glyph turns red; amber from 75% of it. 0 disables",
+    show_glyph_property_);
+  roll_alarm_property_->setMin(0.0f);
+
+  pitch_alarm_property_ = new rviz_common::properties::FloatProperty(
+    "Pitch Alarm (deg)",
+    30.0f,
+    "Pitch magnitude at which the glyph turns red; amber from 75% of it. 0 disables",
+    show_glyph_property_);
+  pitch_alarm_property_->setMin(0.0f);
+
+  show_trail_property_ = new rviz_common::properties::BoolProperty(
+    "Show Trail",
+    false,
+    "Draw body-axis ticks (x red, y green, z blue) at past poses along the path. "
+    "Needs a topic with a position (Odometry, PoseStamped, PoseWithCovarianceStamped)",
+    this,
+    SLOT(updateTrail()));
+
+  trail_length_property_ = new rviz_common::properties::IntProperty(
+    "Trail Length",
+    1000,
+    "Number of poses kept; the oldest is overwritten. Drawing cost does not depend on it",
+    show_trail_property_,
+    SLOT(updateTrail()),
+    this);
+  trail_length_property_->setMin(1);
+  trail_length_property_->setMax(static_cast<int>(AttitudeTrail::MAX_CAPACITY));
+
+  trail_tick_property_ = new rviz_common::properties::FloatProperty(
+    "Tick Length (m)",
+    0.2f,
+    "Length of each body-axis tick; applies to poses received afterwards",
+    show_trail_property_,
+    SLOT(updateTrail()),
+    this);
+  trail_tick_property_->setMin(0.001f);
+
+  show_statistics_property_ = new rviz_common::properties::BoolProperty(
+    "Show Statistics",
+    false,
+    "Show mean, standard deviation, min and max of roll and pitch, and the circular "
+    "mean and deviation of yaw, under the angle readouts",
+    this,
+    SLOT(updateShowStatistics()));
+
+  statistics_window_property_ = new rviz_common::properties::FloatProperty(
+    "Statistics Window (s)",
+    10.0f,
+    "Length of the sliding window the statistics cover (up to an hour, at most "
+    "4M samples); samples are stored compressed at 10 bytes each",
+    show_statistics_property_,
+    SLOT(updateStatisticsWindow()),
+    this);
+  statistics_window_property_->setMin(0.1f);
+  statistics_window_property_->setMax(3600.0f);
+
+  show_spectrum_property_ = new rviz_common::properties::BoolProperty(
+    "Show Spectrum",
+    false,
+    "Draw the power spectral density of the roll and pitch rates with its dominant "
+    "peaks, to diagnose vibration",
+    this,
+    SLOT(updateShowSpectrum()));
+
+  spectrum_source_property_ = new rviz_common::properties::EnumProperty(
+    "Rate Source",
+    "Auto",
+    "Auto uses measured body rates when the topic provides them (Imu angular_velocity, "
+    "Odometry twist) and differenced orientation otherwise",
+    show_spectrum_property_,
+    SLOT(updateShowSpectrum()),
+    this);
+  spectrum_source_property_->addOption("Auto", 0);
+  spectrum_source_property_->addOption("Differenced", 1);
+
+  show_performance_property_ = new rviz_common::properties::BoolProperty(
+    "Show Performance",
+    false,
+    "Draw a strip with message rate, frame rate, coalescing, p99 latency, "
+    "raster/upload cost and texture bandwidth inside the overlay",
+    this,
+    SLOT(updateShowPerformance()));
+
+  profiler_property_ = new rviz_common::properties::BoolProperty(
+    "Profiler",
+    false,
+    "Record time spent in message handling, painting and rendering "
+    "(process-wide: records while any attitude display has this on)",
+    this,
+    SLOT(onProfilerChanged()));
+
+  trace_file_property_ = new rviz_common::properties::StringProperty(
+    "Trace File",
+    "/tmp/rviz_attitude_trace.json",
+    "Chrome trace JSON written by Dump Trace; open it in ui.perfetto.dev or chrome://tracing",
+    profiler_property_);
+
+  dump_trace_property_ = new rviz_common::properties::BoolProperty(
+    "Dump Trace",
+    false,
+    "Click to write the recorded events to the trace file",
+    profiler_property_,
+    SLOT(onDumpTrace()),
+    this);
+
   // No background toggles in properties; defaults are set in onInitialize
 }
 
@@ -184,12 +422,19 @@ void AttitudeDisplay::onInitialize()
 
   const int unit_index = angle_unit_property_->getOptionInt();
   widget_->setUnit(unit_index == 0 ? std::string("deg") : std::string("rad"));
+  widget_->setShowPerformance(show_performance_property_->getBool());
+  widget_->setShowSpectrum(show_spectrum_property_->getBool());
+  widget_->setShowStatistics(show_statistics_property_->getBool());
+  widget_->setShowTapes(show_tapes_property_->getBool());
+  widget_->setPreRotatedCompass(compass_cache_property_->getOptionInt() == 1);
+  attitude_history_.setWindow(statistics_window_property_->getFloat());
+  updateTrail();
 
   attachOverlay();
   updateOverlayProperties();
 
-  // Populate topics initially
-  refreshSupportedTopics();
+  // Populate topics initially, within the configured scope
+  onTopicScopeChanged();
   // And again shortly after startup to catch late discovery
   QTimer::singleShot(TOPIC_DISCOVERY_DELAY_MS, [this]() { refreshSupportedTopics(); });
 }
@@ -201,15 +446,18 @@ void AttitudeDisplay::onEnable()
   if (show_overlay_property_->getBool()) {
     if (overlay_manager_) {
       overlay_manager_->setVisible(true);
-      overlay_manager_->render(*widget_);
+      requestRender();
     }
   }
+  if (trail_) trail_->setVisible(show_trail_property_->getBool());
 }
 
 void AttitudeDisplay::onDisable()
 {
   rviz_common::Display::onDisable();
   if (overlay_manager_) overlay_manager_->setVisible(false);
+  if (glyph_batch_) glyph_batch_->hide(glyph_);
+  if (trail_) trail_->setVisible(false);
   topic_manager_.unsubscribe();
 }
 
@@ -224,21 +472,200 @@ void AttitudeDisplay::updateDisplay(double x, double y, double z, double w)
 
   double roll, pitch, yaw;
   converter_->convert(x, y, z, w, roll, pitch, yaw);
+  last_euler_ = {{roll, pitch, yaw}};
+  ATTITUDE_TRACEPOINT(euler_converted, this, last_stamp_ns_);
 
   if (widget_) {
     widget_->updateAngles(roll, pitch, yaw);
-    if (overlay_manager_) overlay_manager_->render(*widget_);
+    requestRender();
   }
 }
 
+void AttitudeDisplay::requestRender()
+{
+  // Messages and property changes only update state; update() renders once per tick
+  render_pending_ = true;
+}
+
 void AttitudeDisplay::update(float /*wall_dt*/, float /*ros_dt*/)
 {
+  // Apply at most one re-layout per frame, however many resize events arrived
+  if (overlay_layout_pending_) {
+    overlay_layout_pending_ = false;
+    updateOverlayProperties();
+    context_->queueRender();
+  }
+
+  // Statistics are O(1) to read but only repainted at a readable rate
+  if (widget_ && widget_->showStatistics()) {
+    const int64_t now = Profiler::now();
+    if (now - last_stats_refresh_ns_ >= STATS_REFRESH_NS) {
+      last_stats_refresh_ns_ = now;
+      widget_->setStatistics(attitude_history_.stats());
+      requestRender();
+    }
+  }
+
+  // The spectrum is recomputed on the pool at a few Hz and picked up here
+  if (widget_ && widget_->showSpectrum()) {
+    spectrum_analyzer_.poll(Profiler::now());
+    if (spectrum_analyzer_.takeResult(spectrum_result_)) {
+      widget_->setSpectrum(spectrum_result_);
+      requestRender();
+    }
+  }
+
+  // The perf strip reads its counters a few times per second, not per frame
+  const bool show_performance = widget_ && widget_->showPerformance();
+  if (show_performance) {
+    const int64_t now = Profiler::now();
+    if (now - last_perf_refresh_ns_ >= PERF_REFRESH_NS) {
+      last_perf_refresh_ns_ = now;
+      widget_->setPerfSnapshot(perf_stats_.snapshot(now));
+      requestRender();
+    }
+  }
+
+  // Dirty components are painted on the RenderPool; the shared atlas gathers,
+  // hashes and uploads them when the next frame starts
+  if (render_pending_ && overlay_manager_ && widget_) {
+    render_pending_ = false;
+    UploadTag tag;
+    tag.display = this;
+    tag.stamp_ns = last_stamp_ns_;
+    tag.stats = show_performance ? &perf_stats_ : nullptr;
+    overlay_manager_->render(*widget_, tag);
+    context_->queueRender();
+
+    if (overlay_manager_->atlasFull() != overlay_atlas_full_) {
+      overlay_atlas_full_ = overlay_manager_->atlasFull();
+      if (overlay_atlas_full_) {
+        setStatus(rviz_common::properties::StatusProperty::Error, "Overlay",
+          "Shared HUD texture atlas is full; shrink the HUD or disable other attitude displays");
+      } else {
+        deleteStatus("Overlay");
+      }
+    }
+  }
+
+  updateGlyph();
+
+  // Only the poses received since the last frame reach the vertex buffer
+  if (trail_ && trail_->flush()) {
+    context_->queueRender();
+  }
+
   // Periodically raise widget to keep it on top
   if (widget_ && widget_->isVisible() && show_overlay_property_->getBool()) {
     widget_->raise();
   }
 }
 
+void AttitudeDisplay::updateGlyph()
+{
+  if (!show_glyph_property_->getBool() || !has_data_) {
+    if (glyph_batch_ && glyph_batch_->hide(glyph_)) {
+      context_->queueRender();
+    }
+    return;
+  }
+  if (!glyph_batch_) {
+    glyph_batch_ = GlyphBatch::acquire(scene_manager_);
+    if (!glyph_batch_) {
+      return;
+    }
+    glyph_ = glyph_batch_->add();
+  }
+
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = last_position_[0];
+  pose.position.y = last_position_[1];
+  pose.position.z = last_position_[2];
+  pose.orientation.x = last_quaternion_[0];
+  pose.orientation.y = last_quaternion_[1];
+  pose.orientation.z = last_quaternion_[2];
+  pose.orientation.w = last_quaternion_[3];
+
+  const std::string frame = last_frame_id_.empty() ? fixed_frame_.toStdString() : last_frame_id_;
+  Ogre::Vector3 position;
+  Ogre::Quaternion orientation;
+  if (!transformPose(frame, last_stamp_ns_, pose, position, orientation)) {
+    if (!glyph_transform_failed_) {
+      glyph_transform_failed_ = true;
+      setStatus(rviz_common::properties::StatusProperty::Warn, "Glyph",
+        QString("No transform from [%1] to [%2]")
+        .arg(QString::fromStdString(frame), fixed_frame_));
+    }
+    if (glyph_batch_->hide(glyph_)) {
+      context_->queueRender();
+    }
+    return;
+  }
+  if (glyph_transform_failed_) {
+    glyph_transform_failed_ = false;
+    deleteStatus("Glyph");
+  }
+
+  const AttitudeAlarm alarm = classifyAttitude(
+    last_euler_[0], last_euler_[1],
+    roll_alarm_property_->getFloat() * M_PI / 180.0,
+    pitch_alarm_property_->getFloat() * M_PI / 180.0);
+  if (glyph_batch_->set(glyph_, position, orientation, glyph_length_property_->getFloat(), alarm)) {
+    context_->queueRender();
+  }
+}
+
+void AttitudeDisplay::pushTrail(const AttitudeSample & sample)
+{
+  if (!trail_ || !sample.has(AttitudeSample::HAS_POSITION)) {
+    return;
+  }
+
+  geometry_msgs::msg::Pose pose;
+  pose.position = sample.position;
+  pose.orientation = sample.orientation;
+
+  const std::string frame = last_frame_id_.empty() ? fixed_frame_.toStdString() : last_frame_id_;
+  Ogre::Vector3 position;
+  Ogre::Quaternion orientation;
+  if (!transformPose(frame, sample.stamp_ns, pose, position, orientation)) {
+    if (!trail_transform_failed_) {
+      trail_transform_failed_ = true;
+      setStatus(rviz_common::properties::StatusProperty::Warn, "Trail",
+        QString("No transform from [%1] to [%2]")
+        .arg(QString::fromStdString(frame), fixed_frame_));
+    }
+    return;
+  }
+  if (trail_transform_failed_) {
+    trail_transform_failed_ = false;
+    deleteStatus("Trail");
+  }
+  trail_->push(position, orientation);
+}
+
+bool AttitudeDisplay::transformPose(
+  const std::string & frame, int64_t stamp_ns, const geometry_msgs::msg::Pose & pose,
+  Ogre::Vector3 & position, Ogre::Quaternion & orientation)
+{
+  // The sample's own stamp first; the latest transform if TF has not caught up
+  auto * frame_manager = context_->getFrameManager();
+  return
+    frame_manager->transform(
+    frame, rclcpp::Time(stamp_ns, RCL_ROS_TIME), pose, position, orientation) ||
+    frame_manager->transform(
+    frame, rclcpp::Time(0, 0, RCL_ROS_TIME), pose, position, orientation);
+}
+
+void AttitudeDisplay::fixedFrameChanged()
+{
+  // Trail vertices are baked in the old fixed frame
+  if (trail_) {
+    trail_->clear();
+    context_->queueRender();
+  }
+}
+
 // No updateEulerConvention: always use ROS tf2 RPY conversion
 
 // No background-toggle slots; handled by defaults
@@ -249,7 +676,7 @@ void AttitudeDisplay::updateAngleUnit()
   const std::string unit = (unit_index == 0) ? "deg" : "rad";
   if (widget_) {
     widget_->setUnit(unit);
-    if (overlay_manager_) overlay_manager_->render(*widget_);
+    requestRender();
   }
 
   if (has_data_) {
@@ -265,7 +692,7 @@ void AttitudeDisplay::updateDisplayMode()
     : rviz_attitude_plugin::DisplayMode::Compact;
   if (widget_) {
     widget_->setDisplayMode(mode);
-    if (overlay_manager_) overlay_manager_->render(*widget_);
+    requestRender();
   }
 }
 
@@ -289,7 +716,7 @@ void AttitudeDisplay::updateOverlayProperties()
     auto [clamped_x, clamped_y] = geometry_manager_.calculateClampedOffsets(panel_size);
 
     overlay_manager_->setGeometry(width, height, clamped_x, clamped_y, anchor);
-    if (widget_) overlay_manager_->render(*widget_);
+    requestRender();
     overlay_manager_->setVisible(show);
   }
 }
@@ -314,7 +741,8 @@ bool AttitudeDisplay::eventFilter(QObject * object, QEvent * event)
 {
   if (object == render_panel_) {
     if (event->type() == QEvent::Resize || event->type() == QEvent::Show) {
-      updateOverlayProperties();
+      // Debounced: applied on the next update() tick
+      overlay_layout_pending_ = true;
     }
   }
 
@@ -333,9 +761,148 @@ void AttitudeDisplay::onRefreshTopics()
   }
 }
 
+void AttitudeDisplay::updateCompassCache()
+{
+  if (widget_) {
+    widget_->setPreRotatedCompass(compass_cache_property_->getOptionInt() == 1);
+    requestRender();
+  }
+}
+
+void AttitudeDisplay::updateShowTapes()
+{
+  if (widget_) {
+    widget_->setShowTapes(show_tapes_property_->getBool());
+    requestRender();
+  }
+}
+
+void AttitudeDisplay::updateTrail()
+{
+  if (!show_trail_property_->getBool()) {
+    trail_.reset();
+    trail_transform_failed_ = false;
+    deleteStatus("Trail");
+    if (context_) context_->queueRender();
+    return;
+  }
+  if (!scene_manager_) {
+    return;  // created in onInitialize
+  }
+  if (!trail_) {
+    trail_ = std::make_unique<AttitudeTrail>(scene_manager_, scene_node_);
+    trail_->setVisible(isEnabled());
+  }
+  const size_t capacity = static_cast<size_t>(trail_length_property_->getInt());
+  if (capacity != trail_->capacity()) {
+    trail_->setCapacity(capacity);
+  }
+  trail_->setTickLength(trail_tick_property_->getFloat());
+}
+
+void AttitudeDisplay::updateShowStatistics()
+{
+  attitude_history_.clear();
+  last_stats_refresh_ns_ = 0;
+  if (widget_) {
+    widget_->setShowStatistics(show_statistics_property_->getBool());
+    requestRender();
+  }
+}
+
+void AttitudeDisplay::updateStatisticsWindow()
+{
+  attitude_history_.setWindow(statistics_window_property_->getFloat());
+  last_stats_refresh_ns_ = 0;
+}
+
+void AttitudeDisplay::updateShowSpectrum()
+{
+  spectrum_analyzer_.reset();
+  if (widget_) {
+    widget_->setShowSpectrum(show_spectrum_property_->getBool());
+    requestRender();
+  }
+}
+
+void AttitudeDisplay::updateShowPerformance()
+{
+  perf_stats_.reset();
+  last_perf_refresh_ns_ = 0;
+  if (widget_) {
+    widget_->setShowPerformance(show_performance_property_->getBool());
+    requestRender();
+  }
+}
+
+void AttitudeDisplay::onProfilerChanged()
+{
+  // The profiler is process-wide; each display holds at most one reference
+  const bool enabled = profiler_property_->getBool();
+  if (enabled == profiler_acquired_) {
+    return;
+  }
+  if (enabled) {
+    Profiler::instance().acquire();
+  } else {
+    Profiler::instance().release();
+  }
+  profiler_acquired_ = enabled;
+}
+
+void AttitudeDisplay::onDumpTrace()
+{
+  if (!dump_trace_property_->getBool()) {
+    return;
+  }
+
+  const std::string path = trace_file_property_->getStdString();
+  std::string error;
+  const int events = Profiler::instance().dumpChromeTrace(path, error);
+  if (events < 0) {
+    setStatus(rviz_common::properties::StatusProperty::Error, "Profiler",
+      QString::fromStdString(error));
+  } else {
+    setStatus(rviz_common::properties::StatusProperty::Ok, "Profiler",
+      QString("%1 event(s) written to %2").arg(events).arg(QString::fromStdString(path)));
+  }
+
+  QTimer::singleShot(BUTTON_RESET_DELAY_MS, [this]() {
+    if (dump_trace_property_) {
+      dump_trace_property_->setBool(false);
+    }
+  });
+}
+
+void AttitudeDisplay::onTopicScopeChanged()
+{
+  const bool valid = topic_manager_.setScope(
+    topic_namespace_property_->getStdString(),
+    topic_filter_property_->getStdString());
+  if (valid) {
+    deleteStatus("Topic Filter");
+  } else {
+    setStatus(rviz_common::properties::StatusProperty::Error, "Topic Filter",
+      "Invalid regular expression, filter ignored");
+  }
+
+  const std::string type = topic_type_property_->getStdString();
+  topic_manager_.setTypeFilter(type == "Any" ? std::string() : type);
+
+  refreshSupportedTopics();
+}
+
 void AttitudeDisplay::onTopicChanged()
 {
   topic_manager_.unsubscribe();
+  attitude_history_.clear();
+  spectrum_analyzer_.reset();
+  if (trail_) trail_->clear();
+  if (widget_) {
+    widget_->clearSpeed();
+    widget_->clearAltitude();
+    requestRender();
+  }
   subscribeToSelected();
 }
 
@@ -346,8 +913,8 @@ void AttitudeDisplay::refreshSupportedTopics()
   if (!ros_node) return;
   auto node = ros_node->get_raw_node();
 
-  // Use TopicManager to refresh topics
-  auto items = topic_manager_.refreshTopics(node.get());
+  // Use TopicManager to refresh topics (scoped and cached)
+  const auto & items = topic_manager_.refreshTopics(node.get());
   size_t count = items.size();
 
   topic_property_->clearOptions();
@@ -380,9 +947,53 @@ void AttitudeDisplay::refreshSupportedTopics()
   }
 }
 
-void AttitudeDisplay::onOrientation(const geometry_msgs::msg::Quaternion & q)
+void AttitudeDisplay::onOrientation(const AttitudeSample & sample)
 {
+  ATTITUDE_PROFILE_SCOPE("AttitudeDisplay::onOrientation");
+  if (widget_ && widget_->showPerformance()) {
+    perf_stats_.messageReceived(Profiler::now());
+  }
+  last_stamp_ns_ = sample.stamp_ns;
+  // The frame string is only copied when it changes
+  if (sample.frame_hash != last_frame_hash_) {
+    last_frame_hash_ = sample.frame_hash;
+    last_frame_id_.assign(sample.frame_id.data(), sample.frame_id.size());
+  }
+  last_position_ = sample.has(AttitudeSample::HAS_POSITION) ?
+    std::array<double, 3>{{sample.position.x, sample.position.y, sample.position.z}} :
+    std::array<double, 3>{{0.0, 0.0, 0.0}};
+  const auto & q = sample.orientation;
   updateDisplay(q.x, q.y, q.z, q.w);
+
+  const int64_t time_ns = sample.stamp_ns != 0 ? sample.stamp_ns : Profiler::now();
+  pushTrail(sample);
+
+  // The tapes read the same sample; types without the quantity show dashes
+  if (widget_ && widget_->showTapes()) {
+    if (sample.has(AttitudeSample::HAS_VELOCITY)) {
+      const auto & v = sample.linear_velocity;
+      widget_->setSpeed(std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z));
+    } else {
+      widget_->clearSpeed();
+    }
+    if (sample.has(AttitudeSample::HAS_POSITION)) {
+      widget_->setAltitude(sample.position.z);
+    } else {
+      widget_->clearAltitude();
+    }
+  }
+
+  if (widget_ && widget_->showStatistics()) {
+    attitude_history_.push(time_ns, q.x, q.y, q.z, q.w);
+  }
+
+  if (widget_ && widget_->showSpectrum()) {
+    if (sample.has(AttitudeSample::HAS_RATES) && spectrum_source_property_->getOptionInt() == 0) {
+      spectrum_analyzer_.push(time_ns, sample.angular_velocity.x, sample.angular_velocity.y);
+    } else {
+      spectrum_analyzer_.pushAngles(time_ns, last_euler_[0], last_euler_[1]);
+    }
+  }
 }
 
 void AttitudeDisplay::subscribeToSelected()
@@ -401,8 +1012,13 @@ void AttitudeDisplay::subscribeToSelected()
   if (type.empty()) return;
 
   // Subscribe using TopicManager
+  topic_manager_.setIntraProcess(intra_process_property_->getBool());
+  ImuFilterConfig imu_filter;
+  imu_filter.mode = static_cast<ImuFilterMode>(imu_filter_property_->getOptionInt());
+  imu_filter.gain = imu_filter_gain_property_->getFloat();
+  topic_manager_.setImuFilter(imu_filter);
   topic_manager_.subscribe(node.get(), topic, type,
-    [this](const geometry_msgs::msg::Quaternion & q){ onOrientation(q); });
+    [this](const AttitudeSample & sample){ onOrientation(sample); }, this);
 }
 
 // Support for other message types via template specialization would go here
@@ -0,0 +1,390 @@
+#include "rviz_attitude_plugin/attitude_history.hpp"
+#include "rviz_attitude_plugin/quaternion_codec.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rviz_attitude_plugin
+{
+
+static constexpr double DEFAULT_WINDOW_S = 10.0;
+
+// Offsets are 32-bit microseconds (71 min), so a block may span at most
+// this much; the window is clamped to it so only the newest block can be
+// partially filled
+static constexpr double MAX_WINDOW_S = 3600.0;
+
+// Keeps sqrt(-2 ln R) finite when headings cancel out completely
+static constexpr double MIN_RESULTANT = 1e-12;
+
+// Small windows still rebuild their sums only this rarely
+static constexpr size_t REBUILD_MIN_REMOVALS = size_t(1) << 16;
+
+// Samples added to the rebuilt sums per push: a one hour window at 400 Hz
+// is rebuilt in about four minutes, a few microseconds per push
+static constexpr size_t REBUILD_STEP = 16;
+
+// Recycled blocks kept after the window shrinks
+static constexpr size_t MAX_SPARE_BLOCKS = 4;
+
+// ============================================================================
+// Welford accumulator
+// ============================================================================
+
+void AttitudeHistory::Welford::add(double x)
+{
+  count += 1.0;
+  const double delta = x - mean;
+  mean += delta / count;
+  m2 += delta * (x - mean);
+}
+
+void AttitudeHistory::Welford::remove(double x)
+{
+  if (count <= 1.0) {
+    *this = Welford();
+    return;
+  }
+  // Inverse of add(): recover the mean without x, then take back its term
+  const double old_mean = mean;
+  count -= 1.0;
+  mean -= (x - mean) / count;
+  m2 = std::max(0.0, m2 - (x - mean) * (x - old_mean));
+}
+
+double AttitudeHistory::Welford::stddev() const
+{
+  return count > 1.0 ? std::sqrt(m2 / count) : 0.0;
+}
+
+void AttitudeHistory::Sums::add(const Angles & angles)
+{
+  roll.add(angles.roll);
+  pitch.add(angles.pitch);
+  yaw_sin += std::sin(angles.yaw);
+  yaw_cos += std::cos(angles.yaw);
+}
+
+void AttitudeHistory::Sums::remove(const Angles & angles)
+{
+  roll.remove(angles.roll);
+  pitch.remove(angles.pitch);
+  yaw_sin -= std::sin(angles.yaw);
+  yaw_cos -= std::cos(angles.yaw);
+}
+
+// ============================================================================
+// Monotonic queue
+// ============================================================================
+
+AttitudeHistory::MonotonicQueue::MonotonicQueue(bool keep_max)
+: keep_max_(keep_max),
+  entries_(BLOCK_SIZE),
+  head_(0),
+  tail_(0)
+{
+}
+
+void AttitudeHistory::MonotonicQueue::clear()
+{
+  head_ = 0;
+  tail_ = 0;
+}
+
+void AttitudeHistory::MonotonicQueue::push(uint64_t position, double value)
+{
+  const uint64_t mask = entries_.size() - 1;
+
+  // Entries the new sample dominates can never be the extreme again
+  while (tail_ != head_) {
+    const double back = entries_[(tail_ - 1) & mask].value;
+    if (keep_max_ ? back > value : back < value) {
+      break;
+    }
+    --tail_;
+  }
+  if (tail_ - head_ == entries_.size()) {
+    grow();
+  }
+  entries_[tail_ & (entries_.size() - 1)] = Entry{position, value};
+  ++tail_;
+}
+
+void AttitudeHistory::MonotonicQueue::grow()
+{
+  std::vector<Entry> grown(entries_.size() * 2);
+  const uint64_t mask = entries_.size() - 1;
+  size_t count = 0;
+  for (uint64_t i = head_; i != tail_; ++i) {
+    grown[count++] = entries_[i & mask];
+  }
+  entries_.swap(grown);
+  head_ = 0;
+  tail_ = count;
+}
+
+void AttitudeHistory::MonotonicQueue::expire(uint64_t begin)
+{
+  const uint64_t mask = entries_.size() - 1;
+  while (head_ != tail_ && entries_[head_ & mask].position < begin) {
+    ++head_;
+  }
+}
+
+double AttitudeHistory::MonotonicQueue::front() const
+{
+  return head_ != tail_ ? entries_[head_ & (entries_.size() - 1)].value : 0.0;
+}
+
+// ============================================================================
+// AttitudeHistory
+// ============================================================================
+
+AttitudeHistory::AttitudeHistory()
+: first_(0),
+  size_(0),
+  begin_(0),
+  window_ns_(static_cast<int64_t>(DEFAULT_WINDOW_S * 1e9)),
+  removals_(0),
+  rebuilding_(false),
+  rebuild_front_(0),
+  roll_min_(false),
+  roll_max_(true),
+  pitch_min_(false),
+  pitch_max_(true)
+{
+}
+
+void AttitudeHistory::setWindow(double seconds)
+{
+  window_ns_ = std::llround(std::clamp(seconds, 1e-3, MAX_WINDOW_S) * 1e9);
+  if (size_ == 0) {
+    return;
+  }
+  size_t offset = 0;
+  const Block & newest = blockAt(size_ - 1, offset);
+  const int64_t cutoff = newest.time(offset) - window_ns_;
+  while (size_ > 1 && blocks_.front()->time(first_) < cutoff) {
+    evictOldest();
+  }
+}
+
+void AttitudeHistory::clear()
+{
+  while (!blocks_.empty()) {
+    if (spare_blocks_.size() < MAX_SPARE_BLOCKS) {
+      spare_blocks_.push_back(std::move(blocks_.front()));
+    }
+    blocks_.pop_front();
+  }
+  first_ = 0;
+  size_ = 0;
+  sums_ = Sums();
+  removals_ = 0;
+  rebuilding_ = false;
+  roll_min_.clear();
+  roll_max_.clear();
+  pitch_min_.clear();
+  pitch_max_.clear();
+}
+
+void AttitudeHistory::push(int64_t time_ns, double x, double y, double z, double w)
+{
+  if (size_ > 0) {
+    const Block & newest = *blocks_.back();
+    // A step back in time (bag loop, sim reset) starts a new history
+    if (time_ns < newest.time(newest.count - 1)) {
+      clear();
+    }
+  }
+
+  // Evict before appending, so the newest block never spans more than the window
+  const int64_t cutoff = time_ns - window_ns_;
+  while (size_ > 0 && blocks_.front()->time(first_) < cutoff) {
+    evictOldest();
+  }
+  if (size_ == MAX_SAMPLES) {
+    evictOldest();
+  }
+
+  if (blocks_.empty() || blocks_.back()->count == BLOCK_SIZE) {
+    std::unique_ptr<Block> block;
+    if (!spare_blocks_.empty()) {
+      block = std::move(spare_blocks_.back());
+      spare_blocks_.pop_back();
+    } else {
+      block = std::make_unique<Block>();
+    }
+    block->base_ns = time_ns;
+    block->count = 0;
+    blocks_.push_back(std::move(block));
+  }
+
+  Block & block = *blocks_.back();
+  if ((time_ns - block.base_ns) / 1000 > UINT32_MAX) {
+    // Only a front block whose base sample was evicted gets here; its
+    // remaining samples are inside the window, so rebasing on them fits
+    const uint32_t shift = block.offset_us[first_];
+    for (size_t j = first_; j < block.count; ++j) {
+      block.offset_us[j] -= shift;
+    }
+    block.base_ns += int64_t(shift) * 1000;
+  }
+  const size_t i = block.count++;
+  // Rounded down, so decoded times never run ahead of the next raw stamp
+  block.offset_us[i] = static_cast<uint32_t>((time_ns - block.base_ns) / 1000);
+  quaternion_codec::encode(x, y, z, w, block.a[i], block.b[i], block.c[i]);
+
+  const uint64_t position = begin_ + size_;
+  ++size_;
+
+  // Statistics see the stored (decoded) sample, so eviction removes exactly it
+  const Angles sample = angles(block, i);
+  sums_.add(sample);
+  if (rebuilding_) {
+    rebuilt_.add(sample);
+    continueRebuild(REBUILD_STEP);
+  }
+  roll_min_.push(position, sample.roll);
+  roll_max_.push(position, sample.roll);
+  pitch_min_.push(position, sample.pitch);
+  pitch_max_.push(position, sample.pitch);
+}
+
+AttitudeHistory::Angles AttitudeHistory::angles(const Block & block, size_t i) const
+{
+  float x, y, z, w;
+  quaternion_codec::decode(block.a[i], block.b[i], block.c[i], x, y, z, w);
+  Angles result;
+  converter_.convert(x, y, z, w, result.roll, result.pitch, result.yaw);
+  return result;
+}
+
+const AttitudeHistory::Block & AttitudeHistory::blockAt(size_t index, size_t & offset) const
+{
+  // Every block but the newest is full, and the oldest starts at first_
+  const size_t slot = first_ + index;
+  offset = slot % BLOCK_SIZE;
+  return *blocks_[slot / BLOCK_SIZE];
+}
+
+void AttitudeHistory::evictOldest()
+{
+  // rebuilt_ never holds the oldest sample; it is swapped in when it would
+  sums_.remove(angles(*blocks_.front(), first_));
+
+  ++begin_;
+  --size_;
+  if (++first_ == blocks_.front()->count) {
+    if (spare_blocks_.size() < MAX_SPARE_BLOCKS) {
+      spare_blocks_.push_back(std::move(blocks_.front()));
+    }
+    blocks_.pop_front();
+    first_ = 0;
+  }
+
+  roll_min_.expire(begin_);
+  roll_max_.expire(begin_);
+  pitch_min_.expire(begin_);
+  pitch_max_.expire(begin_);
+
+  // Rebuilding adds size samples and starts after at least size removals,
+  // so it is O(1) amortized; spreading it over later pushes keeps every
+  // single push short as well
+  ++removals_;
+  if (!rebuilding_ && removals_ >= std::max(size_, REBUILD_MIN_REMOVALS)) {
+    rebuilt_ = Sums();
+    rebuilding_ = true;
+    rebuild_front_ = begin_ + size_;
+  }
+  if (rebuilding_) {
+    continueRebuild(0);
+  }
+}
+
+void AttitudeHistory::continueRebuild(size_t count)
+{
+  for (; count > 0 && rebuild_front_ > begin_; --count) {
+    --rebuild_front_;
+    size_t offset = 0;
+    const Block & block = blockAt(static_cast<size_t>(rebuild_front_ - begin_), offset);
+    rebuilt_.add(angles(block, offset));
+  }
+  if (rebuild_front_ == begin_) {
+    sums_ = rebuilt_;
+    rebuilding_ = false;
+    removals_ = 0;
+  }
+}
+
+AttitudeStats AttitudeHistory::stats() const
+{
+  AttitudeStats stats;
+  stats.count = size_;
+  if (size_ == 0) {
+    return stats;
+  }
+
+  const Block & newest = *blocks_.back();
+  stats.span_s = (newest.time(newest.count - 1) - blocks_.front()->time(first_)) * 1e-9;
+
+  stats.roll_mean = sums_.roll.mean;
+  stats.roll_stddev = sums_.roll.stddev();
+  stats.roll_min = roll_min_.front();
+  stats.roll_max = roll_max_.front();
+
+  stats.pitch_mean = sums_.pitch.mean;
+  stats.pitch_stddev = sums_.pitch.stddev();
+  stats.pitch_min = pitch_min_.front();
+  stats.pitch_max = pitch_max_.front();
+
+  const double resultant = std::min(
+    1.0, std::hypot(sums_.yaw_sin, sums_.yaw_cos) / static_cast<double>(size_));
+  stats.yaw_mean = std::atan2(sums_.yaw_sin, sums_.yaw_cos);
+  stats.yaw_resultant = resultant;
+  stats.yaw_stddev = std::sqrt(-2.0 * std::log(std::max(resultant, MIN_RESULTANT)));
+  return stats;
+}
+
+size_t AttitudeHistory::lowerBound(int64_t time_ns) const
+{
+  size_t low = 0;
+  size_t high = size_;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    size_t offset = 0;
+    if (blockAt(middle, offset).time(offset) < time_ns) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+size_t AttitudeHistory::read(
+  size_t first, size_t count, int64_t * time_ns,
+  float * x, float * y, float * z, float * w) const
+{
+  if (first >= size_) {
+    return 0;
+  }
+  count = std::min(count, size_ - first);
+
+  size_t written = 0;
+  while (written < count) {
+    size_t offset = 0;
+    const Block & block = blockAt(first + written, offset);
+    const size_t n = std::min(count - written, block.count - offset);
+    quaternion_codec::decode(
+      block.a.data() + offset, block.b.data() + offset, block.c.data() + offset, n,
+      x + written, y + written, z + written, w + written);
+    for (size_t i = 0; i < n; ++i) {
+      time_ns[written + i] = block.time(offset + i);
+    }
+    written += n;
+  }
+  return written;
+}
+
+}  // namespace rviz_attitude_plugin
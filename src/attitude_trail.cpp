@@ -0,0 +1,249 @@
+#include "rviz_attitude_plugin/attitude_trail.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+
+#include <OgreCamera.h>
+#include <OgreHardwareBufferManager.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreSimpleRenderable.h>
+#include <OgreTechnique.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+namespace rviz_attitude_plugin
+{
+
+static constexpr size_t DEFAULT_CAPACITY = 1000;
+static constexpr float DEFAULT_TICK_LENGTH = 0.2f;
+
+// Packed VET_COLOUR_ABGR: red in the low byte
+static constexpr uint32_t PATH_COLOUR = 0xffb0b0b0u;
+static constexpr uint32_t X_COLOUR = 0xff4444f0u;
+static constexpr uint32_t Y_COLOUR = 0xff44d044u;
+static constexpr uint32_t Z_COLOUR = 0xfff08844u;
+
+// ============================================================================
+// Renderable - the ring buffer as a line list
+// ============================================================================
+
+class AttitudeTrail::Renderable : public Ogre::SimpleRenderable
+{
+public:
+  explicit Renderable(const std::string & name)
+  : Ogre::SimpleRenderable(name)
+  {
+    mRenderOp.operationType = Ogre::RenderOperation::OT_LINE_LIST;
+    mRenderOp.useIndexes = false;
+    mRenderOp.vertexData = new Ogre::VertexData();
+    Ogre::VertexDeclaration * decl = mRenderOp.vertexData->vertexDeclaration;
+    decl->addElement(0, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+    decl->addElement(
+      0, Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3),
+      Ogre::VET_COLOUR_ABGR, Ogre::VES_DIFFUSE);
+    setBoundingBox(Ogre::AxisAlignedBox::BOX_NULL);
+  }
+
+  ~Renderable() override
+  {
+    delete mRenderOp.vertexData;
+  }
+
+  /**
+   * @brief Allocate room for vertex_count vertices; nothing is drawn until written.
+   */
+  void allocate(size_t vertex_count)
+  {
+    buffer_ = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
+      sizeof(Vertex), vertex_count, Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+    mRenderOp.vertexData->vertexBufferBinding->setBinding(0, buffer_);
+    mRenderOp.vertexData->vertexStart = 0;
+    mRenderOp.vertexData->vertexCount = 0;
+    setBoundingBox(Ogre::AxisAlignedBox::BOX_NULL);
+  }
+
+  void write(size_t first_vertex, const Vertex * vertices, size_t count)
+  {
+    buffer_->writeData(
+      first_vertex * sizeof(Vertex), count * sizeof(Vertex), vertices, false);
+  }
+
+  void setDrawCount(size_t vertex_count)
+  {
+    mRenderOp.vertexData->vertexCount = vertex_count;
+  }
+
+  void grow(const Ogre::AxisAlignedBox & box)
+  {
+    mBox.merge(box);
+  }
+
+  Ogre::Real getSquaredViewDepth(const Ogre::Camera * camera) const override
+  {
+    const Ogre::SceneNode * node = getParentSceneNode();
+    return node ? node->getSquaredViewDepth(camera) : 0.0f;
+  }
+
+  Ogre::Real getBoundingRadius() const override
+  {
+    return mBox.isFinite() ?
+           std::max(mBox.getMaximum().length(), mBox.getMinimum().length()) : 0.0f;
+  }
+
+private:
+  Ogre::HardwareVertexBufferSharedPtr buffer_;
+};
+
+// ============================================================================
+// AttitudeTrail
+// ============================================================================
+
+AttitudeTrail::AttitudeTrail(Ogre::SceneManager * scene_manager, Ogre::SceneNode * parent)
+: scene_manager_(scene_manager),
+  node_(nullptr),
+  capacity_(0),
+  size_(0),
+  head_(0),
+  pending_samples_(0),
+  last_position_(Ogre::Vector3::ZERO),
+  tick_length_(DEFAULT_TICK_LENGTH),
+  visible_(true)
+{
+  static std::atomic<int> trail_count{0};
+  const std::string name = "AttitudeTrail" + std::to_string(trail_count++);
+
+  // Unlit and coloured per vertex, like the glyphs
+  material_ = Ogre::MaterialManager::getSingleton().create(
+    name + "Material", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  Ogre::Pass * pass = material_->getTechnique(0)->getPass(0);
+  pass->setLightingEnabled(false);
+  pass->setVertexColourTracking(Ogre::TVC_DIFFUSE);
+
+  renderable_ = std::make_unique<Renderable>(name);
+  renderable_->setMaterial(material_);
+  renderable_->setVisible(false);
+  node_ = (parent ? parent : scene_manager_->getRootSceneNode())->createChildSceneNode();
+  node_->attachObject(renderable_.get());
+
+  setCapacity(DEFAULT_CAPACITY);
+}
+
+AttitudeTrail::~AttitudeTrail()
+{
+  if (node_) {
+    node_->detachAllObjects();
+    scene_manager_->destroySceneNode(node_);
+  }
+  renderable_.reset();
+  if (material_) {
+    material_->unload();
+    Ogre::MaterialManager::getSingleton().remove(material_->getName());
+  }
+}
+
+void AttitudeTrail::setCapacity(size_t samples)
+{
+  samples = std::clamp<size_t>(samples, 1, MAX_CAPACITY);
+  if (samples != capacity_) {
+    capacity_ = samples;
+    renderable_->allocate(capacity_ * VERTICES_PER_SAMPLE);
+  }
+  clear();
+}
+
+void AttitudeTrail::setVisible(bool visible)
+{
+  visible_ = visible;
+  renderable_->setVisible(visible_ && size_ > 0);
+}
+
+void AttitudeTrail::clear()
+{
+  size_ = 0;
+  head_ = 0;
+  pending_.clear();
+  pending_samples_ = 0;
+  renderable_->setDrawCount(0);
+  renderable_->setBoundingBox(Ogre::AxisAlignedBox::BOX_NULL);
+  renderable_->setVisible(false);
+}
+
+void AttitudeTrail::push(const Ogre::Vector3 & position, const Ogre::Quaternion & orientation)
+{
+  // Frames that cannot keep up only ever need the newest capacity_ samples;
+  // dropping the older half at once keeps this O(1) amortized
+  if (pending_samples_ == 2 * capacity_) {
+    pending_.erase(pending_.begin(), pending_.begin() + capacity_ * VERTICES_PER_SAMPLE);
+    pending_samples_ = capacity_;
+  }
+
+  // The first sample after a clear has a zero-length path segment
+  const Ogre::Vector3 & from = (size_ == 0 && pending_samples_ == 0) ? position : last_position_;
+  const Ogre::Vector3 axes[3] = {
+    orientation.xAxis() * tick_length_,
+    orientation.yAxis() * tick_length_,
+    orientation.zAxis() * tick_length_,
+  };
+  const auto vertex = [](const Ogre::Vector3 & p, uint32_t colour) {
+      return Vertex{p.x, p.y, p.z, colour};
+    };
+  pending_.push_back(vertex(from, PATH_COLOUR));
+  pending_.push_back(vertex(position, PATH_COLOUR));
+  pending_.push_back(vertex(position, X_COLOUR));
+  pending_.push_back(vertex(position + axes[0], X_COLOUR));
+  pending_.push_back(vertex(position, Y_COLOUR));
+  pending_.push_back(vertex(position + axes[1], Y_COLOUR));
+  pending_.push_back(vertex(position, Z_COLOUR));
+  pending_.push_back(vertex(position + axes[2], Z_COLOUR));
+  ++pending_samples_;
+  last_position_ = position;
+}
+
+bool AttitudeTrail::flush()
+{
+  if (pending_samples_ == 0) {
+    return false;
+  }
+  ATTITUDE_PROFILE_SCOPE("AttitudeTrail::flush");
+
+  // Only the newest capacity_ samples survive; older pending ones are skipped
+  const size_t samples = std::min(pending_samples_, capacity_);
+  const Vertex * vertices =
+    pending_.data() + (pending_samples_ - samples) * VERTICES_PER_SAMPLE;
+
+  // At most two writes: up to the end of the ring, then from its start
+  const size_t first = std::min(samples, capacity_ - head_);
+  writeSlots(head_, vertices, first);
+  if (samples > first) {
+    writeSlots(0, vertices + first * VERTICES_PER_SAMPLE, samples - first);
+  }
+
+  // The bounds only grow; overwritten samples leave them loose until clear()
+  Ogre::AxisAlignedBox box;
+  for (size_t i = 0; i < samples * VERTICES_PER_SAMPLE; ++i) {
+    box.merge(Ogre::Vector3(vertices[i].x, vertices[i].y, vertices[i].z));
+  }
+  renderable_->grow(box);
+
+  head_ = (head_ + samples) % capacity_;
+  size_ = std::min(size_ + samples, capacity_);
+  pending_.clear();
+  pending_samples_ = 0;
+
+  // Segments are independent, so the filled prefix draws in any order
+  renderable_->setDrawCount(size_ * VERTICES_PER_SAMPLE);
+  renderable_->setVisible(visible_);
+  node_->needUpdate();
+  return true;
+}
+
+void AttitudeTrail::writeSlots(size_t first_slot, const Vertex * vertices, size_t samples)
+{
+  renderable_->write(
+    first_slot * VERTICES_PER_SAMPLE, vertices, samples * VERTICES_PER_SAMPLE);
+}
+
+}  // namespace rviz_attitude_plugin
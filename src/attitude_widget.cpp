@@ -4,13 +4,19 @@
  */
 
 #include "rviz_attitude_plugin/attitude_widget.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
 #include "rviz_attitude_plugin/euler_converter.hpp"
 #include "rviz_attitude_plugin/widgets/attitude_indicator.hpp"
 #include "rviz_attitude_plugin/widgets/heading_indicator.hpp"
 #include "rviz_attitude_plugin/widgets/angle_readout.hpp"
+#include "rviz_attitude_plugin/widgets/perf_strip.hpp"
+#include "rviz_attitude_plugin/widgets/spectrum_panel.hpp"
+#include "rviz_attitude_plugin/widgets/stats_readout.hpp"
+#include "rviz_attitude_plugin/widgets/tape_indicator.hpp"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QGridLayout>
 #include <QLabel>
 #include <QSizePolicy>
 #include <QPainter>
@@ -30,12 +36,23 @@ CapsuleFrame::CapsuleFrame(QWidget * parent)
   setAttribute(Qt::WA_TranslucentBackground, true);
 }
 
+ComponentFrame CapsuleFrame::frame() const
+{
+  return [size = size()](QPainter & painter) {paintCapsule(painter, size);};
+}
+
 void CapsuleFrame::paintEvent(QPaintEvent * /*event*/)
 {
-  QPainter p(this);
+  QPainter painter(this);
+  paintCapsule(painter, size());
+}
+
+void CapsuleFrame::paintCapsule(QPainter & p, const QSize & size)
+{
+  ATTITUDE_PROFILE_SCOPE("CapsuleFrame::paintCapsule");
   p.setRenderHint(QPainter::Antialiasing, true);
 
-  QRectF rf = rect();
+  QRectF rf(QPointF(0, 0), QSizeF(size));
   rf.adjust(1.0, 1.0, -1.0, -1.0);
 
   // Stadium capsule across the full frame
@@ -63,9 +80,16 @@ AttitudeWidget::AttitudeWidget(QWidget * parent)
   show_pitch_ladder_(true),
   show_roll_indicator_(true),
   show_heading_text_(true),
+  show_tapes_(false),
+  show_statistics_(false),
+  show_spectrum_(false),
+  show_performance_(false),
   display_unit_("deg"),
   angles_rad_{{0.0, 0.0, 0.0}},
-  angles_deg_{{0.0, 0.0, 0.0}}
+  angles_deg_{{0.0, 0.0, 0.0}},
+  readout_values_{{0, 0, 0}},
+  readouts_valid_(false),
+  dirty_components_(ALL_HUD_COMPONENTS)
 {
   buildUI();
 }
@@ -80,6 +104,8 @@ void AttitudeWidget::buildUI()
 
   layout->addWidget(buildIndicatorFrame());
   layout->addWidget(buildReadoutFrame());
+  layout->addWidget(buildSpectrumPanel());
+  layout->addWidget(buildPerfStrip());
   layout->addStretch(1);
 
 }
@@ -96,13 +122,20 @@ void AttitudeWidget::setUnit(const std::string & unit)
     return;
   }
   display_unit_ = unit;
+  readouts_valid_ = false;
+  markDirty(
+    componentBit(HudComponent::RollReadout) |
+    componentBit(HudComponent::PitchReadout) |
+    componentBit(HudComponent::YawReadout));
   refreshReadouts();
+  refreshStatistics();
 }
 
 void AttitudeWidget::setDisplayMode(DisplayMode mode)
 {
   display_mode_ = mode;
   updateDisplayMode();
+  markDirty(ALL_HUD_COMPONENTS);
 }
 
 void AttitudeWidget::setShowPitchLadder(bool show)
@@ -111,6 +144,7 @@ void AttitudeWidget::setShowPitchLadder(bool show)
   if (attitude_indicator_) {
     attitude_indicator_->setShowPitchLadder(show);
   }
+  markDirty(componentBit(HudComponent::Attitude));
 }
 
 void AttitudeWidget::setShowRollIndicator(bool show)
@@ -119,6 +153,7 @@ void AttitudeWidget::setShowRollIndicator(bool show)
   if (attitude_indicator_) {
     attitude_indicator_->setShowRollIndicator(show);
   }
+  markDirty(componentBit(HudComponent::Attitude));
 }
 
 void AttitudeWidget::setShowHeadingText(bool show)
@@ -127,6 +162,111 @@ void AttitudeWidget::setShowHeadingText(bool show)
   // Heading text visibility can be implemented in HeadingIndicator if needed
 }
 
+void AttitudeWidget::setPreRotatedCompass(bool enabled)
+{
+  heading_->setRoseCacheMode(
+    enabled ?
+    widgets::HeadingIndicator::RoseCacheMode::PreRotated :
+    widgets::HeadingIndicator::RoseCacheMode::RotatedBlit);
+  markDirty(componentBit(HudComponent::Heading));
+}
+
+void AttitudeWidget::setShowTapes(bool show)
+{
+  show_tapes_ = show;
+  for (auto * tape : {speed_tape_, altitude_tape_}) {
+    tape->clearValue();
+    tape->setVisible(show);
+  }
+  markDirty(
+    componentBit(HudComponent::SpeedTape) |
+    componentBit(HudComponent::AltitudeTape));
+}
+
+void AttitudeWidget::setSpeed(double speed)
+{
+  if (speed_tape_->setValue(speed)) {
+    markDirty(componentBit(HudComponent::SpeedTape));
+  }
+}
+
+void AttitudeWidget::setAltitude(double altitude)
+{
+  if (altitude_tape_->setValue(altitude)) {
+    markDirty(componentBit(HudComponent::AltitudeTape));
+  }
+}
+
+void AttitudeWidget::clearSpeed()
+{
+  if (speed_tape_->clearValue()) {
+    markDirty(componentBit(HudComponent::SpeedTape));
+  }
+}
+
+void AttitudeWidget::clearAltitude()
+{
+  if (altitude_tape_->clearValue()) {
+    markDirty(componentBit(HudComponent::AltitudeTape));
+  }
+}
+
+void AttitudeWidget::setShowStatistics(bool show)
+{
+  show_statistics_ = show;
+  for (auto * readout : {roll_stats_, pitch_stats_, yaw_stats_}) {
+    if (readout) {
+      readout->setVisible(show);
+    }
+  }
+  statistics_ = AttitudeStats();
+  refreshStatistics();
+  markDirty(
+    componentBit(HudComponent::RollStats) |
+    componentBit(HudComponent::PitchStats) |
+    componentBit(HudComponent::YawStats));
+}
+
+void AttitudeWidget::setStatistics(const AttitudeStats & stats)
+{
+  statistics_ = stats;
+  refreshStatistics();
+}
+
+void AttitudeWidget::setShowSpectrum(bool show)
+{
+  show_spectrum_ = show;
+  if (spectrum_panel_) {
+    spectrum_panel_->setVisible(show);
+    spectrum_panel_->setResult(SpectrumResult());
+  }
+  markDirty(componentBit(HudComponent::Spectrum));
+}
+
+void AttitudeWidget::setSpectrum(const SpectrumResult & result)
+{
+  if (spectrum_panel_) {
+    spectrum_panel_->setResult(result);
+    markDirty(componentBit(HudComponent::Spectrum));
+  }
+}
+
+void AttitudeWidget::setShowPerformance(bool show)
+{
+  show_performance_ = show;
+  if (perf_strip_) {
+    perf_strip_->setVisible(show);
+  }
+  markDirty(componentBit(HudComponent::Perf));
+}
+
+void AttitudeWidget::setPerfSnapshot(const PerfSnapshot & snapshot)
+{
+  if (perf_strip_ && perf_strip_->setSnapshot(snapshot)) {
+    markDirty(componentBit(HudComponent::Perf));
+  }
+}
+
 void AttitudeWidget::updateDisplayMode()
 {
   if (readout_frame_) {
@@ -136,6 +276,7 @@ void AttitudeWidget::updateDisplayMode()
 
 void AttitudeWidget::updateAngles(double roll_rad, double pitch_rad, double yaw_rad)
 {
+  ATTITUDE_PROFILE_SCOPE("AttitudeWidget::updateAngles");
   angles_rad_[0] = roll_rad;
   angles_rad_[1] = pitch_rad;
   angles_rad_[2] = yaw_rad;
@@ -144,19 +285,160 @@ void AttitudeWidget::updateAngles(double roll_rad, double pitch_rad, double yaw_
   angles_deg_[1] = pitch_rad * 180.0 / M_PI;
   angles_deg_[2] = yaw_rad * 180.0 / M_PI;
 
-  attitude_indicator_->setAttitude(angles_deg_[1], angles_deg_[0]);
-  heading_->setHeading(angles_deg_[2]);
+  // Sub-pixel motion and unchanged readout digits are not repainted
+  if (attitude_indicator_->setAttitude(angles_deg_[1], angles_deg_[0])) {
+    markDirty(componentBit(HudComponent::Attitude));
+  }
+  if (heading_->setHeading(angles_deg_[2])) {
+    markDirty(componentBit(HudComponent::Heading));
+  }
   refreshReadouts();
 }
 
 void AttitudeWidget::refreshReadouts()
 {
-  const auto & values = (display_unit_ == "deg") ? angles_deg_ : angles_rad_;
-  const QString suffix = (display_unit_ == "deg") ? "°" : "";
+  const bool degrees = display_unit_ == "deg";
+  const auto & values = degrees ? angles_deg_ : angles_rad_;
+  const QString suffix = degrees ? "°" : "";
+  // Readouts show one decimal in degrees and three in radians
+  const double resolution = degrees ? 10.0 : 1000.0;
+
+  widgets::AngleReadout * readouts[3] = {roll_readout_, pitch_readout_, yaw_readout_};
+  const HudComponent components[3] = {
+    HudComponent::RollReadout, HudComponent::PitchReadout, HudComponent::YawReadout};
+
+  for (size_t i = 0; i < 3; ++i) {
+    const long long quantized = std::llround(values[i] * resolution);
+    if (readouts_valid_ && quantized == readout_values_[i]) {
+      continue;
+    }
+    readout_values_[i] = quantized;
+    if (readouts[i]->setValue(formatValue(values[i], suffix))) {
+      markDirty(componentBit(components[i]));
+    }
+  }
+  readouts_valid_ = true;
+}
+
+void AttitudeWidget::refreshStatistics()
+{
+  const bool degrees = display_unit_ == "deg";
+  const double scale = degrees ? 180.0 / M_PI : 1.0;
+  const int precision = degrees ? 1 : 3;
+  auto number = [&](double value, bool sign) {
+      const QString text = QString::number(value * scale, 'f', precision);
+      return sign && value * scale >= 0.0 ? "+" + text : text;
+    };
+
+  const AttitudeStats & s = statistics_;
+  QString lines[3][2];
+  if (s.count == 0) {
+    for (auto & axis : lines) {
+      axis[0] = "avg --";
+      axis[1] = "min -- max --";
+    }
+  } else {
+    const double linear[2][4] = {
+      {s.roll_mean, s.roll_stddev, s.roll_min, s.roll_max},
+      {s.pitch_mean, s.pitch_stddev, s.pitch_min, s.pitch_max},
+    };
+    for (size_t i = 0; i < 2; ++i) {
+      lines[i][0] = QString("avg %1 sd %2")
+        .arg(number(linear[i][0], true), number(linear[i][1], false));
+      lines[i][1] = QString("min %1 max %2")
+        .arg(number(linear[i][2], true), number(linear[i][3], true));
+    }
+    // Yaw wraps, so its spread is the circular deviation and R
+    lines[2][0] = QString("avg %1 sd %2")
+      .arg(number(s.yaw_mean, true), number(s.yaw_stddev, false));
+    lines[2][1] = QString("R %1 %2s").arg(s.yaw_resultant, 0, 'f', 3).arg(s.span_s, 0, 'f', 1);
+  }
 
-  roll_readout_->setValue(formatValue(values[0], suffix));
-  pitch_readout_->setValue(formatValue(values[1], suffix));
-  yaw_readout_->setValue(formatValue(values[2], suffix));
+  widgets::StatsReadout * readouts[3] = {roll_stats_, pitch_stats_, yaw_stats_};
+  const HudComponent components[3] = {
+    HudComponent::RollStats, HudComponent::PitchStats, HudComponent::YawStats};
+  for (size_t i = 0; i < 3; ++i) {
+    if (readouts[i]->setLines(lines[i][0], lines[i][1])) {
+      markDirty(componentBit(components[i]));
+    }
+  }
+}
+
+QWidget * AttitudeWidget::componentWidget(HudComponent component) const
+{
+  switch (component) {
+    case HudComponent::Background:
+      return indicator_frame_;
+    case HudComponent::Heading:
+      return heading_;
+    case HudComponent::Attitude:
+      return attitude_indicator_;
+    case HudComponent::SpeedTape:
+      return speed_tape_;
+    case HudComponent::AltitudeTape:
+      return altitude_tape_;
+    case HudComponent::RollReadout:
+      return roll_readout_;
+    case HudComponent::PitchReadout:
+      return pitch_readout_;
+    case HudComponent::YawReadout:
+      return yaw_readout_;
+    case HudComponent::RollStats:
+      return roll_stats_;
+    case HudComponent::PitchStats:
+      return pitch_stats_;
+    case HudComponent::YawStats:
+      return yaw_stats_;
+    case HudComponent::Spectrum:
+      return spectrum_panel_;
+    case HudComponent::Perf:
+      return perf_strip_;
+    case HudComponent::Count:
+      break;
+  }
+  return nullptr;
+}
+
+widgets::ComponentFrame AttitudeWidget::componentFrame(HudComponent component)
+{
+  switch (component) {
+    case HudComponent::Background:
+      return indicator_frame_->frame();
+    case HudComponent::Heading:
+      return heading_->frame();
+    case HudComponent::Attitude:
+      return attitude_indicator_->frame();
+    case HudComponent::SpeedTape:
+      return speed_tape_->frame();
+    case HudComponent::AltitudeTape:
+      return altitude_tape_->frame();
+    case HudComponent::RollReadout:
+      return roll_readout_->frame();
+    case HudComponent::PitchReadout:
+      return pitch_readout_->frame();
+    case HudComponent::YawReadout:
+      return yaw_readout_->frame();
+    case HudComponent::RollStats:
+      return roll_stats_->frame();
+    case HudComponent::PitchStats:
+      return pitch_stats_->frame();
+    case HudComponent::YawStats:
+      return yaw_stats_->frame();
+    case HudComponent::Spectrum:
+      return spectrum_panel_->frame();
+    case HudComponent::Perf:
+      return perf_strip_->frame();
+    case HudComponent::Count:
+      break;
+  }
+  return widgets::ComponentFrame();
+}
+
+unsigned int AttitudeWidget::takeDirtyComponents()
+{
+  const unsigned int dirty = dirty_components_;
+  dirty_components_ = 0;
+  return dirty;
 }
 
 QString AttitudeWidget::formatValue(double value, const QString & suffix) const
@@ -179,12 +461,24 @@ QWidget * AttitudeWidget::buildIndicatorFrame()
   heading_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
   layout->addWidget(heading_);
 
+  // Speed tape | attitude | altitude tape, as on a primary flight display
+  speed_tape_ = new widgets::TapeIndicator("SPD", widgets::TapeIndicator::Side::Left);
+  speed_tape_->setScale(40.0, 1.0, 5, 1);   // m/s
+  speed_tape_->setMinimum(0.0);
+  speed_tape_->setVisible(show_tapes_);
+  layout->addWidget(speed_tape_);
+
   attitude_indicator_ = new widgets::AttitudeIndicator();
   attitude_indicator_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
   attitude_indicator_->setShowPitchLadder(show_pitch_ladder_);
   attitude_indicator_->setShowRollIndicator(show_roll_indicator_);
   layout->addWidget(attitude_indicator_);
 
+  altitude_tape_ = new widgets::TapeIndicator("ALT", widgets::TapeIndicator::Side::Right);
+  altitude_tape_->setScale(100.0, 2.0, 5, 1);   // m
+  altitude_tape_->setVisible(show_tapes_);
+  layout->addWidget(altitude_tape_);
+
   indicator_container_ = indicator_frame_;
   return indicator_frame_;
 }
@@ -192,7 +486,7 @@ QWidget * AttitudeWidget::buildIndicatorFrame()
 QWidget * AttitudeWidget::buildReadoutFrame()
 {
   readout_frame_ = new QWidget(this);
-  auto * layout = new QHBoxLayout(readout_frame_);
+  auto * layout = new QGridLayout(readout_frame_);
   layout->setContentsMargins(2, 2, 2, 2);
   layout->setSpacing(0);
 
@@ -200,12 +494,39 @@ QWidget * AttitudeWidget::buildReadoutFrame()
   pitch_readout_ = new widgets::AngleReadout("Pitch", "#BBF7D0");
   yaw_readout_ = new widgets::AngleReadout("Yaw", "#FBCFE8");
 
+  int column = 0;
   for (auto * widget : {roll_readout_, pitch_readout_, yaw_readout_}) {
     widget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    layout->addWidget(widget);
+    layout->addWidget(widget, 0, column++);
   }
 
+  // Statistics sit in a second row, each under the readout it describes
+  roll_stats_ = new widgets::StatsReadout("#7DD3FC");
+  pitch_stats_ = new widgets::StatsReadout("#BBF7D0");
+  yaw_stats_ = new widgets::StatsReadout("#FBCFE8");
+
+  column = 0;
+  for (auto * widget : {roll_stats_, pitch_stats_, yaw_stats_}) {
+    widget->setVisible(show_statistics_);
+    layout->addWidget(widget, 1, column++);
+  }
+  refreshStatistics();
+
   return readout_frame_;
 }
 
+QWidget * AttitudeWidget::buildSpectrumPanel()
+{
+  spectrum_panel_ = new widgets::SpectrumPanel(this);
+  spectrum_panel_->setVisible(show_spectrum_);
+  return spectrum_panel_;
+}
+
+QWidget * AttitudeWidget::buildPerfStrip()
+{
+  perf_strip_ = new widgets::PerfStrip(this);
+  perf_strip_->setVisible(show_performance_);
+  return perf_strip_;
+}
+
 }  // namespace rviz_attitude_plugin
@@ -0,0 +1,239 @@
+#include "rviz_attitude_plugin/glyph_batch.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+
+#include <OgreManualObject.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreRoot.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreTechnique.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <string>
+
+namespace rviz_attitude_plugin
+{
+
+// A glyph turns amber at this fraction of a roll/pitch limit
+static constexpr double CAUTION_FRACTION = 0.75;
+
+namespace
+{
+
+struct GlyphVertex
+{
+  float x, y, z;   // body frame (x forward, y left, z up), unit length
+  float shade;     // multiplies the alarm colour
+};
+
+// Airplane as a triangle list: fuselage, wing, tailplane, fin on top
+constexpr GlyphVertex GLYPH_VERTICES[] = {
+  // Fuselage, vertical sliver so it shows edge-on
+  {0.50f, 0.00f, 0.00f, 1.0f}, {-0.50f, 0.00f, 0.05f, 0.8f}, {-0.50f, 0.00f, -0.05f, 0.8f},
+  // Wing
+  {0.20f, 0.00f, 0.00f, 1.0f}, {-0.15f, 0.50f, 0.00f, 0.9f}, {-0.15f, -0.50f, 0.00f, 0.9f},
+  // Tailplane
+  {-0.32f, 0.00f, 0.00f, 0.9f}, {-0.50f, 0.20f, 0.00f, 0.8f}, {-0.50f, -0.20f, 0.00f, 0.8f},
+  // Fin, marking which side is up
+  {-0.30f, 0.00f, 0.00f, 0.7f}, {-0.50f, 0.00f, 0.00f, 0.6f}, {-0.50f, 0.00f, 0.22f, 0.6f},
+};
+
+constexpr size_t GLYPH_VERTEX_COUNT = sizeof(GLYPH_VERTICES) / sizeof(GLYPH_VERTICES[0]);
+
+}  // namespace
+
+AttitudeAlarm classifyAttitude(double roll, double pitch, double roll_limit, double pitch_limit)
+{
+  // Fraction of the nearest limit; a non-positive limit never trips
+  double fraction = 0.0;
+  if (roll_limit > 0.0) {
+    fraction = std::max(fraction, std::abs(roll) / roll_limit);
+  }
+  if (pitch_limit > 0.0) {
+    fraction = std::max(fraction, std::abs(pitch) / pitch_limit);
+  }
+
+  if (fraction >= 1.0) {
+    return AttitudeAlarm::Alarm;
+  }
+  return fraction >= CAUTION_FRACTION ? AttitudeAlarm::Caution : AttitudeAlarm::Normal;
+}
+
+std::shared_ptr<GlyphBatch> GlyphBatch::acquire(Ogre::SceneManager * scene_manager)
+{
+  static std::weak_ptr<GlyphBatch> instance;
+  auto batch = instance.lock();
+  if (!batch && scene_manager) {
+    batch = std::shared_ptr<GlyphBatch>(new GlyphBatch(scene_manager));
+    instance = batch;
+  }
+  return batch;
+}
+
+GlyphBatch::GlyphBatch(Ogre::SceneManager * scene_manager)
+: scene_manager_(scene_manager),
+  node_(nullptr),
+  object_(nullptr),
+  dirty_(false)
+{
+  static std::atomic<int> batch_count{0};
+  const std::string name = "AttitudeGlyphBatch" + std::to_string(batch_count++);
+
+  // Unlit, two-sided, coloured per vertex
+  material_ = Ogre::MaterialManager::getSingleton().create(
+    name + "Material", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  Ogre::Pass * pass = material_->getTechnique(0)->getPass(0);
+  pass->setLightingEnabled(false);
+  pass->setCullingMode(Ogre::CULL_NONE);
+  pass->setVertexColourTracking(Ogre::TVC_DIFFUSE);
+
+  object_ = scene_manager_->createManualObject(name);
+  object_->setDynamic(true);
+  object_->setVisible(false);
+  node_ = scene_manager_->getRootSceneNode()->createChildSceneNode();
+  node_->attachObject(object_);
+
+  if (auto * root = Ogre::Root::getSingletonPtr()) {
+    root->addFrameListener(this);
+  }
+}
+
+GlyphBatch::~GlyphBatch()
+{
+  if (auto * root = Ogre::Root::getSingletonPtr()) {
+    root->removeFrameListener(this);
+  }
+
+  if (node_) {
+    node_->detachAllObjects();
+    scene_manager_->destroySceneNode(node_);
+  }
+  if (object_) {
+    scene_manager_->destroyManualObject(object_);
+  }
+  if (material_) {
+    material_->unload();
+    Ogre::MaterialManager::getSingleton().remove(material_->getName());
+  }
+}
+
+int GlyphBatch::add()
+{
+  int glyph;
+  if (!free_slots_.empty()) {
+    glyph = free_slots_.back();
+    free_slots_.pop_back();
+  } else {
+    glyph = static_cast<int>(glyphs_.size());
+    glyphs_.emplace_back();
+  }
+  glyphs_[glyph] = Glyph();
+  glyphs_[glyph].used = true;
+  return glyph;
+}
+
+void GlyphBatch::remove(int glyph)
+{
+  if (glyph < 0 || glyph >= static_cast<int>(glyphs_.size()) || !glyphs_[glyph].used) {
+    return;
+  }
+  dirty_ = dirty_ || glyphs_[glyph].visible;
+  glyphs_[glyph] = Glyph();
+  free_slots_.push_back(glyph);
+}
+
+bool GlyphBatch::set(
+  int glyph, const Ogre::Vector3 & position, const Ogre::Quaternion & orientation,
+  float length, AttitudeAlarm alarm)
+{
+  if (glyph < 0 || glyph >= static_cast<int>(glyphs_.size()) || !glyphs_[glyph].used) {
+    return false;
+  }
+  Glyph & g = glyphs_[glyph];
+  if (g.visible && g.position == position && g.orientation == orientation &&
+    g.length == length && g.alarm == alarm)
+  {
+    return false;
+  }
+  g.visible = true;
+  g.position = position;
+  g.orientation = orientation;
+  g.length = length;
+  g.alarm = alarm;
+  dirty_ = true;
+  return true;
+}
+
+bool GlyphBatch::hide(int glyph)
+{
+  if (glyph < 0 || glyph >= static_cast<int>(glyphs_.size()) || !glyphs_[glyph].visible) {
+    return false;
+  }
+  glyphs_[glyph].visible = false;
+  dirty_ = true;
+  return true;
+}
+
+Ogre::ColourValue GlyphBatch::colour(AttitudeAlarm alarm)
+{
+  switch (alarm) {
+    case AttitudeAlarm::Caution:
+      return Ogre::ColourValue(0.98f, 0.75f, 0.14f);
+    case AttitudeAlarm::Alarm:
+      return Ogre::ColourValue(0.94f, 0.27f, 0.27f);
+    case AttitudeAlarm::Normal:
+      break;
+  }
+  return Ogre::ColourValue(0.49f, 0.83f, 0.99f);
+}
+
+void GlyphBatch::flush()
+{
+  if (!dirty_) {
+    return;
+  }
+  dirty_ = false;
+  ATTITUDE_PROFILE_SCOPE("GlyphBatch::flush");
+
+  size_t visible = 0;
+  for (const auto & glyph : glyphs_) {
+    visible += glyph.visible ? 1 : 0;
+  }
+  if (visible == 0) {
+    object_->setVisible(false);
+    return;
+  }
+
+  // One section, rewritten in place; Ogre only regrows it past the estimate
+  if (object_->getNumSections() == 0) {
+    object_->estimateVertexCount(visible * GLYPH_VERTEX_COUNT);
+    object_->begin(material_->getName(), Ogre::RenderOperation::OT_TRIANGLE_LIST);
+  } else {
+    object_->beginUpdate(0);
+  }
+
+  for (const auto & glyph : glyphs_) {
+    if (!glyph.visible) {
+      continue;
+    }
+    const Ogre::ColourValue base = colour(glyph.alarm);
+    for (const auto & vertex : GLYPH_VERTICES) {
+      const Ogre::Vector3 body(vertex.x, vertex.y, vertex.z);
+      object_->position(glyph.position + glyph.orientation * (body * glyph.length));
+      object_->colour(base.r * vertex.shade, base.g * vertex.shade, base.b * vertex.shade, 1.0f);
+    }
+  }
+  object_->end();
+  object_->setVisible(true);
+}
+
+bool GlyphBatch::frameStarted(const Ogre::FrameEvent & /*event*/)
+{
+  flush();
+  return true;
+}
+
+}  // namespace rviz_attitude_plugin
@@ -1,8 +1,14 @@
 #include "rviz_attitude_plugin/overlay_system.hpp"
+#include "rviz_attitude_plugin/perf_stats.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
 #include "rviz_attitude_plugin/attitude_widget.hpp"
+#include "rviz_attitude_plugin/render_pool.hpp"
+#include "rviz_attitude_plugin/tracing.hpp"
 
 #include <atomic>
 #include <OgreHardwarePixelBuffer.h>
+#include <OgreRoot.h>
+#include <OgreTextureUnitState.h>
 
 #include <rviz_common/display_context.hpp>
 #include <rviz_common/logging.hpp>
@@ -10,8 +16,13 @@
 #include <rviz_common/view_manager.hpp>
 #include <rviz_rendering/render_system.hpp>
 
+#include <QCoreApplication>
+#include <QFontDatabase>
 #include <QImage>
+#include <QLayout>
 #include <QPainter>
+#include <QResizeEvent>
+#include <QWidget>
 
 #include <algorithm>
 #include <cstring>
@@ -19,6 +30,17 @@
 namespace rviz_attitude_plugin
 {
 
+// Shared atlas texture: fixed width (AtlasPacker::ATLAS_WIDTH_PX), height
+// doubles on demand up to AtlasPacker::ATLAS_MAX_HEIGHT_PX
+static constexpr const char * ATLAS_NAME = "AttitudeDisplayAtlas";
+static constexpr unsigned int ATLAS_INITIAL_HEIGHT_PX = 512;
+
+// Pixels stay premultiplied from QPainter to the blend unit. PF_A8R8G8B8 is a
+// native-endian packed 0xAARRGGBB word, the same layout as a QImage
+// ARGB32 pixel on either byte order, so rows are copied without swizzling.
+static constexpr QImage::Format STAGING_FORMAT = QImage::Format_ARGB32_Premultiplied;
+static constexpr Ogre::PixelFormat ATLAS_PIXEL_FORMAT = Ogre::PF_A8R8G8B8;
+
 void OverlayGeometryManager::setGeometry(
   int width, int height,
   int offset_x, int offset_y,
@@ -102,7 +124,8 @@ ScopedPixelBuffer::ScopedPixelBuffer(const Ogre::HardwarePixelBufferSharedPtr &
 : buffer_(buffer)
 {
   if (buffer_) {
-    buffer_->lock(Ogre::HardwareBuffer::HBL_NORMAL);
+    // Write-only: the previous contents are never read back
+    buffer_->lock(Ogre::HardwareBuffer::HBL_DISCARD);
   }
 }
 
@@ -134,59 +157,79 @@ bool ScopedPixelBuffer::valid() const
   return static_cast<bool>(buffer_);
 }
 
-QImage ScopedPixelBuffer::getQImage(unsigned int width, unsigned int height)
+void ScopedPixelBuffer::clear()
 {
   if (!buffer_) {
-    return QImage();
+    return;
   }
 
   const Ogre::PixelBox & pixel_box = buffer_->getCurrentLock();
-  auto * dest = static_cast<Ogre::uint8 *>(pixel_box.data);
-  if (!dest) {
-    return QImage();
+  if (!pixel_box.data) {
+    return;
+  }
+
+  auto * dest = pixel_box.getTopLeftFrontPixelPtr();
+  const size_t bytes_per_line = pixel_box.rowPitch * 4;
+  for (size_t row = 0; row < pixel_box.getHeight(); ++row) {
+    std::memset(dest + row * bytes_per_line, 0, pixel_box.getWidth() * 4);
   }
-  // Clear to transparent
-  std::memset(dest, 0, width * height * 4);
-  return QImage(dest, width, height, QImage::Format_ARGB32);
 }
 
+// ============================================================================
+// OverlayAtlas - Implementation
+// ============================================================================
 
-OverlayPanel::OverlayPanel(const std::string & name)
-: name_(name)
+std::shared_ptr<OverlayAtlas> OverlayAtlas::acquire()
+{
+  static std::weak_ptr<OverlayAtlas> instance;
+  auto atlas = instance.lock();
+  if (!atlas) {
+    atlas = std::shared_ptr<OverlayAtlas>(new OverlayAtlas());
+    instance = atlas;
+  }
+  return atlas;
+}
+
+OverlayAtlas::OverlayAtlas()
+: overlay_(nullptr),
+  material_name_(std::string(ATLAS_NAME) + "Material"),
+  has_dirty_(false),
+  releases_(0)
 {
   auto * overlay_mgr = Ogre::OverlayManager::getSingletonPtr();
   if (!overlay_mgr) {
     RVIZ_COMMON_LOG_ERROR_STREAM("Ogre OverlayManager not available for Attitude HUD");
-    overlay_ = nullptr;
-    panel_ = nullptr;
     return;
   }
 
-  const std::string overlay_name = name_ + "Overlay";
-  const std::string panel_name = name_ + "Panel";
-  const std::string material_name = name_ + "Material";
-
-  overlay_ = overlay_mgr->create(overlay_name);
-  panel_ = static_cast<Ogre::PanelOverlayElement *>(
-    overlay_mgr->createOverlayElement("Panel", panel_name));
-  panel_->setMetricsMode(Ogre::GMM_PIXELS);
-  panel_->setHorizontalAlignment(Ogre::GHA_LEFT);
-  panel_->setVerticalAlignment(Ogre::GVA_TOP);
-
+  overlay_ = overlay_mgr->create(std::string(ATLAS_NAME) + "Overlay");
   material_ = Ogre::MaterialManager::getSingleton().create(
-    material_name,
+    material_name_,
     Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
-  panel_->setMaterialName(material_->getName());
-  overlay_->add2D(panel_);
-  overlay_->hide();
+  // Premultiplied source: dst = src + dst * (1 - src_alpha)
+  material_->getTechnique(0)->getPass(0)->setSceneBlending(
+    Ogre::SBF_ONE, Ogre::SBF_ONE_MINUS_SOURCE_ALPHA);
+
+  allocateTexture(ATLAS_INITIAL_HEIGHT_PX);
+  overlay_->show();
+
+  if (auto * root = Ogre::Root::getSingletonPtr()) {
+    root->addFrameListener(this);
+  }
 }
 
-OverlayPanel::~OverlayPanel()
+OverlayAtlas::~OverlayAtlas()
 {
+  // Jobs still running write into staging images owned by the regions
+  batch_.wait();
+
+  if (auto * root = Ogre::Root::getSingletonPtr()) {
+    root->removeFrameListener(this);
+  }
+
   if (overlay_) {
     auto * overlay_mgr = Ogre::OverlayManager::getSingletonPtr();
     if (overlay_mgr) {
-      overlay_mgr->destroyOverlayElement(panel_);
       overlay_mgr->destroy(overlay_);
     }
   }
@@ -201,23 +244,521 @@ OverlayPanel::~OverlayPanel()
   }
 }
 
+int OverlayAtlas::allocate(
+  unsigned int width, unsigned int height, unsigned int bucket,
+  Ogre::PanelOverlayElement * panel)
+{
+  if (!valid()) {
+    return -1;
+  }
+
+  // Reusing or repacking regions must not pull staging images from under a job
+  gather();
+
+  const int capacity_w =
+    static_cast<int>(AtlasPacker::bucketedExtent(std::max(width, 1u), bucket));
+  const int capacity_h =
+    static_cast<int>(AtlasPacker::bucketedExtent(std::max(height, 1u), bucket));
+
+  // Reuse a released region first
+  int index = -1;
+  for (size_t i = 0; i < regions_.size(); ++i) {
+    const Region & candidate = regions_[i];
+    if (!candidate.in_use &&
+      candidate.rect.width() >= capacity_w && candidate.rect.height() >= capacity_h)
+    {
+      index = static_cast<int>(i);
+      break;
+    }
+  }
+
+  if (index < 0) {
+    QRect rect;
+    if (!packer_.pack(capacity_w, capacity_h, rect) && !repack(capacity_w, capacity_h, rect)) {
+      RVIZ_COMMON_LOG_ERROR_STREAM("Attitude HUD texture atlas is full");
+      return -1;
+    }
+
+    // Slots dropped by a repack are reused before the handle table grows
+    for (size_t i = 0; i < regions_.size(); ++i) {
+      if (!regions_[i].in_use && regions_[i].rect.isEmpty()) {
+        index = static_cast<int>(i);
+        break;
+      }
+    }
+    if (index < 0) {
+      regions_.emplace_back();
+      index = static_cast<int>(regions_.size()) - 1;
+    }
+    regions_[index].rect = rect;
+    growTexture(static_cast<unsigned int>(rect.bottom() + 1));
+  }
+
+  Region & region = regions_[index];
+  region.in_use = true;
+  region.panel = panel;
+  region.content = QSize(
+    std::min(static_cast<int>(width), region.rect.width()),
+    std::min(static_cast<int>(height), region.rect.height()));
+  region.staging = QImage(region.rect.size(), STAGING_FORMAT);
+  region.staging.fill(Qt::transparent);
+  region.tiles.reset(region.rect.size());
+  region.pending = QRect();
+  region.dirty = QRect(QPoint(0, 0), region.rect.size());
+  has_dirty_ = true;
+  updateUV(region);
+  return index;
+}
+
+void OverlayAtlas::release(int region)
+{
+  if (region < 0 || region >= static_cast<int>(regions_.size())) {
+    return;
+  }
+  if (regions_[region].painting) {
+    gather();
+  }
+
+  Region & entry = regions_[region];
+  entry.in_use = false;
+  entry.panel = nullptr;
+  entry.staging = QImage();
+  entry.pending = QRect();
+  entry.dirty = QRect();
+  entry.uploaded = false;
+  entry.tag = UploadTag();
+  ++releases_;
+}
+
+QSize OverlayAtlas::capacity(int region) const
+{
+  if (region < 0 || region >= static_cast<int>(regions_.size())) {
+    return QSize();
+  }
+  return regions_[region].rect.size();
+}
+
+void OverlayAtlas::setContentSize(int region, unsigned int width, unsigned int height)
+{
+  if (region < 0 || region >= static_cast<int>(regions_.size())) {
+    return;
+  }
+
+  Region & entry = regions_[region];
+  entry.content = QSize(
+    std::min(static_cast<int>(width), entry.rect.width()),
+    std::min(static_cast<int>(height), entry.rect.height()));
+  updateUV(entry);
+}
+
+QImage OverlayAtlas::stagingImage(int region)
+{
+  if (region < 0 || region >= static_cast<int>(regions_.size())) {
+    return QImage();
+  }
+
+  Region & entry = regions_[region];
+  if (entry.staging.isNull() || entry.content.isEmpty()) {
+    return QImage();
+  }
+
+  // Shares the staging memory; row pitch is that of the full region
+  return QImage(
+    entry.staging.bits(),
+    entry.content.width(),
+    entry.content.height(),
+    entry.staging.bytesPerLine(),
+    entry.staging.format());
+}
+
+void OverlayAtlas::submit(
+  int region, std::function<void(QPainter &)> paint, const UploadTag & tag)
+{
+  if (region < 0 || region >= static_cast<int>(regions_.size())) {
+    return;
+  }
+  if (regions_[region].painting) {
+    gather();
+  }
+
+  const QImage image = stagingImage(region);
+  if (image.isNull()) {
+    return;
+  }
+
+  // The job wraps the staging memory itself: a copy of a QImage would detach
+  // when painted while this thread still holds the original
+  uchar * bits = regions_[region].staging.bits();
+  const int width = image.width();
+  const int height = image.height();
+  const int bytes_per_line = image.bytesPerLine();
+  paints_.push_back(Paint{region, image.rect(), tag, 0});
+  Paint * entry = &paints_.back();   // deque elements stay put until gather()
+  regions_[region].painting = true;
+
+  auto job = [bits, width, height, bytes_per_line, paint = std::move(paint), entry]() {
+      const int64_t begin_ns = Profiler::now();
+      QImage target(bits, width, height, bytes_per_line, STAGING_FORMAT);
+      target.fill(Qt::transparent);
+      QPainter painter(&target);
+      paint(painter);
+      painter.end();
+      entry->raster_ns = Profiler::now() - begin_ns;
+    };
+
+  // Text is laid out while painting, which Qt only supports off the GUI
+  // thread on some platforms
+  static const bool threaded = QFontDatabase::supportsThreadedFontRendering();
+  if (threaded) {
+    batch_.add(std::move(job));
+  } else {
+    job();
+  }
+}
+
+void OverlayAtlas::gather()
+{
+  if (paints_.empty()) {
+    return;
+  }
+  ATTITUDE_PROFILE_SCOPE("OverlayAtlas::gather");
+  batch_.wait();
+
+  raster_totals_.clear();
+  for (const Paint & paint : paints_) {
+    regions_[paint.region].painting = false;
+    markDirty(paint.region, paint.rect, paint.tag);
+
+    auto it = std::find_if(
+      raster_totals_.begin(), raster_totals_.end(),
+      [&paint](const RasterTotal & total) {return total.display == paint.tag.display;});
+    if (it == raster_totals_.end()) {
+      raster_totals_.push_back(RasterTotal{paint.tag.display, paint.tag.stamp_ns, nullptr, 0});
+      it = raster_totals_.end() - 1;
+    }
+    if (paint.tag.stats) {
+      it->stats = paint.tag.stats;
+      it->raster_ns += paint.raster_ns;
+    }
+  }
+  paints_.clear();
+
+  const int64_t now = Profiler::now();
+  for (const RasterTotal & total : raster_totals_) {
+    if (total.stats) {
+      total.stats->frameRastered(total.raster_ns, now);
+    }
+    ATTITUDE_TRACEPOINT(raster_end, total.display, total.stamp_ns);
+  }
+}
+
+void OverlayAtlas::markDirty(int region, const QRect & rect, const UploadTag & tag)
+{
+  if (region < 0 || region >= static_cast<int>(regions_.size())) {
+    return;
+  }
+
+  Region & entry = regions_[region];
+  if (entry.staging.isNull()) {
+    return;
+  }
+
+  entry.pending |= rect.intersected(QRect(QPoint(0, 0), entry.rect.size()));
+  entry.tag = tag;
+  has_dirty_ = true;
+}
+
+void OverlayAtlas::flush()
+{
+  gather();
+  if (!has_dirty_ || !texture_) {
+    return;
+  }
+  has_dirty_ = false;
+  ATTITUDE_PROFILE_SCOPE("OverlayAtlas::flush");
+
+  // Hash every region painted since the last flush, one pool job per region
+  std::vector<Region *> painted;
+  for (auto & region : regions_) {
+    if (region.in_use && !region.pending.isEmpty()) {
+      painted.push_back(&region);
+    }
+  }
+  RenderPool::parallelFor(
+    static_cast<int>(painted.size()),
+    [&painted](int i) {
+      Region & region = *painted[i];
+      const int64_t hash_begin_ns = Profiler::now();
+      region.dirty |= region.tiles.update(region.staging, region.pending);
+      region.pending = QRect();
+      region.upload_ns = Profiler::now() - hash_begin_ns;
+    });
+
+  // One upload per dirty rectangle, straight from the staging image: the
+  // texture is never locked, so nothing is read back and the cost follows
+  // the changed pixels rather than the area spanning them
+  const Ogre::HardwarePixelBufferSharedPtr & buffer = texture_->getBuffer();
+  for (auto & region : regions_) {
+    if (!region.in_use || region.dirty.isEmpty()) {
+      continue;
+    }
+    const int64_t write_begin_ns = Profiler::now();
+    writeRegion(*buffer, region);
+    region.upload_ns += Profiler::now() - write_begin_ns;
+    region.upload_bytes = static_cast<size_t>(region.dirty.width()) *
+      static_cast<size_t>(region.dirty.height()) * 4u;
+    region.dirty = QRect();
+    region.uploaded = true;
+  }
+
+  // Every rectangle has been handed to the driver at this point. Each display
+  // is charged for hashing and writing its own regions only; a region that
+  // hashed unchanged still costs its display the hashing
+  const int64_t flush_end_ns = Profiler::now();
+  upload_totals_.clear();
+  for (auto & region : regions_) {
+    const int64_t region_ns = region.upload_ns;
+    const size_t region_bytes = region.uploaded ? region.upload_bytes : 0;
+    if (region.uploaded) {
+      ATTITUDE_TRACEPOINT(upload_end, region.tag.display, region.tag.stamp_ns);
+    }
+    region.uploaded = false;
+    region.upload_ns = 0;
+    if (!region.tag.stats || (region_ns == 0 && region_bytes == 0)) {
+      continue;
+    }
+
+    auto it = std::find_if(
+      upload_totals_.begin(), upload_totals_.end(),
+      [&region](const UploadTotal & total) {return total.stats == region.tag.stats;});
+    if (it == upload_totals_.end()) {
+      upload_totals_.push_back(UploadTotal{region.tag.stats, 0, 0});
+      it = upload_totals_.end() - 1;
+    }
+    it->bytes += region_bytes;
+    it->ns += region_ns;
+  }
+  for (const UploadTotal & total : upload_totals_) {
+    if (total.bytes > 0) {
+      total.stats->frameUploaded(total.bytes, total.ns, flush_end_ns);
+    }
+  }
+}
+
+void OverlayAtlas::writeRegion(Ogre::HardwarePixelBuffer & buffer, const Region & region)
+{
+  const QRect & dirty = region.dirty;
+  const int bytes_per_line = region.staging.bytesPerLine();
+
+  // Source box over the dirty rectangle, keeping the staging row pitch
+  Ogre::PixelBox source(
+    static_cast<uint32_t>(dirty.width()),
+    static_cast<uint32_t>(dirty.height()),
+    1,
+    ATLAS_PIXEL_FORMAT,
+    const_cast<uchar *>(region.staging.constBits()) +
+    dirty.top() * bytes_per_line + dirty.left() * 4);
+  source.rowPitch = static_cast<uint32_t>(bytes_per_line / 4);
+  source.slicePitch = source.rowPitch * source.getHeight();
+
+  const QRect target = dirty.translated(region.rect.topLeft());
+  buffer.blitFromMemory(
+    source,
+    Ogre::Box(
+      static_cast<uint32_t>(target.left()),
+      static_cast<uint32_t>(target.top()),
+      static_cast<uint32_t>(target.right() + 1),
+      static_cast<uint32_t>(target.bottom() + 1)));
+}
+
+bool OverlayAtlas::frameStarted(const Ogre::FrameEvent & /*event*/)
+{
+  flush();
+  return true;
+}
+
+bool OverlayAtlas::repack(int width, int height, QRect & rect)
+{
+  ATTITUDE_PROFILE_SCOPE("OverlayAtlas::repack");
+
+  // Live regions keep their handle and size; released ones give their space back
+  std::vector<size_t> live;
+  std::vector<QSize> sizes;
+  for (size_t i = 0; i < regions_.size(); ++i) {
+    if (regions_[i].in_use) {
+      live.push_back(i);
+      sizes.push_back(regions_[i].rect.size());
+    }
+  }
+  std::vector<QRect> placed;
+  if (!packer_.repack(sizes, placed, width, height, rect)) {
+    return false;
+  }
+
+  for (auto & region : regions_) {
+    if (!region.in_use) {
+      region.rect = QRect();
+    }
+  }
+
+  // Moved regions are re-sent whole; the texture grows below if the new
+  // layout is taller than the old one
+  unsigned int needed_height = 0;
+  for (size_t k = 0; k < live.size(); ++k) {
+    Region & region = regions_[live[k]];
+    needed_height = std::max(needed_height, static_cast<unsigned int>(placed[k].bottom() + 1));
+    if (placed[k] == region.rect) {
+      continue;
+    }
+    region.rect = placed[k];
+    region.dirty = QRect(QPoint(0, 0), region.rect.size());
+    updateUV(region);
+    has_dirty_ = true;
+  }
+  growTexture(needed_height);
+  return true;
+}
+
+void OverlayAtlas::growTexture(unsigned int needed_height)
+{
+  if (texture_->getHeight() >= needed_height) {
+    return;
+  }
+
+  unsigned int new_height = texture_->getHeight();
+  while (new_height < needed_height) {
+    new_height *= 2;
+  }
+  allocateTexture(new_height);
+}
+
+void OverlayAtlas::allocateTexture(unsigned int height)
+{
+  Ogre::Pass * pass = material_->getTechnique(0)->getPass(0);
+  if (texture_) {
+    pass->removeAllTextureUnitStates();
+    Ogre::TextureManager::getSingleton().remove(texture_->getName());
+  }
+
+  texture_ = Ogre::TextureManager::getSingleton().createManual(
+    std::string(ATLAS_NAME) + "Texture",
+    Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+    Ogre::TEX_TYPE_2D,
+    AtlasPacker::ATLAS_WIDTH_PX,
+    height,
+    0,
+    ATLAS_PIXEL_FORMAT,
+    Ogre::TU_DYNAMIC_WRITE_ONLY);
+
+  // Panels are drawn 1:1, and filtering would bleed neighbouring regions in
+  Ogre::TextureUnitState * unit = pass->createTextureUnitState(texture_->getName());
+  unit->setTextureFiltering(Ogre::TFO_NONE);
+
+  {
+    ScopedPixelBuffer buffer(texture_->getBuffer());
+    buffer.clear();
+  }
+
+  // The new texture starts empty and its size changes every UV
+  for (auto & region : regions_) {
+    if (region.in_use) {
+      region.dirty = QRect(QPoint(0, 0), region.rect.size());
+      updateUV(region);
+      has_dirty_ = true;
+    }
+  }
+}
+
+void OverlayAtlas::updateUV(const Region & region) const
+{
+  if (!region.panel || !texture_) {
+    return;
+  }
+
+  const auto texture_w = static_cast<Ogre::Real>(texture_->getWidth());
+  const auto texture_h = static_cast<Ogre::Real>(texture_->getHeight());
+  region.panel->setUV(
+    region.rect.left() / texture_w,
+    region.rect.top() / texture_h,
+    (region.rect.left() + region.content.width()) / texture_w,
+    (region.rect.top() + region.content.height()) / texture_h);
+}
+
+// ============================================================================
+// OverlayPanel - Implementation
+// ============================================================================
+
+OverlayPanel::OverlayPanel(const std::string & name, OverlayPanel * parent)
+: name_(name),
+  atlas_(OverlayAtlas::acquire()),
+  parent_(parent),
+  panel_(nullptr),
+  region_(-1),
+  content_width_(0),
+  content_height_(0),
+  allocation_failed_(false),
+  failed_releases_(0)
+{
+  auto * overlay_mgr = Ogre::OverlayManager::getSingletonPtr();
+  if (!overlay_mgr || !atlas_->valid()) {
+    RVIZ_COMMON_LOG_ERROR_STREAM("Ogre OverlayManager not available for Attitude HUD");
+    return;
+  }
+
+  const std::string panel_name = name_ + "Panel";
+
+  panel_ = static_cast<Ogre::PanelOverlayElement *>(
+    overlay_mgr->createOverlayElement("Panel", panel_name));
+  panel_->setMetricsMode(Ogre::GMM_PIXELS);
+  panel_->setHorizontalAlignment(Ogre::GHA_LEFT);
+  panel_->setVerticalAlignment(Ogre::GVA_TOP);
+  panel_->setMaterialName(atlas_->materialName());
+  panel_->setTransparent(true);   // until a region is allocated
+  panel_->hide();
+
+  if (parent_ && parent_->panel_) {
+    parent_->panel_->addChild(panel_);
+  } else {
+    atlas_->overlay()->add2D(panel_);
+  }
+}
+
+OverlayPanel::~OverlayPanel()
+{
+  if (region_ >= 0) {
+    atlas_->release(region_);
+  }
+
+  if (panel_) {
+    if (parent_ && parent_->panel_) {
+      parent_->panel_->removeChild(panel_->getName());
+    } else {
+      atlas_->overlay()->remove2D(panel_);
+    }
+    auto * overlay_mgr = Ogre::OverlayManager::getSingletonPtr();
+    if (overlay_mgr) {
+      overlay_mgr->destroyOverlayElement(panel_);
+    }
+  }
+}
+
 void OverlayPanel::show()
 {
-  if (overlay_) {
-    overlay_->show();
+  if (panel_) {
+    panel_->show();
   }
 }
 
 void OverlayPanel::hide()
 {
-  if (overlay_) {
-    overlay_->hide();
+  if (panel_) {
+    panel_->hide();
   }
 }
 
 bool OverlayPanel::isVisible() const
 {
-  return overlay_ && overlay_->isVisible();
+  return panel_ && panel_->isVisible();
 }
 
 void OverlayPanel::setPosition(int left, int top)
@@ -247,53 +788,82 @@ void OverlayPanel::updateTextureSize(unsigned int width, unsigned int height)
     height = 1;
   }
 
-  const std::string texture_name = name_ + "Texture";
-
-  if (!texture_ || texture_->getWidth() != width || texture_->getHeight() != height) {
-    if (texture_) {
-      Ogre::TextureManager::getSingleton().remove(texture_->getName());
-      material_->getTechnique(0)->getPass(0)->removeAllTextureUnitStates();
-    }
-
-    texture_ = Ogre::TextureManager::getSingleton().createManual(
-      texture_name,
-      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
-      Ogre::TEX_TYPE_2D,
-      width,
-      height,
-      0,
-      Ogre::PF_A8R8G8B8,
-      Ogre::TU_DEFAULT);
-
-    material_->getTechnique(0)->getPass(0)->createTextureUnitState(texture_->getName());
-    material_->getTechnique(0)->getPass(0)->setSceneBlending(Ogre::SBT_TRANSPARENT_ALPHA);
+  // A full atlas is not searched again every frame for the same request
+  if (region_ < 0 && allocation_failed_ && failed_releases_ == atlas_->releases() &&
+    width >= static_cast<unsigned int>(failed_size_.width()) &&
+    height >= static_cast<unsigned int>(failed_size_.height()))
+  {
+    return;
   }
-}
 
-ScopedPixelBuffer OverlayPanel::getPixelBuffer()
-{
-  if (!texture_) {
-    return ScopedPixelBuffer(Ogre::HardwarePixelBufferSharedPtr());
+  // Only move to a bigger region when the content outgrows the current one
+  const QSize capacity = atlas_->capacity(region_);
+  if (region_ < 0 ||
+    static_cast<unsigned int>(capacity.width()) < width ||
+    static_cast<unsigned int>(capacity.height()) < height)
+  {
+    if (region_ >= 0) {
+      atlas_->release(region_);
+    }
+    // Component panels are many and small; only the root (background
+    // capsule) panel follows interactive resizes closely enough to need
+    // coarse steps
+    region_ = atlas_->allocate(
+      std::max(width, static_cast<unsigned int>(std::max(capacity.width(), 0))),
+      std::max(height, static_cast<unsigned int>(std::max(capacity.height(), 0))),
+      parent_ ? AtlasPacker::COMPONENT_BUCKET_PX : AtlasPacker::HUD_BUCKET_PX,
+      panel_);
+    allocation_failed_ = region_ < 0;
+    panel_->setTransparent(allocation_failed_);
+    if (allocation_failed_) {
+      failed_releases_ = atlas_->releases();
+      failed_size_ = QSize(static_cast<int>(width), static_cast<int>(height));
+      content_width_ = 0;
+      content_height_ = 0;
+      return;
+    }
   }
-  return ScopedPixelBuffer(texture_->getBuffer());
-}
 
-unsigned int OverlayPanel::textureWidth() const
-{
-  return texture_ ? texture_->getWidth() : 0;
+  content_width_ = width;
+  content_height_ = height;
+  atlas_->setContentSize(region_, width, height);
 }
 
-unsigned int OverlayPanel::textureHeight() const
+void OverlayPanel::submit(std::function<void(QPainter &)> paint, const UploadTag & tag)
 {
-  return texture_ ? texture_->getHeight() : 0;
+  if (region_ >= 0 && paint) {
+    atlas_->submit(region_, std::move(paint), tag);
+  }
 }
 
 // ============================================================================
 // OverlayManager - Implementation
 // ============================================================================
 
+// Qt holds back resize events for hidden widgets until they are shown. The
+// HUD is never shown, so deliver them top-down to get valid child geometry
+// before components are positioned individually.
+static void settleLayout(QWidget * widget)
+{
+  if (widget->testAttribute(Qt::WA_PendingResizeEvent)) {
+    widget->setAttribute(Qt::WA_PendingResizeEvent, false);
+    QResizeEvent event(widget->size(), QSize());
+    QCoreApplication::sendEvent(widget, &event);
+  }
+  if (widget->layout()) {
+    widget->layout()->activate();
+  }
+
+  for (QWidget * child : widget->findChildren<QWidget *>(QString(), Qt::FindDirectChildrenOnly)) {
+    if (child->isVisibleTo(widget)) {
+      settleLayout(child);
+    }
+  }
+}
+
 OverlayManager::OverlayManager()
-: render_panel_(nullptr)
+: render_panel_(nullptr),
+  atlas_full_(false)
 {
 }
 
@@ -303,8 +873,23 @@ void OverlayManager::attach(rviz_common::DisplayContext * context)
 {
   if (!overlay_panel_) {
     static std::atomic<int> overlay_count{0};
+    static const std::array<const char *, COMPONENT_COUNT> component_names = {
+      "Background", "Heading", "Attitude", "SpeedTape", "AltitudeTape",
+      "RollReadout", "PitchReadout", "YawReadout",
+      "RollStats", "PitchStats", "YawStats", "Spectrum", "Perf"
+    };
+
     rviz_rendering::RenderSystem::get()->prepareOverlays(context->getSceneManager());
-    overlay_panel_ = std::make_unique<OverlayPanel>("AttitudeDisplayHUD" + std::to_string(overlay_count++));
+    const std::string name = "AttitudeDisplayHUD" + std::to_string(overlay_count++);
+    overlay_panel_ = std::make_unique<OverlayPanel>(name);
+
+    // The background capsule is drawn by the root panel itself
+    for (size_t i = 0; i < COMPONENT_COUNT; ++i) {
+      if (static_cast<HudComponent>(i) != HudComponent::Background) {
+        component_panels_[i] = std::make_unique<OverlayPanel>(
+          name + component_names[i], overlay_panel_.get());
+      }
+    }
   }
   if (!render_panel_) {
     auto * view_manager = context->getViewManager();
@@ -349,9 +934,12 @@ void OverlayManager::setGeometry(int width,
       break;
   }
 
-  overlay_panel_->updateTextureSize(static_cast<unsigned int>(width), static_cast<unsigned int>(height));
-  overlay_panel_->setDimensions(static_cast<unsigned int>(width), static_cast<unsigned int>(height));
-  overlay_panel_->setPosition(x, y);
+  // The root panel only covers the capsule; render() sizes it once the
+  // widget is laid out at this size
+  hud_size_ = QSize(width, height);
+  hud_position_ = QPoint(x, y);
+  const QPoint root = hud_position_ + background_offset_;
+  overlay_panel_->setPosition(root.x(), root.y());
 }
 
 void OverlayManager::setVisible(bool visible)
@@ -360,30 +948,73 @@ void OverlayManager::setVisible(bool visible)
   if (visible) overlay_panel_->show(); else overlay_panel_->hide();
 }
 
-void OverlayManager::render(AttitudeWidget & widget)
+void OverlayManager::render(AttitudeWidget & widget, const UploadTag & tag)
 {
-  if (!overlay_panel_) return;
-  const auto width = overlay_panel_->textureWidth();
-  const auto height = overlay_panel_->textureHeight();
-  if (width == 0 || height == 0) return;
+  if (!overlay_panel_ || hud_size_.isEmpty()) return;
 
-  overlay_panel_->updateTextureSize(width, height);
-  overlay_panel_->setDimensions(width, height);
+  ATTITUDE_PROFILE_SCOPE("OverlayManager::render");
+  ATTITUDE_TRACEPOINT(raster_start, tag.display, tag.stamp_ns);
 
   // Ensure widget matches overlay dimensions for correct rendering
   // TODO: Consider having widget manage its own preferred size
-  widget.resize(static_cast<int>(width), static_cast<int>(height));
+  widget.resize(hud_size_);
+  settleLayout(&widget);
+
+  // The root panel sits on the capsule; every other panel is placed relative to it
+  if (QWidget * frame = widget.componentWidget(HudComponent::Background)) {
+    background_offset_ = frame->mapTo(&widget, QPoint(0, 0));
+    const QPoint root = hud_position_ + background_offset_;
+    overlay_panel_->setPosition(root.x(), root.y());
+  }
+  atlas_full_ = false;
+
+  unsigned int dirty = widget.takeDirtyComponents();
+
+  // The perf strip shows the raster and upload cost, so its own are left out
+  UploadTag perf_tag = tag;
+  perf_tag.stats = nullptr;
+
+  for (size_t i = 0; i < COMPONENT_COUNT; ++i) {
+    const auto component = static_cast<HudComponent>(i);
+    const bool is_perf = component == HudComponent::Perf;
+    const bool is_background = component == HudComponent::Background;
+    QWidget * source = widget.componentWidget(component);
+    OverlayPanel * panel = is_background ? overlay_panel_.get() : component_panels_[i].get();
+    if (!source || !panel) continue;
+
+    if (!is_background && !source->isVisibleTo(&widget)) {
+      // Forget the size so the component is redrawn when shown again
+      panel->hide();
+      component_sizes_[i] = QSize();
+      continue;
+    }
 
-  ScopedPixelBuffer buffer = overlay_panel_->getPixelBuffer();
-  if (!buffer.valid()) return;
+    const auto source_w = static_cast<unsigned int>(source->width());
+    const auto source_h = static_cast<unsigned int>(source->height());
+    panel->updateTextureSize(source_w, source_h);
+    panel->setDimensions(source_w, source_h);
+    if (!is_background) {
+      const QPoint offset = source->mapTo(&widget, QPoint(0, 0)) - background_offset_;
+      panel->setPosition(offset.x(), offset.y());
+      panel->show();
+    }
+    if (!panel->hasTexture()) {
+      atlas_full_ = true;
+      component_sizes_[i] = QSize();
+      continue;
+    }
 
-  QImage image = buffer.getQImage(width, height);
-  if (image.isNull()) return;
-  image.fill(Qt::transparent);
+    const QSize size = source->size();
+    if (size != component_sizes_[i]) {
+      component_sizes_[i] = size;
+      dirty |= componentBit(component);
+    }
+    if (!(dirty & componentBit(component))) continue;
 
-  QPainter painter(&image);
-  widget.render(&painter);
-  painter.end();
+    // Painted from a snapshot on the RenderPool; the atlas gathers and
+    // uploads it next frame
+    panel->submit(widget.componentFrame(component), is_perf ? perf_tag : tag);
+  }
 }
 
 }  // namespace rviz_attitude_plugin
@@ -0,0 +1,118 @@
+#include "rviz_attitude_plugin/perf_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rviz_attitude_plugin
+{
+
+static constexpr double NS_PER_MS = 1e6;
+static constexpr double NS_PER_S = 1e9;
+
+PerfStats::PerfStats()
+{
+  reset();
+}
+
+void PerfStats::reset()
+{
+  window_begin_ns_ = 0;
+  messages_ = 0;
+  frames_ = 0;
+  uploads_ = 0;
+  upload_bytes_ = 0;
+  raster_ns_ = 0;
+  upload_ns_ = 0;
+  pending_ingest_ns_ = 0;
+  rastered_ingest_ns_ = 0;
+  latencies_ms_.fill(0.0f);
+  latency_count_ = 0;
+  costs_ms_.fill(0.0f);
+  cost_head_ = 0;
+  cost_count_ = 0;
+  snapshot_ = PerfSnapshot();
+}
+
+void PerfStats::messageReceived(int64_t now_ns)
+{
+  ++messages_;
+  if (pending_ingest_ns_ == 0) {
+    pending_ingest_ns_ = now_ns;
+  }
+}
+
+void PerfStats::frameRastered(int64_t duration_ns, int64_t /*end_ns*/)
+{
+  ++frames_;
+  raster_ns_ += duration_ns;
+
+  // A frame whose pixels were identical is never uploaded; the next one takes over
+  rastered_ingest_ns_ = pending_ingest_ns_;
+  pending_ingest_ns_ = 0;
+
+  costs_ms_[cost_head_] = static_cast<float>(duration_ns / NS_PER_MS);
+  cost_head_ = (cost_head_ + 1) % costs_ms_.size();
+  cost_count_ = std::min(cost_count_ + 1, costs_ms_.size());
+}
+
+void PerfStats::frameUploaded(size_t bytes, int64_t duration_ns, int64_t end_ns)
+{
+  ++uploads_;
+  upload_bytes_ += bytes;
+  upload_ns_ += duration_ns;
+
+  if (cost_count_ > 0) {
+    const size_t newest = (cost_head_ + costs_ms_.size() - 1) % costs_ms_.size();
+    costs_ms_[newest] += static_cast<float>(duration_ns / NS_PER_MS);
+  }
+
+  if (rastered_ingest_ns_ != 0) {
+    if (latency_count_ < latencies_ms_.size()) {
+      latencies_ms_[latency_count_++] =
+        static_cast<float>((end_ns - rastered_ingest_ns_) / NS_PER_MS);
+    }
+    rastered_ingest_ns_ = 0;
+  }
+}
+
+const PerfSnapshot & PerfStats::snapshot(int64_t now_ns)
+{
+  if (window_begin_ns_ != 0 && now_ns > window_begin_ns_) {
+    const double seconds = (now_ns - window_begin_ns_) / NS_PER_S;
+    snapshot_.message_hz = messages_ / seconds;
+    snapshot_.render_fps = frames_ / seconds;
+    snapshot_.coalescing = frames_ > 0 ? static_cast<double>(messages_) / frames_ : 0.0;
+    snapshot_.raster_ms = frames_ > 0 ? raster_ns_ / NS_PER_MS / frames_ : 0.0;
+    snapshot_.upload_ms = uploads_ > 0 ? upload_ns_ / NS_PER_MS / uploads_ : 0.0;
+    snapshot_.upload_bytes_per_s = upload_bytes_ / seconds;
+
+    // Keep the previous percentile through windows without uploads
+    if (latency_count_ > 0) {
+      const size_t rank = std::min(
+        latency_count_ - 1,
+        static_cast<size_t>(std::ceil(0.99 * static_cast<double>(latency_count_))) - 1);
+      std::nth_element(
+        latencies_ms_.begin(), latencies_ms_.begin() + rank,
+        latencies_ms_.begin() + latency_count_);
+      snapshot_.latency_p99_ms = latencies_ms_[rank];
+    }
+  }
+
+  snapshot_.frame_cost_count = cost_count_;
+  const size_t oldest = (cost_head_ + costs_ms_.size() - cost_count_) % costs_ms_.size();
+  for (size_t i = 0; i < cost_count_; ++i) {
+    snapshot_.frame_cost_ms[i] = costs_ms_[(oldest + i) % costs_ms_.size()];
+  }
+
+  window_begin_ns_ = now_ns;
+  messages_ = 0;
+  frames_ = 0;
+  uploads_ = 0;
+  upload_bytes_ = 0;
+  raster_ns_ = 0;
+  upload_ns_ = 0;
+  latency_count_ = 0;
+  return snapshot_;
+}
+
+}  // namespace rviz_attitude_plugin
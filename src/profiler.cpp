@@ -0,0 +1,228 @@
+#include "rviz_attitude_plugin/profiler.hpp"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace rviz_attitude_plugin
+{
+
+std::atomic<bool> Profiler::enabled_{false};
+
+Profiler & Profiler::instance()
+{
+  // Never destroyed: pool threads may exit and release their rings after
+  // static destructors have run
+  static Profiler * profiler = new Profiler();
+  return *profiler;
+}
+
+void Profiler::acquire()
+{
+  std::lock_guard<std::mutex> lock(enable_mutex_);
+  if (enable_count_++ == 0) {
+    clear();
+    enabled_.store(true, std::memory_order_relaxed);
+  }
+}
+
+void Profiler::release()
+{
+  std::lock_guard<std::mutex> lock(enable_mutex_);
+  if (enable_count_ > 0 && --enable_count_ == 0) {
+    enabled_.store(false, std::memory_order_relaxed);
+  }
+}
+
+int64_t Profiler::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler::ThreadRing & Profiler::localRing()
+{
+  // Hands the ring back when its thread exits
+  struct Owner
+  {
+    ThreadRing * ring{nullptr};
+    ~Owner()
+    {
+      if (ring) {
+        Profiler::instance().releaseRing(ring);
+      }
+    }
+  };
+  thread_local Owner owner;
+
+  if (!owner.ring) {
+    std::string thread_name;
+    QThread * thread = QThread::currentThread();
+    const QCoreApplication * app = QCoreApplication::instance();
+    if (app && thread == app->thread()) {
+      thread_name = "GUI";
+    } else if (thread && !thread->objectName().isEmpty()) {
+      thread_name = thread->objectName().toStdString();
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    ThreadRing * ring = nullptr;
+    if (!free_rings_.empty()) {
+      // Drop the previous owner's events; a new tid keeps the tracks apart
+      ring = free_rings_.back();
+      free_rings_.pop_back();
+      ring->floor.store(ring->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    } else {
+      rings_.push_back(std::make_unique<ThreadRing>());
+      ring = rings_.back().get();
+    }
+    ring->tid = ++next_tid_;
+    ring->thread_name = thread_name.empty() ?
+      "Thread " + std::to_string(ring->tid) : std::move(thread_name);
+    owner.ring = ring;
+  }
+  return *owner.ring;
+}
+
+void Profiler::releaseRing(ThreadRing * ring)
+{
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  free_rings_.push_back(ring);
+}
+
+void Profiler::record(const char * name, int64_t begin_ns, int64_t end_ns)
+{
+  ThreadRing & ring = localRing();
+  const uint64_t head = ring.head.load(std::memory_order_relaxed);
+  Slot & slot = ring.slots[head & (RING_CAPACITY - 1)];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+  slot.duration_ns.store(end_ns - begin_ns, std::memory_order_relaxed);
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::clear()
+{
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  for (auto & ring : rings_) {
+    ring->floor.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+  }
+}
+
+namespace
+{
+
+/**
+ * @brief Append text as the body of a JSON string literal.
+ */
+void appendJsonEscaped(std::string & out, const std::string & text)
+{
+  for (const char c : text) {
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+          out += escaped;
+        } else {
+          out += c;
+        }
+    }
+  }
+}
+
+}  // namespace
+
+int Profiler::dumpChromeTrace(const std::string & path, std::string & error)
+{
+  struct Event
+  {
+    const char * name;
+    int64_t begin_ns;
+    int64_t duration_ns;
+  };
+
+  std::ofstream out(path, std::ios::out | std::ios::trunc);
+  if (!out) {
+    error = "cannot open " + path + " for writing";
+    return -1;
+  }
+
+  const long long pid = QCoreApplication::applicationPid();
+  int written = 0;
+  bool first = true;
+  char line[256];
+  std::vector<Event> events;
+  events.reserve(RING_CAPACITY);
+  std::string thread_name;
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  for (const auto & ring : rings_) {
+    // Copy first, then drop whatever the writer may have overwritten meanwhile
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    uint64_t begin = std::max(
+      ring->floor.load(std::memory_order_relaxed),
+      head > RING_CAPACITY ? head - RING_CAPACITY : 0);
+    events.clear();
+    for (uint64_t i = begin; i < head; ++i) {
+      const Slot & slot = ring->slots[i & (RING_CAPACITY - 1)];
+      events.push_back({
+          slot.name.load(std::memory_order_relaxed),
+          slot.begin_ns.load(std::memory_order_relaxed),
+          slot.duration_ns.load(std::memory_order_relaxed)});
+    }
+    const uint64_t head_after = ring->head.load(std::memory_order_acquire);
+    const uint64_t safe = head_after + 1 > RING_CAPACITY ? head_after + 1 - RING_CAPACITY : 0;
+    const size_t skip = static_cast<size_t>(std::min<uint64_t>(
+        safe > begin ? safe - begin : 0, events.size()));
+
+    // Thread names come from QObject::objectName() and may hold anything
+    std::snprintf(
+      line, sizeof(line),
+      "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lld,\"tid\":%u,\"args\":{\"name\":\"",
+      first ? "" : ",", pid, ring->tid);
+    thread_name.clear();
+    appendJsonEscaped(thread_name, ring->thread_name);
+    out << line << thread_name << "\"}}";
+    first = false;
+
+    for (size_t i = skip; i < events.size(); ++i) {
+      const Event & event = events[i];
+      if (!event.name) {
+        continue;
+      }
+      // Chrome trace timestamps are microseconds
+      std::snprintf(
+        line, sizeof(line),
+        ",\n{\"name\":\"%s\",\"cat\":\"attitude\",\"ph\":\"X\",\"pid\":%lld,\"tid\":%u,"
+        "\"ts\":%.3f,\"dur\":%.3f}",
+        event.name, pid, ring->tid,
+        static_cast<double>(event.begin_ns) / 1000.0,
+        static_cast<double>(event.duration_ns) / 1000.0);
+      out << line;
+      ++written;
+    }
+  }
+
+  out << "]}\n";
+  out.close();
+  if (!out) {
+    error = "failed writing " + path;
+    return -1;
+  }
+  return written;
+}
+
+}  // namespace rviz_attitude_plugin
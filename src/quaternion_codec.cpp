@@ -0,0 +1,138 @@
+#include "rviz_attitude_plugin/quaternion_codec.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace rviz_attitude_plugin
+{
+namespace quaternion_codec
+{
+
+namespace
+{
+
+inline float field(uint16_t word)
+{
+  return static_cast<float>(word & FIELD_MAX) * STEP - RANGE;
+}
+
+#if defined(__SSE2__)
+inline __m128 select(__m128 mask, __m128 if_set, __m128 if_clear)
+{
+  return _mm_or_ps(_mm_and_ps(mask, if_set), _mm_andnot_ps(mask, if_clear));
+}
+
+inline __m128i load4(const uint16_t * words)
+{
+  return _mm_unpacklo_epi16(
+    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(words)), _mm_setzero_si128());
+}
+#endif
+
+}  // namespace
+
+void encode(double x, double y, double z, double w, uint16_t & a, uint16_t & b, uint16_t & c)
+{
+  double q[4] = {x, y, z, w};
+  const double norm = std::sqrt(x * x + y * y + z * z + w * w);
+  if (!(norm > 0.0)) {
+    q[0] = q[1] = q[2] = 0.0;
+    q[3] = 1.0;
+  } else {
+    for (double & component : q) {
+      component /= norm;
+    }
+  }
+
+  unsigned int largest = 0;
+  for (unsigned int i = 1; i < 4; ++i) {
+    if (std::abs(q[i]) > std::abs(q[largest])) {
+      largest = i;
+    }
+  }
+  const double sign = q[largest] < 0.0 ? -1.0 : 1.0;
+
+  uint16_t fields[3];
+  unsigned int k = 0;
+  for (unsigned int i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+    const double value = std::clamp(sign * q[i], -double(RANGE), double(RANGE));
+    const long quantized = std::lround((value + RANGE) / STEP);
+    fields[k++] = static_cast<uint16_t>(std::clamp<long>(quantized, 0, FIELD_MAX));
+  }
+
+  a = static_cast<uint16_t>(fields[0] | ((largest & 1u) << FIELD_BITS));
+  b = static_cast<uint16_t>(fields[1] | ((largest >> 1) << FIELD_BITS));
+  c = fields[2];
+}
+
+void decode(uint16_t a, uint16_t b, uint16_t c, float & x, float & y, float & z, float & w)
+{
+  const unsigned int largest = (a >> FIELD_BITS) | ((b >> FIELD_BITS) << 1);
+  const float c0 = field(a);
+  const float c1 = field(b);
+  const float c2 = field(c);
+  const float sum = c0 * c0 + c1 * c1 + c2 * c2;
+  const float rebuilt = std::sqrt(std::max(0.0f, 1.0f - sum));
+
+  switch (largest) {
+    case 0: x = rebuilt; y = c0; z = c1; w = c2; break;
+    case 1: x = c0; y = rebuilt; z = c1; w = c2; break;
+    case 2: x = c0; y = c1; z = rebuilt; w = c2; break;
+    default: x = c0; y = c1; z = c2; w = rebuilt; break;
+  }
+}
+
+void decode(
+  const uint16_t * a, const uint16_t * b, const uint16_t * c, size_t count,
+  float * x, float * y, float * z, float * w)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  // Four quaternions per iteration; the dropped component is placed with masks
+  const __m128i field_mask = _mm_set1_epi32(FIELD_MAX);
+  const __m128 step = _mm_set1_ps(STEP);
+  const __m128 range = _mm_set1_ps(RANGE);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 zero = _mm_setzero_ps();
+  for (; i + 4 <= count; i += 4) {
+    const __m128i wa = load4(a + i);
+    const __m128i wb = load4(b + i);
+    const __m128i wc = load4(c + i);
+    const __m128i largest = _mm_or_si128(
+      _mm_srli_epi32(wa, FIELD_BITS), _mm_slli_epi32(_mm_srli_epi32(wb, FIELD_BITS), 1));
+
+    const __m128 c0 = _mm_sub_ps(
+      _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(wa, field_mask)), step), range);
+    const __m128 c1 = _mm_sub_ps(
+      _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(wb, field_mask)), step), range);
+    const __m128 c2 = _mm_sub_ps(
+      _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(wc, field_mask)), step), range);
+    const __m128 sum = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(c0, c0), _mm_mul_ps(c1, c1)), _mm_mul_ps(c2, c2));
+    const __m128 rebuilt = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(one, sum), zero));
+
+    const __m128 is0 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(0)));
+    const __m128 is1 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(1)));
+    const __m128 is2 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(2)));
+    const __m128 is3 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(3)));
+
+    _mm_storeu_ps(x + i, select(is0, rebuilt, c0));
+    _mm_storeu_ps(y + i, select(is0, c0, select(is1, rebuilt, c1)));
+    _mm_storeu_ps(z + i, select(is3, c2, select(is2, rebuilt, c1)));
+    _mm_storeu_ps(w + i, select(is3, rebuilt, c2));
+  }
+#endif
+  for (; i < count; ++i) {
+    decode(a[i], b[i], c[i], x[i], y[i], z[i], w[i]);
+  }
+}
+
+}  // namespace quaternion_codec
+}  // namespace rviz_attitude_plugin
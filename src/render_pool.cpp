@@ -0,0 +1,186 @@
+#include "rviz_attitude_plugin/render_pool.hpp"
+
+#include <QRunnable>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace rviz_attitude_plugin
+{
+
+namespace
+{
+
+class FunctionRunnable : public QRunnable
+{
+public:
+  explicit FunctionRunnable(std::function<void()> function)
+  : function_(std::move(function))
+  {
+    setAutoDelete(true);
+  }
+
+  void run() override
+  {
+    function_();
+  }
+
+private:
+  std::function<void()> function_;
+};
+
+// Shared between a parallelFor call and its helpers. Helpers own it too, so
+// one that starts after the call returned only touches this, never the
+// caller's stack.
+struct ParallelState
+{
+  const std::function<void(int)> * job;  // valid while an index is unclaimed
+  int count;
+  std::atomic<int> next{0};
+  std::mutex mutex;
+  std::condition_variable idle;
+  int active{0};                         // helpers that may still claim an index
+};
+
+void drain(ParallelState & state)
+{
+  for (int i = state.next++; i < state.count; i = state.next++) {
+    (*state.job)(i);
+  }
+}
+
+}  // namespace
+
+QThreadPool & RenderPool::instance()
+{
+  static QThreadPool pool;
+  static const bool configured = [] {
+      pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+      pool.setExpiryTimeout(-1);  // keep workers warm between frames
+      return true;
+    }();
+  (void)configured;
+  return pool;
+}
+
+void RenderPool::parallelFor(int count, const std::function<void(int)> & job)
+{
+  if (count <= 0) {
+    return;
+  }
+
+  QThreadPool & pool = instance();
+  const int helpers = std::min(count - 1, pool.maxThreadCount());
+  if (helpers <= 0) {
+    for (int i = 0; i < count; ++i) {
+      job(i);
+    }
+    return;
+  }
+
+  auto state = std::make_shared<ParallelState>();
+  state->job = &job;
+  state->count = count;
+
+  // Only idle workers help; none is queued behind post() jobs
+  for (int i = 0; i < helpers; ++i) {
+    auto * helper = new FunctionRunnable([state]() {
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          ++state->active;
+        }
+        drain(*state);
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          --state->active;
+        }
+        state->idle.notify_all();
+      });
+    if (!pool.tryStart(helper)) {
+      delete helper;
+      break;
+    }
+  }
+
+  // Once every index is claimed, wait only for helpers still running one.
+  // A helper registering after this finds nothing left and never calls job.
+  drain(*state);
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->idle.wait(lock, [&state]() {return state->active == 0;});
+}
+
+void RenderPool::post(std::function<void()> job)
+{
+  instance().start(new FunctionRunnable(std::move(job)));
+}
+
+// ============================================================================
+// RenderBatch
+// ============================================================================
+
+// Jobs are claimed from the queue by whoever gets there first: a worker
+// started for the job, or the thread in wait()
+struct RenderBatch::State
+{
+  std::mutex mutex;
+  std::condition_variable idle;
+  std::deque<std::function<void()>> queued;
+  int running{0};
+
+  bool runOne()
+  {
+    std::function<void()> job;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (queued.empty()) {
+        return false;
+      }
+      job = std::move(queued.front());
+      queued.pop_front();
+      ++running;
+    }
+    job();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      --running;
+    }
+    idle.notify_all();
+    return true;
+  }
+};
+
+RenderBatch::RenderBatch()
+: state_(std::make_shared<State>())
+{
+}
+
+RenderBatch::~RenderBatch()
+{
+  wait();
+}
+
+void RenderBatch::add(std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->queued.push_back(std::move(job));
+  }
+  // A worker that starts after wait() drained the queue finds nothing to do
+  RenderPool::post([state = state_]() {state->runOne();});
+}
+
+void RenderBatch::wait()
+{
+  while (state_->runOne()) {
+  }
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->idle.wait(lock, [this]() {return state_->running == 0;});
+}
+
+}  // namespace rviz_attitude_plugin
@@ -0,0 +1,420 @@
+#include "rviz_attitude_plugin/spectrum_analyzer.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+#include "rviz_attitude_plugin/render_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <mutex>
+
+namespace rviz_attitude_plugin
+{
+
+// Segments in the Welch mean; with a quarter-window hop they span
+// WINDOW + 7 * HOP samples
+static constexpr size_t WELCH_SEGMENTS = 8;
+
+// A peak must stand this far above the mean spectral level
+static constexpr float PEAK_PROMINENCE_DB = 6.0f;
+
+// Floor added before taking logarithms
+static constexpr float PSD_FLOOR = 1e-12f;
+
+namespace
+{
+
+constexpr size_t log2Size(size_t n)
+{
+  return n <= 1 ? 0 : 1 + log2Size(n / 2);
+}
+
+/**
+ * @brief In-place iterative radix-2 FFT of a fixed size.
+ */
+class Fft
+{
+public:
+  static constexpr size_t SIZE = SPECTRUM_WINDOW;
+  static_assert((SIZE & (SIZE - 1)) == 0, "FFT size must be a power of two");
+
+  Fft()
+  {
+    const size_t bits = log2Size(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+      size_t reversed = 0;
+      for (size_t b = 0; b < bits; ++b) {
+        reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+      }
+      bit_reverse_[i] = static_cast<uint16_t>(reversed);
+    }
+    for (size_t k = 0; k < SIZE / 2; ++k) {
+      const double angle = -2.0 * M_PI * static_cast<double>(k) / SIZE;
+      twiddles_[k] = std::complex<float>(
+        static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+  }
+
+  void transform(std::array<std::complex<float>, SIZE> & data) const
+  {
+    for (size_t i = 0; i < SIZE; ++i) {
+      const size_t j = bit_reverse_[i];
+      if (i < j) {
+        std::swap(data[i], data[j]);
+      }
+    }
+    for (size_t length = 2; length <= SIZE; length <<= 1) {
+      const size_t half = length / 2;
+      const size_t stride = SIZE / length;
+      for (size_t start = 0; start < SIZE; start += length) {
+        for (size_t k = 0; k < half; ++k) {
+          const std::complex<float> odd = twiddles_[k * stride] * data[start + k + half];
+          data[start + k + half] = data[start + k] - odd;
+          data[start + k] += odd;
+        }
+      }
+    }
+  }
+
+private:
+  std::array<uint16_t, SIZE> bit_reverse_;
+  std::array<std::complex<float>, SIZE / 2> twiddles_;
+};
+
+const Fft & fft()
+{
+  static const Fft instance;
+  return instance;
+}
+
+const std::array<float, SPECTRUM_WINDOW> & hannWindow()
+{
+  static const std::array<float, SPECTRUM_WINDOW> window = [] {
+      std::array<float, SPECTRUM_WINDOW> w{};
+      for (size_t i = 0; i < w.size(); ++i) {
+        w[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / (w.size() - 1)));
+      }
+      return w;
+    }();
+  return window;
+}
+
+double wrapAngle(double angle)
+{
+  return std::remainder(angle, 2.0 * M_PI);
+}
+
+void findPeaks(
+  const std::array<float, SPECTRUM_BINS> & db, double bin_hz,
+  std::array<SpectrumPeak, SPECTRUM_PEAKS> & peaks, size_t & count)
+{
+  float mean = 0.0f;
+  for (size_t k = 1; k < db.size(); ++k) {
+    mean += db[k];
+  }
+  mean /= static_cast<float>(db.size() - 1);
+
+  count = 0;
+  for (size_t k = 2; k + 1 < db.size(); ++k) {
+    const float a = db[k - 1];
+    const float b = db[k];
+    const float c = db[k + 1];
+    if (!(b > a && b >= c) || b < mean + PEAK_PROMINENCE_DB) {
+      continue;
+    }
+
+    // Parabola through the three bins locates the peak between them
+    const float curvature = a - 2.0f * b + c;
+    const float offset = curvature < 0.0f ? 0.5f * (a - c) / curvature : 0.0f;
+    SpectrumPeak peak;
+    peak.frequency_hz = static_cast<float>((static_cast<double>(k) + offset) * bin_hz);
+    peak.power_db = b - 0.25f * (a - c) * offset;
+
+    // Insert into the strongest-first list
+    size_t slot = count;
+    while (slot > 0 && peaks[slot - 1].power_db < peak.power_db) {
+      if (slot < peaks.size()) {
+        peaks[slot] = peaks[slot - 1];
+      }
+      --slot;
+    }
+    if (slot < peaks.size()) {
+      peaks[slot] = peak;
+      count = std::min(count + 1, peaks.size());
+    }
+  }
+}
+
+}  // namespace
+
+struct SpectrumAnalyzer::Shared
+{
+  struct Segment
+  {
+    std::array<float, SPECTRUM_WINDOW> roll{};
+    std::array<float, SPECTRUM_WINDOW> pitch{};
+    double sample_rate_hz{0.0};
+    uint64_t generation{0};
+  };
+
+  std::atomic<bool> busy{false};
+  std::atomic<uint64_t> generation{0};
+
+  // Segments cut by push() and not yet transformed; the oldest is dropped
+  // when the worker falls a whole average behind
+  std::mutex queue_mutex;
+  std::array<Segment, WELCH_SEGMENTS> queue{};
+  size_t queue_head{0};
+  size_t queue_count{0};
+
+  // Worker state
+  std::array<Segment, WELCH_SEGMENTS> work{};
+  std::array<std::complex<float>, SPECTRUM_WINDOW> buffer{};
+  std::array<std::array<float, SPECTRUM_BINS>, WELCH_SEGMENTS> roll_periodograms{};
+  std::array<std::array<float, SPECTRUM_BINS>, WELCH_SEGMENTS> pitch_periodograms{};
+  size_t stored{0};       // periodograms in the average
+  size_t next_slot{0};    // slot the next periodogram replaces
+  double averaged_rate_hz{0.0};
+  uint64_t averaged_generation{0};
+
+  std::mutex result_mutex;
+  SpectrumResult result;
+  bool fresh{false};
+
+  void enqueue(
+    const std::array<float, SPECTRUM_WINDOW> & roll,
+    const std::array<float, SPECTRUM_WINDOW> & pitch,
+    size_t oldest, double sample_rate_hz);
+  void compute();
+  void addPeriodogram(const Segment & segment);
+};
+
+void SpectrumAnalyzer::Shared::enqueue(
+  const std::array<float, SPECTRUM_WINDOW> & roll,
+  const std::array<float, SPECTRUM_WINDOW> & pitch,
+  size_t oldest, double sample_rate_hz)
+{
+  std::lock_guard<std::mutex> lock(queue_mutex);
+  if (queue_count == WELCH_SEGMENTS) {
+    queue_head = (queue_head + 1) % WELCH_SEGMENTS;
+    --queue_count;
+  }
+  Segment & segment = queue[(queue_head + queue_count) % WELCH_SEGMENTS];
+  ++queue_count;
+
+  // Unrolled from the ring, oldest sample first
+  const size_t tail = SPECTRUM_WINDOW - oldest;
+  std::copy(roll.begin() + oldest, roll.end(), segment.roll.begin());
+  std::copy(roll.begin(), roll.begin() + oldest, segment.roll.begin() + tail);
+  std::copy(pitch.begin() + oldest, pitch.end(), segment.pitch.begin());
+  std::copy(pitch.begin(), pitch.begin() + oldest, segment.pitch.begin() + tail);
+  segment.sample_rate_hz = sample_rate_hz;
+  segment.generation = generation.load();
+}
+
+void SpectrumAnalyzer::Shared::compute()
+{
+  ATTITUDE_PROFILE_SCOPE("SpectrumAnalyzer::compute");
+
+  size_t count = 0;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    for (; count < queue_count; ++count) {
+      work[count] = queue[(queue_head + count) % WELCH_SEGMENTS];
+    }
+    queue_head = 0;
+    queue_count = 0;
+  }
+  if (count == 0) {
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    addPeriodogram(work[i]);
+  }
+
+  // Welch estimate: plain mean of the stored periodograms
+  SpectrumResult next;
+  next.valid = true;
+  next.sample_rate_hz = averaged_rate_hz;
+  const float weight = 1.0f / static_cast<float>(stored);
+  for (size_t k = 0; k < SPECTRUM_BINS; ++k) {
+    float roll_sum = 0.0f;
+    float pitch_sum = 0.0f;
+    for (size_t s = 0; s < stored; ++s) {
+      roll_sum += roll_periodograms[s][k];
+      pitch_sum += pitch_periodograms[s][k];
+    }
+    next.roll_db[k] = 10.0f * std::log10(roll_sum * weight + PSD_FLOOR);
+    next.pitch_db[k] = 10.0f * std::log10(pitch_sum * weight + PSD_FLOOR);
+  }
+  const double bin_hz = averaged_rate_hz / SPECTRUM_WINDOW;
+  findPeaks(next.roll_db, bin_hz, next.roll_peaks, next.roll_peak_count);
+  findPeaks(next.pitch_db, bin_hz, next.pitch_peaks, next.pitch_peak_count);
+
+  std::lock_guard<std::mutex> lock(result_mutex);
+  if (averaged_generation == generation.load()) {
+    result = next;
+    fresh = true;
+  }
+}
+
+void SpectrumAnalyzer::Shared::addPeriodogram(const Segment & segment)
+{
+  const auto & window = hannWindow();
+  const size_t n = SPECTRUM_WINDOW;
+
+  float roll_mean = 0.0f;
+  float pitch_mean = 0.0f;
+  for (size_t i = 0; i < n; ++i) {
+    roll_mean += segment.roll[i];
+    pitch_mean += segment.pitch[i];
+  }
+  roll_mean /= n;
+  pitch_mean /= n;
+
+  // Two real signals in one complex transform: z = roll + i * pitch
+  float window_power = 0.0f;
+  for (size_t i = 0; i < n; ++i) {
+    buffer[i] = std::complex<float>(
+      (segment.roll[i] - roll_mean) * window[i], (segment.pitch[i] - pitch_mean) * window[i]);
+    window_power += window[i] * window[i];
+  }
+  fft().transform(buffer);
+
+  // Restart the average when the stream or its rate changed
+  if (stored == 0 || averaged_generation != segment.generation ||
+    std::abs(segment.sample_rate_hz - averaged_rate_hz) > 0.1 * averaged_rate_hz)
+  {
+    stored = 0;
+    next_slot = 0;
+  }
+  averaged_rate_hz = segment.sample_rate_hz;
+  averaged_generation = segment.generation;
+
+  auto & roll_psd = roll_periodograms[next_slot];
+  auto & pitch_psd = pitch_periodograms[next_slot];
+  next_slot = (next_slot + 1) % WELCH_SEGMENTS;
+  stored = std::min(stored + 1, WELCH_SEGMENTS);
+
+  const float scale = static_cast<float>(1.0 / (segment.sample_rate_hz * window_power));
+  for (size_t k = 0; k < SPECTRUM_BINS; ++k) {
+    const std::complex<float> z = buffer[k];
+    const std::complex<float> z_mirror = std::conj(buffer[(n - k) % n]);
+    const std::complex<float> r = 0.5f * (z + z_mirror);
+    const std::complex<float> p = std::complex<float>(0.0f, -0.5f) * (z - z_mirror);
+
+    // One-sided: interior bins carry the power of their negative twins
+    const float fold = (k == 0 || k == n / 2) ? 1.0f : 2.0f;
+    roll_psd[k] = std::norm(r) * scale * fold;
+    pitch_psd[k] = std::norm(p) * scale * fold;
+  }
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+: shared_(std::make_shared<Shared>())
+{
+  reset();
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() = default;
+
+void SpectrumAnalyzer::reset()
+{
+  roll_.fill(0.0f);
+  pitch_.fill(0.0f);
+  time_ns_.fill(0);
+  head_ = 0;
+  count_ = 0;
+  since_segment_ = 0;
+  queued_ = 0;
+  last_job_ns_ = 0;
+  has_previous_angles_ = false;
+  previous_time_ns_ = 0;
+  previous_roll_ = 0.0;
+  previous_pitch_ = 0.0;
+
+  // A job still in flight will not publish into the new stream
+  shared_->generation.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> lock(shared_->queue_mutex);
+    shared_->queue_head = 0;
+    shared_->queue_count = 0;
+  }
+  std::lock_guard<std::mutex> lock(shared_->result_mutex);
+  shared_->result = SpectrumResult();
+  shared_->fresh = true;
+}
+
+void SpectrumAnalyzer::push(int64_t time_ns, double roll_rate, double pitch_rate)
+{
+  roll_[head_] = static_cast<float>(roll_rate);
+  pitch_[head_] = static_cast<float>(pitch_rate);
+  time_ns_[head_] = time_ns;
+  head_ = (head_ + 1) % SPECTRUM_WINDOW;
+  count_ = std::min(count_ + 1, SPECTRUM_WINDOW);
+  ++since_segment_;
+  if (count_ < SPECTRUM_WINDOW || since_segment_ < HOP) {
+    return;
+  }
+
+  // Every HOP samples the full ring becomes a segment; oldest sample at head_.
+  // A window with no forward time span is dropped, and the next try waits a
+  // whole hop like any other segment
+  since_segment_ = 0;
+  const int64_t span_ns =
+    time_ns_[(head_ + SPECTRUM_WINDOW - 1) % SPECTRUM_WINDOW] - time_ns_[head_];
+  if (span_ns <= 0) {
+    return;
+  }
+  shared_->enqueue(roll_, pitch_, head_, (SPECTRUM_WINDOW - 1) / (span_ns * 1e-9));
+  ++queued_;
+}
+
+void SpectrumAnalyzer::pushAngles(int64_t time_ns, double roll, double pitch)
+{
+  if (has_previous_angles_ && time_ns > previous_time_ns_) {
+    const double dt = (time_ns - previous_time_ns_) * 1e-9;
+    push(
+      time_ns,
+      wrapAngle(roll - previous_roll_) / dt,
+      wrapAngle(pitch - previous_pitch_) / dt);
+  }
+  has_previous_angles_ = true;
+  previous_time_ns_ = time_ns;
+  previous_roll_ = roll;
+  previous_pitch_ = pitch;
+}
+
+void SpectrumAnalyzer::poll(int64_t now_ns)
+{
+  if (queued_ == 0 || now_ns - last_job_ns_ < MIN_INTERVAL_NS) {
+    return;
+  }
+
+  Shared & shared = *shared_;
+  bool expected = false;
+  if (!shared.busy.compare_exchange_strong(expected, true)) {
+    return;  // previous segments still being transformed
+  }
+  queued_ = 0;
+  last_job_ns_ = now_ns;
+
+  RenderPool::post(
+    [state = shared_]() {
+      state->compute();
+      state->busy.store(false);
+    });
+}
+
+bool SpectrumAnalyzer::takeResult(SpectrumResult & result)
+{
+  std::lock_guard<std::mutex> lock(shared_->result_mutex);
+  if (!shared_->fresh) {
+    return false;
+  }
+  result = shared_->result;
+  shared_->fresh = false;
+  return true;
+}
+
+}  // namespace rviz_attitude_plugin
@@ -0,0 +1,7 @@
+/*
+ * Tracepoint probes for the rviz_attitude_plugin provider.
+ */
+
+#define TRACEPOINT_CREATE_PROBES
+#define TRACEPOINT_DEFINE
+#include "rviz_attitude_plugin/tracing/attitude_tracepoints.h"
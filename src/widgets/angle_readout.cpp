@@ -1,4 +1,6 @@
 #include "rviz_attitude_plugin/widgets/angle_readout.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+#include "rviz_attitude_plugin/widgets/hud_fonts.hpp"
 
 #include <QPainter>
 #include <QLinearGradient>
@@ -7,7 +9,11 @@
 #include <QPen>
 #include <QColor>
 #include <QFont>
+#include <QGlyphRun>
+#include <QRawFont>
 #include <QRectF>
+#include <QStaticText>
+#include <QTransform>
 #include <QPointF>
 #include <QSizePolicy>
 #include <algorithm>
@@ -25,7 +31,8 @@ AngleReadout::AngleReadout(
   color_(color),
   title_(title),
   value_("0.0"),
-  r_(59), g_(130), b_(246)
+  r_(59), g_(130), b_(246),
+  renderer_(std::make_shared<AngleReadoutRenderer>())
 {
   setObjectName("AngleReadout");
   parseColor();
@@ -33,10 +40,14 @@ AngleReadout::AngleReadout(
   setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 }
 
-void AngleReadout::setValue(const QString & text)
+bool AngleReadout::setValue(const QString & text)
 {
+  if (text == value_) {
+    return false;
+  }
   value_ = text;
   update();
+  return true;
 }
 
 void AngleReadout::setColor(const QString & color)
@@ -70,29 +81,115 @@ void AngleReadout::parseColor()
   }
 }
 
+ComponentFrame AngleReadout::frame() const
+{
+  return makeFrame(renderer_, size(), AngleReadoutRenderer::State{title_, value_, r_, g_, b_});
+}
+
 void AngleReadout::paintEvent(QPaintEvent * /*event*/)
 {
   QPainter painter(this);
-  painter.setRenderHint(QPainter::Antialiasing);
-  painter.setRenderHint(QPainter::TextAntialiasing);
+  frame()(painter);
+}
+
+// ============================================================================
+// AngleReadoutRenderer Implementation
+// ============================================================================
 
-  const int width = this->width();
-  const int height = this->height();
+AngleReadoutRenderer::AngleReadoutRenderer()
+: glyph_indexes_{},
+  glyph_advances_{}
+{
+}
+
+void AngleReadoutRenderer::rebuildTextCache(
+  const QSize & size, const QString & title, double scale)
+{
+  const int title_font_size = std::max(10, static_cast<int>(scale * 9));
+  title_font_ = HudFonts::monospace(title_font_size, QFont::Bold);
+  title_ = title;
+  title_text_.setText(title_.toUpper());
+  title_text_.setTextFormat(Qt::PlainText);
+  title_text_.prepare(QTransform(), title_font_);
+
+  const int value_font_size = std::max(10, static_cast<int>(scale * 20));
+  value_font_ = QRawFont::fromFont(HudFonts::monospace(value_font_size, QFont::Bold));
+
+  // Glyphs for every character the formatted angle can contain
+  glyph_indexes_.fill(0);
+  glyph_advances_.fill(0.0);
+  if (value_font_.isValid()) {
+    static const QString charset = QString::fromUtf8("0123456789+-.° ");
+    const QVector<quint32> indexes = value_font_.glyphIndexesForString(charset);
+    const QVector<QPointF> advances = value_font_.advancesForGlyphIndexes(indexes);
+    for (int i = 0; i < charset.size() && i < indexes.size(); ++i) {
+      const ushort code = charset.at(i).unicode();
+      glyph_indexes_[code] = indexes[i];
+      glyph_advances_[code] = advances[i].x();
+    }
+  }
+
+  text_cache_size_ = size;
+}
+
+bool AngleReadoutRenderer::layoutValue(const QString & value, QGlyphRun & run, qreal & width)
+{
+  if (!value_font_.isValid()) {
+    return false;
+  }
+
+  run_indexes_.resize(0);
+  run_positions_.resize(0);
+  qreal x = 0.0;
+  for (const QChar ch : value) {
+    const ushort code = ch.unicode();
+    if (code >= glyph_indexes_.size() || glyph_indexes_[code] == 0) {
+      return false;
+    }
+    run_indexes_.append(glyph_indexes_[code]);
+    run_positions_.append(QPointF(x, 0.0));
+    x += glyph_advances_[code];
+  }
+
+  run.setRawFont(value_font_);
+  run.setGlyphIndexes(run_indexes_);
+  run.setPositions(run_positions_);
+  width = x;
+  return true;
+}
+
+void AngleReadoutRenderer::paint(QPainter & painter, const QSize & size, const State & state)
+{
+  ATTITUDE_PROFILE_SCOPE("AngleReadoutRenderer::paint");
+  const int width = size.width();
+  const int height = size.height();
 
   if (width <= 0 || height <= 0) {
     return;
   }
 
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setRenderHint(QPainter::TextAntialiasing);
+
   // Scaling factor tuned for compact rendering
   const double scale = std::min(width / 120.0, height / 70.0);
 
+  if (text_cache_size_ != size || title_ != state.title) {
+    rebuildTextCache(size, state.title, scale);
+  }
+  const int r = state.r;
+  const int g = state.g;
+  const int b = state.b;
+
   // Title
   const double title_height = height * 0.30;
-  const int title_font_size = std::max(10, static_cast<int>(scale * 9));
   painter.setPen(QPen(QColor(160, 165, 185)));
-  painter.setFont(QFont("Cascadia Code", title_font_size, QFont::Bold));
+  painter.setFont(title_font_);
   const QRectF title_rect(0, height * 0.04, width, title_height);
-  painter.drawText(title_rect, Qt::AlignCenter, title_.toUpper());
+  const QSizeF title_size = title_text_.size();
+  painter.drawStaticText(
+    title_rect.center() - QPointF(title_size.width() / 2.0, title_size.height() / 2.0),
+    title_text_);
 
   // Display box dimensions
   const double box_top = title_height + height * 0.04;
@@ -148,34 +245,52 @@ void AngleReadout::paintEvent(QPaintEvent * /*event*/)
   const QPointF glow_center = inner_rect.center();
   const double glow_radius = std::min(inner_rect.width(), inner_rect.height()) * 0.4;
   QRadialGradient glow_gradient(glow_center, glow_radius);
-  glow_gradient.setColorAt(0.0, QColor(r_, g_, b_, 50));
-  glow_gradient.setColorAt(0.5, QColor(r_, g_, b_, 20));
-  glow_gradient.setColorAt(1.0, QColor(r_, g_, b_, 0));
+  glow_gradient.setColorAt(0.0, QColor(r, g, b, 50));
+  glow_gradient.setColorAt(0.5, QColor(r, g, b, 20));
+  glow_gradient.setColorAt(1.0, QColor(r, g, b, 0));
   painter.setBrush(QBrush(glow_gradient));
   painter.setPen(Qt::NoPen);
   painter.drawEllipse(glow_center, glow_radius, glow_radius * 0.7);
 
-  // Value text
+  // Value text, drawn from the cached glyphs when possible
+  const double text_shadow_offset = std::max(1.0, scale * 1.0);
+  const QPointF shadow_offset_pt(text_shadow_offset, text_shadow_offset);
+  const QColor shadow_color(0, 0, 0, 100);
+  const QColor glow_color(r, g, b, 30);
+  const QColor text_color = QColor(r, g, b).lighter(110);
+
+  QGlyphRun run;
+  qreal run_width = 0.0;
+  if (layoutValue(state.value, run, run_width)) {
+    const QPointF origin(
+      inner_rect.center().x() - run_width / 2.0,
+      inner_rect.center().y() + (value_font_.ascent() - value_font_.descent()) / 2.0);
+
+    // Text shadow
+    painter.setPen(QPen(shadow_color));
+    painter.drawGlyphRun(origin + shadow_offset_pt, run);
+
+    // Main text with subtle glow
+    painter.setPen(QPen(glow_color, std::max(1.0, scale * 1.5)));
+    painter.drawGlyphRun(origin, run);
+
+    painter.setPen(QPen(text_color));
+    painter.drawGlyphRun(origin, run);
+    return;
+  }
+
+  // Characters outside the cached set: regular text layout
   const int value_font_size = std::max(10, static_cast<int>(scale * 20));
-  const QFont value_font("Consolas", value_font_size, QFont::Bold);
-  painter.setFont(value_font);
+  painter.setFont(HudFonts::monospace(value_font_size, QFont::Bold));
 
-  // Text shadow
-  const double text_shadow_offset = std::max(1.0, scale * 1.0);
-  painter.setPen(QPen(QColor(0, 0, 0, 100)));
-  const QRectF shadow_rect(
-    inner_rect.left() + text_shadow_offset,
-    inner_rect.top() + text_shadow_offset,
-    inner_rect.width(),
-    inner_rect.height());
-  painter.drawText(shadow_rect, Qt::AlignCenter, value_);
-
-  // Main text with subtle glow
-  painter.setPen(QPen(QColor(r_, g_, b_, 30), std::max(1.0, scale * 1.5)));
-  painter.drawText(inner_rect, Qt::AlignCenter, value_);
-
-  painter.setPen(QPen(QColor(r_, g_, b_).lighter(110)));
-  painter.drawText(inner_rect, Qt::AlignCenter, value_);
+  painter.setPen(QPen(shadow_color));
+  painter.drawText(inner_rect.translated(shadow_offset_pt), Qt::AlignCenter, state.value);
+
+  painter.setPen(QPen(glow_color, std::max(1.0, scale * 1.5)));
+  painter.drawText(inner_rect, Qt::AlignCenter, state.value);
+
+  painter.setPen(QPen(text_color));
+  painter.drawText(inner_rect, Qt::AlignCenter, state.value);
 }
 
 }  // namespace widgets
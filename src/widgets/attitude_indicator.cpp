@@ -1,19 +1,22 @@
 
 
 #include "rviz_attitude_plugin/widgets/attitude_indicator.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+#include "rviz_attitude_plugin/widgets/hud_fonts.hpp"
 
 #include <QPainter>
 #include <QPainterPath>
-#include <QLinearGradient>
 #include <QBrush>
 #include <QPen>
 #include <QColor>
 #include <QFont>
 #include <QPolygonF>
+#include <QPoint>
 #include <QPointF>
 #include <QRectF>
 #include <QResizeEvent>
 #include <QSizePolicy>
+#include <QTransform>
 #include <cmath>
 #include <algorithm>
 #include <vector>
@@ -23,12 +26,24 @@ namespace rviz_attitude_plugin
 namespace widgets
 {
 
+// Pixels per degree of pitch: 30 degrees span one radius
+static constexpr double VISIBLE_PITCH_RANGE_DEG = 30.0;
+
+static constexpr double DEG_TO_RAD = M_PI / 180.0;
+
 ArtificialHorizon::ArtificialHorizon(QWidget * parent)
 : QWidget(parent),
   pitch_(0.0),
   roll_(0.0),
+  painted_pitch_(0.0),
+  painted_roll_(0.0),
   background_visible_(true),
-  background_opacity_(1.0)
+  background_opacity_(1.0),
+  show_pitch_ladder_(true),
+  ladder_range_(90.0),
+  ladder_step_(10.0),
+  radius_(0.0),
+  renderer_(std::make_shared<ArtificialHorizonRenderer>())
 {
   setMinimumSize(60, 60);
   setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -47,11 +62,26 @@ void ArtificialHorizon::setRollAngle(double roll)
   update();
 }
 
-void ArtificialHorizon::setAttitude(double pitch, double roll)
+bool ArtificialHorizon::setAttitude(double pitch, double roll)
 {
   pitch_ = std::clamp(pitch, -90.0, 90.0);
   roll_ = roll;
+
+  // Pitch moves the strip by px_per_deg per degree, roll moves the rim by radius per radian
+  const double pitch_px = std::abs(pitch_ - painted_pitch_) * radius_ / VISIBLE_PITCH_RANGE_DEG;
+  const double roll_px = std::abs(roll_ - painted_roll_) * DEG_TO_RAD * radius_;
+  if (pitch_px < PIXEL_QUANTUM && roll_px < PIXEL_QUANTUM) {
+    return false;
+  }
+
   update();
+  return true;
+}
+
+void ArtificialHorizon::resizeEvent(QResizeEvent * event)
+{
+  QWidget::resizeEvent(event);
+  radius_ = ArtificialHorizonRenderer::diskRadius(size());
 }
 
 void ArtificialHorizon::setBackgroundVisible(bool visible)
@@ -66,170 +96,189 @@ void ArtificialHorizon::setBackgroundOpacity(double opacity)
   update();
 }
 
-QSize ArtificialHorizon::sizeHint() const
+void ArtificialHorizon::setShowPitchLadder(bool show)
 {
-  return QSize(160, 160);
+  show_pitch_ladder_ = show;
+  update();
 }
 
-void ArtificialHorizon::paintEvent(QPaintEvent * /*event*/)
+void ArtificialHorizon::setLadderRange(double max_degrees)
 {
-  QPainter painter(this);
-  painter.setRenderHint(QPainter::Antialiasing);
-  painter.setRenderHint(QPainter::SmoothPixmapTransform);
-
-  const int width = this->width();
-  const int height = this->height();
-  const int size = std::min(width, height);
-  const double cx = width / 2.0;
-  const double cy = height / 2.0;
-  const double radius = size / 2.0 - 6.0;
-
-  if (radius <= 0) {
-    return;
-  }
-
-  painter.translate(cx, cy);
-
-  // Clip to circular bezel
-  QPainterPath clip_path;
-  clip_path.addEllipse(QPointF(0, 0), radius, radius);
-  painter.setClipPath(clip_path);
-
-  // Apply opacity if needed
-  if (background_opacity_ < 1.0) {
-    painter.setOpacity(background_opacity_);
-  }
-
-  painter.save();
-  painter.rotate(roll_);
-  if (background_visible_) {
-    drawSkyGround(painter, radius);
-  }
-  painter.restore();
-
-  painter.setClipping(false);
-  drawOuterRing(painter, radius);
+  ladder_range_ = std::clamp(max_degrees, 30.0, 90.0);
+  update();
 }
 
-void ArtificialHorizon::drawSkyGround(QPainter & painter, double radius)
+void ArtificialHorizon::setLadderStep(double step)
 {
-  const double px_per_deg = radius / 30.0;  // 30 degrees visible range
-  const double pitch_offset = -pitch_ * px_per_deg;
-
-  // Sky gradient
-  QLinearGradient sky_gradient(0, -radius, 0, pitch_offset);
-  sky_gradient.setColorAt(0.0, QColor(0, 80, 160));
-  sky_gradient.setColorAt(0.3, QColor(0, 120, 200));
-  sky_gradient.setColorAt(0.7, QColor(30, 150, 220));
-  sky_gradient.setColorAt(1.0, QColor(135, 206, 250));
-
-  // Ground gradient
-  QLinearGradient ground_gradient(0, pitch_offset, 0, radius);
-  ground_gradient.setColorAt(0.0, QColor(85, 140, 85));
-  ground_gradient.setColorAt(0.3, QColor(65, 120, 65));
-  ground_gradient.setColorAt(0.7, QColor(45, 100, 45));
-  ground_gradient.setColorAt(1.0, QColor(25, 80, 25));
-
-  painter.fillRect(
-    QRectF(-radius, -radius, radius * 2, pitch_offset + radius),
-    QBrush(sky_gradient));
-
-  painter.fillRect(
-    QRectF(-radius, pitch_offset, radius * 2, radius - pitch_offset),
-    QBrush(ground_gradient));
+  ladder_step_ = std::clamp(step, 5.0, 20.0);
+  update();
+}
 
-  // Horizon line with glow
-  painter.setPen(QPen(QColor(255, 255, 255, 60), 6));
-  painter.drawLine(QPointF(-radius, pitch_offset), QPointF(radius, pitch_offset));
-  painter.setPen(QPen(QColor(255, 255, 255), 3));
-  painter.drawLine(QPointF(-radius, pitch_offset), QPointF(radius, pitch_offset));
-  painter.setPen(QPen(QColor(255, 255, 100), 1));
-  painter.drawLine(QPointF(-radius, pitch_offset), QPointF(radius, pitch_offset));
+QSize ArtificialHorizon::sizeHint() const
+{
+  return QSize(160, 160);
 }
 
-void ArtificialHorizon::drawOuterRing(QPainter & painter, double radius)
+ComponentFrame ArtificialHorizon::frame()
 {
-  painter.setPen(QPen(QColor(80, 80, 80), 2));
-  painter.setBrush(Qt::NoBrush);
-  painter.drawEllipse(QPointF(0, 0), radius, radius);
+  painted_pitch_ = pitch_;
+  painted_roll_ = roll_;
+  return makeFrame(
+    renderer_, size(),
+    ArtificialHorizonRenderer::State{
+      pitch_, roll_, background_visible_, background_opacity_,
+      show_pitch_ladder_, ladder_range_, ladder_step_});
 }
 
-PitchLadder::PitchLadder(QWidget * parent)
-: QWidget(parent),
-  pitch_(0.0),
-  roll_(0.0),
-  ladder_range_(90.0),
-  ladder_step_(10.0)
+void ArtificialHorizon::paintEvent(QPaintEvent * /*event*/)
 {
-  setAttribute(Qt::WA_TransparentForMouseEvents);
-  setAttribute(Qt::WA_TranslucentBackground);
-  setAutoFillBackground(false);
+  QPainter painter(this);
+  frame()(painter);
 }
 
-void PitchLadder::setPitchAngle(double pitch)
+// ============================================================================
+// ArtificialHorizonRenderer Implementation
+// ============================================================================
+
+ArtificialHorizonRenderer::ArtificialHorizonRenderer()
+: radius_(0.0),
+  strip_radius_(0.0),
+  strip_horizon_y_(0.0),
+  strip_state_()
 {
-  pitch_ = std::clamp(pitch, -90.0, 90.0);
-  update();
 }
 
-void PitchLadder::setRollAngle(double roll)
+double ArtificialHorizonRenderer::diskRadius(const QSize & size)
 {
-  roll_ = roll;
-  update();
+  return std::min(size.width(), size.height()) / 2.0 - 6.0;
 }
 
-void PitchLadder::setLadderRange(double max_degrees)
+void ArtificialHorizonRenderer::rebuildGeometryCache(const QSize & size)
 {
-  ladder_range_ = std::clamp(max_degrees, 30.0, 90.0);
-  update();
+  geometry_size_ = size;
+  radius_ = diskRadius(size);
+
+  // Circular bezel clip, in disk-centred coordinates
+  clip_path_ = QPainterPath();
+  if (radius_ > 0) {
+    clip_path_.addEllipse(QPointF(0, 0), radius_, radius_);
+  }
 }
 
-void PitchLadder::setLadderStep(double step)
+bool ArtificialHorizonRenderer::stripMatches(const State & state) const
 {
-  ladder_step_ = std::clamp(step, 5.0, 20.0);
-  update();
+  return state.background_visible == strip_state_.background_visible &&
+         state.background_opacity == strip_state_.background_opacity &&
+         state.show_pitch_ladder == strip_state_.show_pitch_ladder &&
+         state.ladder_range == strip_state_.ladder_range &&
+         state.ladder_step == strip_state_.ladder_step;
 }
 
-void PitchLadder::paintEvent(QPaintEvent * /*event*/)
+void ArtificialHorizonRenderer::paint(QPainter & painter, const QSize & size, const State & state)
 {
-  QPainter painter(this);
+  ATTITUDE_PROFILE_SCOPE("ArtificialHorizonRenderer::paint");
   painter.setRenderHint(QPainter::Antialiasing);
+  painter.setRenderHint(QPainter::SmoothPixmapTransform);
 
-  const int width = this->width();
-  const int height = this->height();
-  const int size = std::min(width, height);
-  const double cx = width / 2.0;
-  const double cy = height / 2.0;
-  const double radius = size / 2.0 - 6.0;
+  if (size != geometry_size_) {
+    rebuildGeometryCache(size);
+  }
+  const double radius = radius_;
 
   if (radius <= 0) {
     return;
   }
 
-  // Translate to center and rotate for roll
-  painter.translate(cx, cy);
-  painter.rotate(roll_);
+  if (radius != strip_radius_ || !stripMatches(state)) {
+    rebuildStrip(state, radius);
+  }
+
+  const double cx = size.width() / 2.0;
+  const double cy = size.height() / 2.0;
+  const double px_per_deg = radius / VISIBLE_PITCH_RANGE_DEG;
 
-  // Clip to circular area
-  QPainterPath clip_path;
-  clip_path.addEllipse(QPointF(0, 0), radius, radius);
-  painter.setClipPath(clip_path);
+  // Sky/ground disk, rasterized directly and blitted pixel-aligned
+  if (state.background_visible) {
+    const int side = HorizonRasterizer::imageSide(radius);
+    if (disk_.width() != side) {
+      disk_ = QImage(side, side, QImage::Format_ARGB32_Premultiplied);
+    }
+    const QPoint origin(
+      static_cast<int>(std::floor(cx - side / 2.0)),
+      static_cast<int>(std::floor(cy - side / 2.0)));
+    horizon_raster_.render(
+      disk_, QPointF(cx - origin.x(), cy - origin.y()), state.pitch * px_per_deg, state.roll);
+    painter.drawImage(origin, disk_);
+  }
 
-  const double px_per_deg = radius / 30.0;  // 30 degrees visible range
-  painter.setFont(QFont("Arial", 8, QFont::Bold));
+  // The frame may be drawn translated (e.g. into a larger image)
+  const QTransform centre = QTransform::fromTranslate(cx, cy) * painter.transform();
+  painter.setTransform(centre);
+
+  // Ladder: one blit, the strip row of the current pitch lands on the disk centre
+  if (state.show_pitch_ladder) {
+    painter.setClipPath(clip_path_);
+    painter.rotate(state.roll);
+    painter.drawImage(
+      QPointF(-strip_.width() / 2.0, -strip_horizon_y_ - state.pitch * px_per_deg),
+      strip_);
+    painter.setTransform(centre);
+    painter.setClipping(false);
+  }
+
+  // Apply opacity if needed
+  if (state.background_opacity < 1.0) {
+    painter.setOpacity(state.background_opacity);
+  }
+  drawOuterRing(painter, radius);
+}
+
+void ArtificialHorizonRenderer::rebuildStrip(const State & state, double radius)
+{
+  // Tall enough that the disk stays covered at ±90° of pitch
+  const double px_per_deg = radius / VISIBLE_PITCH_RANGE_DEG;
+  const int margin = 2;
+  const int strip_width = static_cast<int>(std::ceil(radius * 2.0)) + 2 * margin;
+  const int strip_height = static_cast<int>(std::ceil(180.0 * px_per_deg + radius * 2.0)) + 2 * margin;
+
+  strip_radius_ = radius;
+  strip_horizon_y_ = 90.0 * px_per_deg + radius + margin;
+  strip_state_ = state;
+
+  if (state.background_visible) {
+    horizon_raster_.configure(radius, state.background_opacity);
+  }
+
+  if (!state.show_pitch_ladder) {
+    strip_ = QImage();
+    return;
+  }
+
+  strip_ = QImage(strip_width, strip_height, QImage::Format_ARGB32_Premultiplied);
+  strip_.fill(Qt::transparent);
+
+  QPainter painter(&strip_);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setRenderHint(QPainter::TextAntialiasing);
+  painter.translate(strip_width / 2.0, strip_horizon_y_);
+  drawPitchLadder(painter, state, radius);
+}
+
+void ArtificialHorizonRenderer::drawPitchLadder(
+  QPainter & painter, const State & state, double radius)
+{
+  const double px_per_deg = radius / VISIBLE_PITCH_RANGE_DEG;
+  painter.setFont(HudFonts::sans(8, QFont::Bold));
 
   // Draw ladder lines
-  for (int angle = -static_cast<int>(ladder_range_); 
-       angle <= static_cast<int>(ladder_range_); 
-       angle += static_cast<int>(ladder_step_)) {
+  for (int angle = -static_cast<int>(state.ladder_range);
+       angle <= static_cast<int>(state.ladder_range);
+       angle += static_cast<int>(state.ladder_step)) {
     if (angle == 0) {
-      continue;  // Skip horizon line (drawn by ArtificialHorizon)
+      continue;  // Skip horizon line (part of the rasterized disk)
     }
 
-    const double y = -angle * px_per_deg - pitch_ * px_per_deg;
-    if (std::abs(y) > radius) {
-      continue;
-    }
+    const double y = -angle * px_per_deg;
 
     // Determine line length and width based on angle
     double length = (angle % 30 == 0) ? 40.0 : 25.0;
@@ -259,13 +308,21 @@ void PitchLadder::paintEvent(QPaintEvent * /*event*/)
   }
 }
 
+void ArtificialHorizonRenderer::drawOuterRing(QPainter & painter, double radius)
+{
+  painter.setPen(QPen(QColor(80, 80, 80), 2));
+  painter.setBrush(Qt::NoBrush);
+  painter.drawEllipse(QPointF(0, 0), radius, radius);
+}
+
 // ============================================================================
 // AircraftReference Implementation
 // ============================================================================
 
 AircraftReference::AircraftReference(QWidget * parent)
 : QWidget(parent),
-  color_(255, 200, 0)  // Yellow/amber color
+  color_(255, 200, 0),  // Yellow/amber color
+  renderer_(std::make_shared<AircraftReferenceRenderer>())
 {
   setAttribute(Qt::WA_TransparentForMouseEvents);
   setAttribute(Qt::WA_TranslucentBackground);
@@ -278,40 +335,60 @@ void AircraftReference::setColor(const QColor & color)
   update();
 }
 
+ComponentFrame AircraftReference::frame() const
+{
+  return makeFrame(renderer_, size(), AircraftReferenceRenderer::State{color_});
+}
+
 void AircraftReference::paintEvent(QPaintEvent * /*event*/)
 {
   QPainter painter(this);
-  painter.setRenderHint(QPainter::Antialiasing);
+  frame()(painter);
+}
 
-  const int width = this->width();
-  const int height = this->height();
-  const int size = std::min(width, height);
-  const double cx = width / 2.0;
-  const double cy = height / 2.0;
-  const double radius = size / 2.0 - 6.0;
+AircraftReferenceRenderer::AircraftReferenceRenderer()
+: radius_(0.0)
+{
+}
 
-  if (radius <= 0) {
+void AircraftReferenceRenderer::rebuildGeometryCache(const QSize & size)
+{
+  geometry_size_ = size;
+  radius_ = std::min(size.width(), size.height()) / 2.0 - 6.0;
+
+  const double wing_length = radius_ * 0.4;
+  wing_lines_ = {
+    // Left wing
+    QLineF(-10, 0, -wing_length, 0),
+    QLineF(-wing_length, -10, -wing_length, 0),
+    // Right wing
+    QLineF(10, 0, wing_length, 0),
+    QLineF(wing_length, -10, wing_length, 0)
+  };
+}
+
+void AircraftReferenceRenderer::paint(QPainter & painter, const QSize & size, const State & state)
+{
+  ATTITUDE_PROFILE_SCOPE("AircraftReferenceRenderer::paint");
+  painter.setRenderHint(QPainter::Antialiasing);
+
+  if (size != geometry_size_) {
+    rebuildGeometryCache(size);
+  }
+  if (radius_ <= 0) {
     return;
   }
 
-  painter.translate(cx, cy);
+  painter.translate(size.width() / 2.0, size.height() / 2.0);
 
   // Draw center dot
-  painter.setPen(QPen(color_, 1));
-  painter.setBrush(QBrush(color_));
+  painter.setPen(QPen(state.color, 1));
+  painter.setBrush(QBrush(state.color));
   painter.drawEllipse(QPointF(0, 0), 4, 4);
 
   // Draw wing indicators
-  const double wing_length = radius * 0.4;
-  painter.setPen(QPen(color_, 3));
-  
-  // Left wing
-  painter.drawLine(QPointF(-10, 0), QPointF(-wing_length, 0));
-  painter.drawLine(QPointF(-wing_length, -10), QPointF(-wing_length, 0));
-  
-  // Right wing
-  painter.drawLine(QPointF(10, 0), QPointF(wing_length, 0));
-  painter.drawLine(QPointF(wing_length, -10), QPointF(wing_length, 0));
+  painter.setPen(QPen(state.color, 3));
+  painter.drawLines(wing_lines_);
 }
 
 // ============================================================================
@@ -321,7 +398,9 @@ void AircraftReference::paintEvent(QPaintEvent * /*event*/)
 RollIndicator::RollIndicator(QWidget * parent)
 : QWidget(parent),
   roll_(0.0),
-  scale_factor_(1.0)
+  painted_roll_(0.0),
+  radius_(0.0),
+  renderer_(std::make_shared<RollIndicatorRenderer>())
 {
   setAttribute(Qt::WA_TransparentForMouseEvents);
   setAttribute(Qt::WA_TranslucentBackground);
@@ -329,31 +408,79 @@ RollIndicator::RollIndicator(QWidget * parent)
 }
 
 void RollIndicator::setRollAngle(double roll)
+{
+  updateRoll(roll);
+}
+
+bool RollIndicator::updateRoll(double roll)
 {
   roll_ = roll;
+
+  // The pointer sits on the rim
+  if (std::abs(roll_ - painted_roll_) * DEG_TO_RAD * radius_ < PIXEL_QUANTUM) {
+    return false;
+  }
+
   update();
+  return true;
+}
+
+void RollIndicator::resizeEvent(QResizeEvent * event)
+{
+  QWidget::resizeEvent(event);
+  radius_ = RollIndicatorRenderer::trackRadius(size());
+}
+
+ComponentFrame RollIndicator::frame()
+{
+  painted_roll_ = roll_;
+  return makeFrame(renderer_, size(), RollIndicatorRenderer::State{roll_});
 }
 
 void RollIndicator::paintEvent(QPaintEvent * /*event*/)
 {
   QPainter painter(this);
-  painter.setRenderHint(QPainter::Antialiasing);
+  frame()(painter);
+}
 
-  const int width = this->width();
-  const int height = this->height();
-  const int size = std::min(width, height);
-  const double cx = width / 2.0;
-  const double cy = height / 2.0;
-  const double radius = size / 2.0 - 6.0;
+RollIndicatorRenderer::RollIndicatorRenderer()
+: scale_factor_(1.0),
+  radius_(0.0)
+{
+}
 
-  if (radius <= 0) {
+double RollIndicatorRenderer::trackRadius(const QSize & size)
+{
+  return std::min(size.width(), size.height()) / 2.0 - 6.0;
+}
+
+void RollIndicatorRenderer::rebuildGeometryCache(const QSize & size)
+{
+  const int side = std::min(size.width(), size.height());
+  geometry_size_ = size;
+  radius_ = trackRadius(size);
+  scale_factor_ = side > 0 ? side / 250.0 : 1.0;
+
+  // Pointer at zero roll; painting only rotates it
+  pointer_.clear();
+  pointer_ << QPointF(0, -radius_ + 3)
+           << QPointF(-8, -radius_ + 15)
+           << QPointF(8, -radius_ + 15);
+}
+
+void RollIndicatorRenderer::paint(QPainter & painter, const QSize & size, const State & state)
+{
+  ATTITUDE_PROFILE_SCOPE("RollIndicatorRenderer::paint");
+  painter.setRenderHint(QPainter::Antialiasing);
+
+  if (size != geometry_size_) {
+    rebuildGeometryCache(size);
+  }
+  if (radius_ <= 0) {
     return;
   }
 
-  scale_factor_ = size > 0 ? size / 250.0 : 1.0;
-
-  painter.translate(cx, cy);
-  painter.save();
+  painter.translate(size.width() / 2.0, size.height() / 2.0);
 
   // // Draw tick marks
   // const std::vector<int> angles = {-60, -45, -30, -20, -10, 0, 10, 20, 30, 45, 60};
@@ -418,19 +545,11 @@ void RollIndicator::paintEvent(QPaintEvent * /*event*/)
   //   painter.restore();
   // }
 
-  painter.restore();
-
   // Draw roll pointer triangle (rotates with roll)
-  painter.save();
-  painter.rotate(roll_);
+  painter.rotate(state.roll);
   painter.setPen(QPen(QColor(255, 200, 0), 2));
   painter.setBrush(QBrush(QColor(255, 200, 0)));
-  QPolygonF triangle;
-  triangle << QPointF(0, -radius + 3)
-           << QPointF(-8, -radius + 15)
-           << QPointF(8, -radius + 15);
-  painter.drawPolygon(triangle);
-  painter.restore();
+  painter.drawPolygon(pointer_);
 }
 
 // ============================================================================
@@ -455,42 +574,56 @@ AttitudeIndicator::AttitudeIndicator(QWidget * parent)
 
 void AttitudeIndicator::setupComponents()
 {
-  // Create all components
+  // Create all components (the pitch ladder is part of the horizon strip)
   horizon_ = new ArtificialHorizon(this);
-  pitch_ladder_ = new PitchLadder(this);
   aircraft_ref_ = new AircraftReference(this);
   roll_indicator_ = new RollIndicator(this);
 
   // Stack them in the correct order (bottom to top)
   horizon_->setGeometry(rect());
-  pitch_ladder_->setGeometry(rect());
   aircraft_ref_->setGeometry(rect());
   roll_indicator_->setGeometry(rect());
 
   // Raise components in correct stacking order
   horizon_->lower();
-  pitch_ladder_->raise();
   aircraft_ref_->raise();
   roll_indicator_->raise();
 
   // Apply initial visibility settings
-  pitch_ladder_->setVisible(show_pitch_ladder_);
+  horizon_->setShowPitchLadder(show_pitch_ladder_);
   aircraft_ref_->setVisible(show_aircraft_ref_);
   roll_indicator_->setVisible(show_roll_indicator_);
 }
 
-void AttitudeIndicator::setAttitude(double pitch, double roll)
+bool AttitudeIndicator::setAttitude(double pitch, double roll)
 {
-  horizon_->setAttitude(pitch, roll);
-  pitch_ladder_->setPitchAngle(pitch);
-  pitch_ladder_->setRollAngle(roll);
-  roll_indicator_->setRollAngle(roll);
+  const bool horizon_changed = horizon_->setAttitude(pitch, roll);
+  const bool roll_changed = roll_indicator_->updateRoll(roll) && show_roll_indicator_;
+  return horizon_changed || roll_changed;
+}
+
+ComponentFrame AttitudeIndicator::frame()
+{
+  std::vector<ComponentFrame> layers = {horizon_->frame()};
+  if (show_aircraft_ref_) {
+    layers.push_back(aircraft_ref_->frame());
+  }
+  if (show_roll_indicator_) {
+    layers.push_back(roll_indicator_->frame());
+  }
+  return [layers = std::move(layers)](QPainter & painter) {
+      for (const ComponentFrame & layer : layers) {
+        painter.save();
+        layer(painter);
+        painter.restore();
+      }
+    };
 }
 
 void AttitudeIndicator::setShowPitchLadder(bool show)
 {
   show_pitch_ladder_ = show;
-  pitch_ladder_->setVisible(show);
+  horizon_->setShowPitchLadder(show);
 }
 
 void AttitudeIndicator::setShowRollIndicator(bool show)
@@ -508,13 +641,13 @@ void AttitudeIndicator::setShowAircraftReference(bool show)
 void AttitudeIndicator::setPitchLadderRange(double max_degrees)
 {
   pitch_ladder_range_ = max_degrees;
-  pitch_ladder_->setLadderRange(max_degrees);
+  horizon_->setLadderRange(max_degrees);
 }
 
 void AttitudeIndicator::setPitchLadderStep(double step)
 {
   pitch_ladder_step_ = step;
-  pitch_ladder_->setLadderStep(step);
+  horizon_->setLadderStep(step);
 }
 
 void AttitudeIndicator::setBackgroundVisible(bool visible)
@@ -544,7 +677,6 @@ void AttitudeIndicator::updateComponentGeometry()
 {
   QRect r = rect();
   horizon_->setGeometry(r);
-  pitch_ladder_->setGeometry(r);
   aircraft_ref_->setGeometry(r);
   roll_indicator_->setGeometry(r);
 }
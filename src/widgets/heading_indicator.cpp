@@ -1,4 +1,6 @@
 #include "rviz_attitude_plugin/widgets/heading_indicator.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+#include "rviz_attitude_plugin/widgets/hud_fonts.hpp"
 
 #include <QPainter>
 #include <QLinearGradient>
@@ -8,34 +10,90 @@
 #include <QPen>
 #include <QColor>
 #include <QFont>
-#include <QFontMetrics>
+#include <QStaticText>
+#include <QTransform>
 #include <QPolygonF>
 #include <QPointF>
 #include <QRectF>
+#include <QResizeEvent>
 #include <QSizePolicy>
-#include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
 
 namespace rviz_attitude_plugin
 {
 namespace widgets
 {
 
+// Pre-rotated rose sprites are quantized to this step
+static constexpr int ROSE_STEPS_PER_DEGREE = 2;
+static constexpr int ROSE_STEP_COUNT = 360 * ROSE_STEPS_PER_DEGREE;
+
+// Most a full pre-rotated cache may take; larger roses use rotated blits.
+// 16 MiB holds all 720 sprites up to about 75 px, a rose radius of ~50 px.
+static constexpr size_t ROSE_CACHE_MAX_BYTES = size_t(16) << 20;
+
+// Most the pre-rotated caches of all indicators in the process may take
+// together; once it is spent, uncached angles use rotated blits
+static constexpr size_t ROSE_CACHE_TOTAL_BYTES = size_t(64) << 20;
+
+namespace
+{
+
+std::atomic<size_t> rose_cache_bytes{0};
+
+bool chargeRoseCache(size_t bytes)
+{
+  size_t used = rose_cache_bytes.load(std::memory_order_relaxed);
+  do {
+    if (used + bytes > ROSE_CACHE_TOTAL_BYTES) {
+      return false;
+    }
+  } while (!rose_cache_bytes.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+  return true;
+}
+
+}  // namespace
+
+// Half-extent of the rose (chevron tip plus glow) relative to its radius
+static constexpr double ROSE_EXTENT = 0.7;
+
 HeadingIndicator::HeadingIndicator(QWidget * parent)
 : QWidget(parent),
   yaw_(0.0),
-  scale_factor_(1.0)
+  painted_yaw_(0.0),
+  radius_(0.0),
+  rose_cache_mode_(RoseCacheMode::RotatedBlit),
+  renderer_(std::make_shared<HeadingIndicatorRenderer>())
 {
   setMinimumSize(60, 60);
   setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 }
 
-void HeadingIndicator::setHeading(double yaw)
+bool HeadingIndicator::setHeading(double yaw)
 {
   yaw_ = std::fmod(yaw, 360.0);
   if (yaw_ < 0) {
     yaw_ += 360.0;
   }
+
+  // Only the rose turns; its chevron tip is the farthest moving point
+  double delta = std::abs(yaw_ - painted_yaw_);
+  delta = std::min(delta, 360.0 - delta);
+  const double rose_radius = radius_ * 0.75;
+  if (delta * M_PI / 180.0 * rose_radius * ROSE_EXTENT < PIXEL_QUANTUM) {
+    return false;
+  }
+
+  update();
+  return true;
+}
+
+void HeadingIndicator::setRoseCacheMode(RoseCacheMode mode)
+{
+  rose_cache_mode_ = mode;
   update();
 }
 
@@ -44,34 +102,95 @@ QSize HeadingIndicator::sizeHint() const
   return QSize(160, 160);
 }
 
+ComponentFrame HeadingIndicator::frame()
+{
+  painted_yaw_ = yaw_;
+  return makeFrame(renderer_, size(), HeadingIndicatorRenderer::State{yaw_, rose_cache_mode_});
+}
+
 void HeadingIndicator::paintEvent(QPaintEvent * /*event*/)
 {
   QPainter painter(this);
+  frame()(painter);
+}
+
+void HeadingIndicator::resizeEvent(QResizeEvent * event)
+{
+  QWidget::resizeEvent(event);
+  radius_ = HeadingIndicatorRenderer::dialRadius(size());
+}
+
+// ============================================================================
+// HeadingIndicatorRenderer Implementation
+// ============================================================================
+
+HeadingIndicatorRenderer::HeadingIndicatorRenderer()
+: scale_factor_(1.0),
+  rose_radius_(0.0),
+  rotated_bytes_(0),
+  radius_(0.0)
+{
+}
+
+HeadingIndicatorRenderer::~HeadingIndicatorRenderer()
+{
+  dropRotatedRoses();
+}
+
+double HeadingIndicatorRenderer::dialRadius(const QSize & size)
+{
+  return std::min(size.width(), size.height()) / 2.0 - 6.0;
+}
+
+void HeadingIndicatorRenderer::paint(QPainter & painter, const QSize & size, const State & state)
+{
+  ATTITUDE_PROFILE_SCOPE("HeadingIndicatorRenderer::paint");
   painter.setRenderHint(QPainter::Antialiasing);
   painter.setRenderHint(QPainter::SmoothPixmapTransform);
 
-  const int width = this->width();
-  const int height = this->height();
-  const int size = std::min(width, height);
-  const double cx = width / 2.0;
-  const double cy = height / 2.0;
-  const double radius = size / 2.0 - 6.0;
-
-  scale_factor_ = size > 0 ? size / 250.0 : 1.0;
+  if (size != geometry_size_) {
+    rebuildGeometryCache(size);
+  }
 
-  painter.translate(cx, cy);
+  // Switching back to rotated blits frees the pre-rotated copies
+  if (state.rose_cache_mode != HeadingIndicator::RoseCacheMode::PreRotated &&
+    !rotated_roses_.empty())
+  {
+    dropRotatedRoses();
+  }
 
-  draw3DCompassBezel(painter, radius);
+  painter.drawImage(0, 0, bezel_sprite_);
+  painter.translate(size.width() / 2.0, size.height() / 2.0);
+  drawRotatingCompassRose(painter, radius_ * 0.75, state);
+  drawFixedOuterRing(painter);
+}
 
-  painter.save();
-  painter.rotate(-yaw_);
-  drawRotatingCompassRose(painter, radius * 0.75);
-  painter.restore();
+void HeadingIndicatorRenderer::rebuildGeometryCache(const QSize & size)
+{
+  const int side = std::min(size.width(), size.height());
+  geometry_size_ = size;
+  radius_ = dialRadius(size);
+  scale_factor_ = side > 0 ? side / 250.0 : 1.0;
+  rebuildDialCache(radius_);
+  rebuildBezelSprite();
+}
 
-  drawFixedOuterRing(painter, radius);
+void HeadingIndicatorRenderer::rebuildBezelSprite()
+{
+  // Indicator-sized, so it is blitted at the origin without resampling
+  const int width = geometry_size_.width();
+  const int height = geometry_size_.height();
+  bezel_sprite_ = QImage(
+    std::max(1, width), std::max(1, height), QImage::Format_ARGB32_Premultiplied);
+  bezel_sprite_.fill(Qt::transparent);
+
+  QPainter painter(&bezel_sprite_);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.translate(width / 2.0, height / 2.0);
+  draw3DCompassBezel(painter, radius_);
 }
 
-void HeadingIndicator::draw3DCompassBezel(QPainter & painter, double radius)
+void HeadingIndicatorRenderer::draw3DCompassBezel(QPainter & painter, double radius)
 {
   // Shadow rings
   for (int i = 0; i < 5; ++i) {
@@ -103,7 +222,30 @@ void HeadingIndicator::draw3DCompassBezel(QPainter & painter, double radius)
   painter.drawEllipse(QPointF(0, 0), radius - 5, radius - 5);
 }
 
-void HeadingIndicator::drawFixedOuterRing(QPainter & painter, double radius)
+void HeadingIndicatorRenderer::drawFixedOuterRing(QPainter & painter)
+{
+  painter.setPen(QPen(QColor(180, 180, 180), 2));
+  painter.drawLines(major_ticks_);
+
+  // Cardinal letters at 0/90/180/270
+  painter.setFont(cardinal_font_);
+  painter.setPen(QPen(QColor(255, 255, 255), 1));
+  for (const Label & label : cardinal_labels_) {
+    painter.drawStaticText(label.top_left, label.text);
+  }
+
+  // Degree numbers
+  painter.setFont(degree_font_);
+  painter.setPen(QPen(QColor(160, 160, 160), 1));
+  for (const Label & label : degree_labels_) {
+    painter.drawStaticText(label.top_left, label.text);
+  }
+
+  painter.setPen(QPen(QColor(120, 120, 120), 1.5));
+  painter.drawLines(minor_ticks_);
+}
+
+void HeadingIndicatorRenderer::rebuildDialCache(double radius)
 {
   const double sf = scale_factor_;
   const double major_tick_len = std::max(12.0, 15.0 * sf);
@@ -115,84 +257,145 @@ void HeadingIndicator::drawFixedOuterRing(QPainter & painter, double radius)
   const double cardinal_r = radius - ring_inset - major_tick_len - label_pad;
   const double degree_r = radius - ring_inset - major_tick_len - deg_pad;
 
-  // Cardinal directions
-  const int cardinal_font_size = std::max(8, static_cast<int>(12 * sf));
-  painter.setFont(QFont("Arial", cardinal_font_size, QFont::Bold));
-  const QFontMetrics fm_card = painter.fontMetrics();
+  // Radial tick from the ring inward: major every 30°, minor every 10° between
+  major_ticks_.clear();
+  minor_ticks_.clear();
+  for (int angle = 0; angle < 360; angle += 10) {
+    const double angle_rad = angle * M_PI / 180.0;
+    const QPointF direction(std::sin(angle_rad), -std::cos(angle_rad));
+    const double outer = radius - ring_inset;
+    const bool major = angle % 30 == 0;
+    const double inner = outer - (major ? major_tick_len : minor_tick_len);
+    (major ? major_ticks_ : minor_ticks_).append(QLineF(direction * outer, direction * inner));
+  }
+
+  cardinal_font_ = HudFonts::sans(std::max(8, static_cast<int>(12 * sf)), QFont::Bold);
+  degree_font_ = HudFonts::sans(std::max(6, static_cast<int>(8 * sf)), QFont::Normal);
+
+  // Text centred at `distance` from the dial centre along `angle`, kept upright
+  auto make_label = [](const QString & text, const QFont & font, double distance, int angle) {
+      Label label;
+      label.text.setText(text);
+      label.text.setTextFormat(Qt::PlainText);
+      label.text.prepare(QTransform(), font);
+
+      const double angle_rad = angle * M_PI / 180.0;
+      const QPointF center(distance * std::sin(angle_rad), -distance * std::cos(angle_rad));
+      const QSizeF size = label.text.size();
+      label.top_left = center - QPointF(size.width() / 2.0, size.height() / 2.0);
+      return label;
+    };
 
   const std::map<int, QString> cardinal_directions = {
     {0, "E"}, {90, "S"}, {180, "W"}, {270, "N"}
   };
 
-  for (int angle = 0; angle < 360; angle += 30) {
-    // Major tick every 30°
-    painter.save();
-    painter.rotate(angle);
-    painter.setPen(QPen(QColor(180, 180, 180), 2));
-    painter.drawLine(
-      QPointF(0, -radius + ring_inset),
-      QPointF(0, -radius + ring_inset + major_tick_len));
-    painter.restore();
-
-    // Cardinal letters at 0/90/180/270
-    if (cardinal_directions.count(angle)) {
-      const QString text = cardinal_directions.at(angle);
-      const int text_w = std::max(20, static_cast<int>(30 * sf));
-      const int text_h = fm_card.height();
-
-      painter.save();
-      painter.rotate(angle);
-      painter.translate(0, -cardinal_r + 18);
-      painter.rotate(-angle);
-      painter.setPen(QPen(QColor(255, 255, 255), 1));
-      painter.drawText(
-        QRectF(-text_w / 2.0, -text_h / 2.0, text_w, text_h),
-        Qt::AlignCenter,
-        text);
-      painter.restore();
-    }
+  cardinal_labels_.clear();
+  for (const auto & [angle, text] : cardinal_directions) {
+    cardinal_labels_.push_back(make_label(text, cardinal_font_, cardinal_r - 18, angle));
   }
 
-  // Degree numbers
-  const int degree_font_size = std::max(6, static_cast<int>(8 * sf));
-  painter.setFont(QFont("Arial", degree_font_size, QFont::Normal));
-  const QFontMetrics fm_deg = painter.fontMetrics();
-
+  degree_labels_.clear();
   for (int angle = 0; angle < 360; angle += 30) {
     int display_angle = angle > 180 ? angle - 360 : angle;
     const QString text = (display_angle == 180 || display_angle == -180)
       ? QString("±180")
       : QString::number(-display_angle);
-    const int text_w = std::max(20, static_cast<int>(30 * sf));
-    const int text_h = fm_deg.height();
-
-    painter.save();
-    painter.rotate(angle);
-    painter.setPen(QPen(QColor(160, 160, 160), 1));
-    painter.translate(0, -degree_r + 2);
-    painter.rotate(-angle);
-    painter.drawText(
-      QRectF(-text_w / 2.0, -text_h / 2.0, text_w, text_h),
-      Qt::AlignCenter,
-      text);
-    painter.restore();
-  }
-
-  // Minor ticks every 10° (except at 30° multiples)
-  for (int angle = 0; angle < 360; angle += 10) {
-    if (angle % 30 != 0) {
-      painter.save();
-      painter.rotate(angle);
-      painter.setPen(QPen(QColor(120, 120, 120), 1.5));
-      painter.drawLine(
-        QPointF(0, -radius + ring_inset),
-        QPointF(0, -radius + ring_inset + minor_tick_len));
-      painter.restore();
+    degree_labels_.push_back(make_label(text, degree_font_, degree_r - 2, angle));
+  }
+}
+
+void HeadingIndicatorRenderer::drawRotatingCompassRose(
+  QPainter & painter, double radius, const State & state)
+{
+  if (radius <= 0) {
+    return;
+  }
+
+  if (radius != rose_radius_ || rose_sprite_.isNull()) {
+    rebuildRoseSprite(radius);
+  }
+
+  if (state.rose_cache_mode == HeadingIndicator::RoseCacheMode::PreRotated && preRotatedFits()) {
+    if (const QImage * sprite = rotatedRose(-state.yaw)) {
+      painter.drawImage(QPointF(-sprite->width() / 2.0, -sprite->height() / 2.0), *sprite);
+      return;
+    }
+  }
+
+  painter.save();
+  painter.rotate(-state.yaw);
+  painter.drawImage(
+    QPointF(-rose_sprite_.width() / 2.0, -rose_sprite_.height() / 2.0),
+    rose_sprite_);
+  painter.restore();
+}
+
+void HeadingIndicatorRenderer::rebuildRoseSprite(double radius)
+{
+  const int side = static_cast<int>(std::ceil(2.0 * ROSE_EXTENT * radius)) + 4;
+
+  rose_sprite_ = QImage(side, side, QImage::Format_ARGB32_Premultiplied);
+  rose_sprite_.fill(Qt::transparent);
+  rose_radius_ = radius;
+  dropRotatedRoses();
+
+  QPainter painter(&rose_sprite_);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.translate(side / 2.0, side / 2.0);
+  paintCompassRose(painter, radius);
+}
+
+bool HeadingIndicatorRenderer::preRotatedFits() const
+{
+  const size_t side = static_cast<size_t>(rose_sprite_.width());
+  return size_t(ROSE_STEP_COUNT) * side * side * 4u <= ROSE_CACHE_MAX_BYTES;
+}
+
+void HeadingIndicatorRenderer::dropRotatedRoses()
+{
+  rotated_roses_.clear();
+  rotated_roses_.shrink_to_fit();
+  rose_cache_bytes.fetch_sub(rotated_bytes_, std::memory_order_relaxed);
+  rotated_bytes_ = 0;
+}
+
+const QImage * HeadingIndicatorRenderer::rotatedRose(double angle)
+{
+  if (rotated_roses_.size() != static_cast<size_t>(ROSE_STEP_COUNT)) {
+    rotated_roses_.assign(ROSE_STEP_COUNT, QImage());
+  }
+
+  int step = static_cast<int>(std::lround(angle * ROSE_STEPS_PER_DEGREE)) % ROSE_STEP_COUNT;
+  if (step < 0) {
+    step += ROSE_STEP_COUNT;
+  }
+
+  QImage & sprite = rotated_roses_[step];
+  if (sprite.isNull()) {
+    // The rose lies within ROSE_EXTENT of the centre, so any rotation of it
+    // fits the unrotated sprite's square
+    const int side = rose_sprite_.width();
+    const size_t bytes = size_t(side) * side * 4u;
+    if (!chargeRoseCache(bytes)) {
+      return nullptr;
     }
+    rotated_bytes_ += bytes;
+    sprite = QImage(side, side, QImage::Format_ARGB32_Premultiplied);
+    sprite.fill(Qt::transparent);
+
+    QPainter painter(&sprite);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.translate(side / 2.0, side / 2.0);
+    painter.rotate(static_cast<double>(step) / ROSE_STEPS_PER_DEGREE);
+    painter.drawImage(
+      QPointF(-rose_sprite_.width() / 2.0, -rose_sprite_.height() / 2.0),
+      rose_sprite_);
   }
+  return &sprite;
 }
 
-void HeadingIndicator::drawRotatingCompassRose(QPainter & painter, double radius)
+void HeadingIndicatorRenderer::paintCompassRose(QPainter & painter, double radius)
 {
   painter.save();
 
@@ -0,0 +1,315 @@
+#include "rviz_attitude_plugin/widgets/horizon_rasterizer.hpp"
+#include "rviz_attitude_plugin/render_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+// Colour table resolution along the horizon normal
+static constexpr int LUT_STEPS_PER_PX = 4;
+
+// Box filter of one pixel, sampled this many times per table entry
+static constexpr int LUT_SUPERSAMPLES = 8;
+
+// Table margin beyond the gradients, covering the horizon glow
+static constexpr double LUT_PAD_PX = 8.0;
+
+// Rows per worker job; smaller disks are filled on the calling thread
+static constexpr int BAND_ROWS = 64;
+
+namespace
+{
+
+struct Rgba
+{
+  float r, g, b, a;  // premultiplied, 0..1
+};
+
+struct GradientStop
+{
+  float position;
+  float r, g, b;
+};
+
+// Same stops as the former QLinearGradient sky (top to horizon) and ground (horizon down)
+constexpr std::array<GradientStop, 4> SKY_STOPS = {{
+  {0.0f, 0, 80, 160},
+  {0.3f, 0, 120, 200},
+  {0.7f, 30, 150, 220},
+  {1.0f, 135, 206, 250},
+}};
+
+constexpr std::array<GradientStop, 4> GROUND_STOPS = {{
+  {0.0f, 85, 140, 85},
+  {0.3f, 65, 120, 65},
+  {0.7f, 45, 100, 45},
+  {1.0f, 25, 80, 25},
+}};
+
+Rgba sampleGradient(const std::array<GradientStop, 4> & stops, float t)
+{
+  t = std::clamp(t, 0.0f, 1.0f);
+  size_t i = 1;
+  while (i < stops.size() - 1 && t > stops[i].position) {
+    ++i;
+  }
+  const GradientStop & a = stops[i - 1];
+  const GradientStop & b = stops[i];
+  const float f = (t - a.position) / (b.position - a.position);
+  return {
+    (a.r + (b.r - a.r) * f) / 255.0f,
+    (a.g + (b.g - a.g) * f) / 255.0f,
+    (a.b + (b.b - a.b) * f) / 255.0f,
+    1.0f};
+}
+
+// Source-over of a straight-alpha colour onto a premultiplied one
+void blendOver(Rgba & dest, float r, float g, float b, float a)
+{
+  dest.r = r * a + dest.r * (1.0f - a);
+  dest.g = g * a + dest.g * (1.0f - a);
+  dest.b = b * a + dest.b * (1.0f - a);
+  dest.a = a + dest.a * (1.0f - a);
+}
+
+// Disk colour at signed distance s (px) below the horizon line
+Rgba profile(float s, float radius)
+{
+  Rgba colour = s < 0.0f ?
+    sampleGradient(SKY_STOPS, (s + radius) / radius) :
+    sampleGradient(GROUND_STOPS, s / radius);
+
+  // Horizon line: glow, white core, yellow centre (6, 3 and 1 px wide)
+  const float distance = std::abs(s);
+  if (distance < 3.0f) {
+    blendOver(colour, 1.0f, 1.0f, 1.0f, 60.0f / 255.0f);
+  }
+  if (distance < 1.5f) {
+    colour = {1.0f, 1.0f, 1.0f, 1.0f};
+  }
+  if (distance < 0.5f) {
+    colour = {1.0f, 1.0f, 100.0f / 255.0f, 1.0f};
+  }
+  return colour;
+}
+
+uint32_t pack(const Rgba & c)
+{
+  auto channel = [](float v) {
+      return static_cast<uint32_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+    };
+  return (channel(c.a) << 24) | (channel(c.r) << 16) | (channel(c.g) << 8) | channel(c.b);
+}
+
+uint32_t lookup(const uint32_t * lut, size_t size, float index)
+{
+  const float last = static_cast<float>(size - 1);
+  return lut[static_cast<size_t>(std::clamp(index, 0.0f, last) + 0.5f)];
+}
+
+uint32_t scalePixel(uint32_t pixel, float coverage)
+{
+  const uint32_t weight = static_cast<uint32_t>(coverage * 256.0f + 0.5f);
+  const uint32_t rb = (((pixel & 0x00FF00FFu) * weight) >> 8) & 0x00FF00FFu;
+  const uint32_t ag = (((pixel >> 8) & 0x00FF00FFu) * weight) & 0xFF00FF00u;
+  return rb | ag;
+}
+
+}  // namespace
+
+HorizonRasterizer::HorizonRasterizer()
+: radius_(0.0),
+  opacity_(1.0),
+  lut_origin_(0.0f)
+{
+}
+
+int HorizonRasterizer::imageSide(double radius)
+{
+  return static_cast<int>(std::ceil(2.0 * radius)) + 3;
+}
+
+void HorizonRasterizer::configure(double radius, double opacity)
+{
+  radius_ = radius;
+  opacity_ = std::clamp(opacity, 0.0, 1.0);
+
+  // Beyond ±radius both gradients are padded, so the table only spans the disk
+  const double extent = radius + LUT_PAD_PX;
+  const int entries = static_cast<int>(std::ceil(2.0 * extent * LUT_STEPS_PER_PX)) + 1;
+  lut_origin_ = static_cast<float>(-extent);
+  lut_.resize(static_cast<size_t>(std::max(entries, 1)));
+
+  const float r = static_cast<float>(std::max(radius, 1.0));
+  const float alpha = static_cast<float>(opacity_);
+  for (size_t i = 0; i < lut_.size(); ++i) {
+    const float s = lut_origin_ + static_cast<float>(i) / LUT_STEPS_PER_PX;
+
+    // Average over one pixel along the normal, which antialiases the line edges
+    Rgba sum{0, 0, 0, 0};
+    for (int k = 0; k < LUT_SUPERSAMPLES; ++k) {
+      const float offset = (k + 0.5f) / LUT_SUPERSAMPLES - 0.5f;
+      const Rgba c = profile(s + offset, r);
+      sum.r += c.r;
+      sum.g += c.g;
+      sum.b += c.b;
+      sum.a += c.a;
+    }
+    const float weight = alpha / LUT_SUPERSAMPLES;
+    lut_[i] = pack({sum.r * weight, sum.g * weight, sum.b * weight, sum.a * weight});
+  }
+}
+
+void HorizonRasterizer::fillSpan(
+  const uint32_t * lut, size_t size, uint32_t * dest, int count, float index, float step)
+{
+  if (step == 0.0f) {
+    std::fill(dest, dest + count, lookup(lut, size, index));
+    return;
+  }
+
+  int i = 0;
+#if defined(__SSE2__)
+  // Four table indices per iteration, computed as index + i * step like the
+  // scalar loop so both round alike; the gather itself stays scalar
+  const __m128 lo = _mm_setzero_ps();
+  const __m128 hi = _mm_set1_ps(static_cast<float>(size - 1));
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 base = _mm_set1_ps(index);
+  const __m128 steps = _mm_set1_ps(step);
+  const __m128i four = _mm_set1_epi32(4);
+  __m128i counter = _mm_setr_epi32(0, 1, 2, 3);
+  alignas(16) int32_t lanes[4];
+  for (; i + 4 <= count; i += 4) {
+    const __m128 indexes = _mm_add_ps(base, _mm_mul_ps(_mm_cvtepi32_ps(counter), steps));
+    const __m128 clamped = _mm_min_ps(_mm_max_ps(indexes, lo), hi);
+    _mm_store_si128(
+      reinterpret_cast<__m128i *>(lanes), _mm_cvttps_epi32(_mm_add_ps(clamped, half)));
+    const __m128i pixels = _mm_setr_epi32(
+      static_cast<int>(lut[lanes[0]]), static_cast<int>(lut[lanes[1]]),
+      static_cast<int>(lut[lanes[2]]), static_cast<int>(lut[lanes[3]]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), pixels);
+    counter = _mm_add_epi32(counter, four);
+  }
+#endif
+  for (; i < count; ++i) {
+    dest[i] = lookup(lut, size, index + static_cast<float>(i) * step);
+  }
+}
+
+void HorizonRasterizer::fillSpanScalar(
+  const uint32_t * lut, size_t size, uint32_t * dest, int count, float index, float step)
+{
+  for (int i = 0; i < count; ++i) {
+    dest[i] = lookup(lut, size, index + static_cast<float>(i) * step);
+  }
+}
+
+void HorizonRasterizer::render(
+  QImage & target, const QPointF & centre, double pitch_offset, double roll) const
+{
+  if (target.isNull() || target.depth() != 32 || lut_.empty()) {
+    return;
+  }
+
+  const double roll_rad = roll * M_PI / 180.0;
+  Frame frame;
+  frame.pixels = target.bits();  // detach once, before any worker touches rows
+  frame.bytes_per_line = static_cast<size_t>(target.bytesPerLine());
+  frame.width = target.width();
+  frame.centre = centre;
+  frame.pitch_offset = pitch_offset;
+  frame.sin_r = std::sin(roll_rad);
+  frame.cos_r = std::cos(roll_rad);
+
+  // Rows are independent, so large disks are split into bands across the pool
+  const int height = target.height();
+  const int bands = (height + BAND_ROWS - 1) / BAND_ROWS;
+  if (bands < 2) {
+    renderRows(frame, 0, height);
+    return;
+  }
+  RenderPool::parallelFor(
+    bands,
+    [this, &frame, height](int band) {
+      renderRows(frame, band * BAND_ROWS, std::min(height, (band + 1) * BAND_ROWS));
+    });
+}
+
+void HorizonRasterizer::renderRows(const Frame & frame, int y_begin, int y_end) const
+{
+  const QPointF & centre = frame.centre;
+  const double sin_r = frame.sin_r;
+  const double cos_r = frame.cos_r;
+  const double outer_r = radius_ + 0.5;
+  const double inner_r = radius_ - 0.5;
+
+  // Table index = (s - origin) * steps; s = -sin * dx + cos * dy + pitch_offset
+  const float step = static_cast<float>(-sin_r * LUT_STEPS_PER_PX);
+
+  const int width = frame.width;
+  for (int y = y_begin; y < y_end; ++y) {
+    auto * row = reinterpret_cast<uint32_t *>(frame.pixels + y * frame.bytes_per_line);
+    std::fill(row, row + width, 0u);
+
+    const double dy = y + 0.5 - centre.y();
+    if (std::abs(dy) >= outer_r) {
+      continue;
+    }
+
+    const double outer_half = std::sqrt(outer_r * outer_r - dy * dy);
+    const int x_begin = std::max(0, static_cast<int>(std::floor(centre.x() - outer_half)));
+    const int x_end = std::min(width, static_cast<int>(std::ceil(centre.x() + outer_half)));
+
+    // Pixels whose centre lies within radius - 0.5 are fully covered
+    int inner_begin = x_end;
+    int inner_end = x_end;
+    if (inner_r > 0.0 && std::abs(dy) < inner_r) {
+      const double inner_half = std::sqrt(inner_r * inner_r - dy * dy);
+      inner_begin = std::clamp(
+        static_cast<int>(std::ceil(centre.x() - inner_half - 0.5)), x_begin, x_end);
+      inner_end = std::clamp(
+        static_cast<int>(std::floor(centre.x() + inner_half - 0.5)) + 1, inner_begin, x_end);
+    }
+
+    const double row_s = cos_r * dy + frame.pitch_offset;
+    auto index_at = [&](int x) {
+        const double s = row_s - sin_r * (x + 0.5 - centre.x());
+        return static_cast<float>((s - lut_origin_) * LUT_STEPS_PER_PX);
+      };
+
+    auto edge_pixel = [&](int x) {
+        const double dx = x + 0.5 - centre.x();
+        const double coverage = outer_r - std::sqrt(dx * dx + dy * dy);
+        if (coverage > 0.0) {
+          row[x] = scalePixel(
+            lookup(lut_.data(), lut_.size(), index_at(x)),
+            static_cast<float>(std::min(coverage, 1.0)));
+        }
+      };
+
+    for (int x = x_begin; x < inner_begin; ++x) {
+      edge_pixel(x);
+    }
+    if (inner_end > inner_begin) {
+      fillSpan(
+        lut_.data(), lut_.size(), row + inner_begin, inner_end - inner_begin,
+        index_at(inner_begin), step);
+    }
+    for (int x = inner_end; x < x_end; ++x) {
+      edge_pixel(x);
+    }
+  }
+}
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
@@ -0,0 +1,55 @@
+#include "rviz_attitude_plugin/widgets/hud_fonts.hpp"
+
+#include <QFontDatabase>
+#include <QHash>
+
+#include <mutex>
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+QFont HudFonts::sans(int point_size, int weight)
+{
+  static const QStringList candidates = {"Arial", "Liberation Sans", "DejaVu Sans"};
+  return QFont(resolveFamily(candidates, false), point_size, weight);
+}
+
+QFont HudFonts::monospace(int point_size, int weight)
+{
+  static const QStringList candidates = {"Cascadia Code", "Consolas", "DejaVu Sans Mono"};
+  return QFont(resolveFamily(candidates, true), point_size, weight);
+}
+
+QString HudFonts::resolveFamily(const QStringList & candidates, bool fixed_pitch)
+{
+  // Component frames are painted on RenderPool workers too
+  static std::mutex mutex;
+  static QHash<QString, QString> resolved;
+  std::lock_guard<std::mutex> lock(mutex);
+
+  const QString key = candidates.join(',');
+  auto it = resolved.constFind(key);
+  if (it != resolved.constEnd()) {
+    return it.value();
+  }
+
+  const QStringList installed = QFontDatabase().families();
+  QString family;
+  for (const QString & candidate : candidates) {
+    if (installed.contains(candidate, Qt::CaseInsensitive)) {
+      family = candidate;
+      break;
+    }
+  }
+  if (family.isEmpty()) {
+    family = QFontDatabase::systemFont(
+      fixed_pitch ? QFontDatabase::FixedFont : QFontDatabase::GeneralFont).family();
+  }
+
+  return resolved.insert(key, family).value();
+}
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
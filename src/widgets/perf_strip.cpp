@@ -0,0 +1,175 @@
+#include "rviz_attitude_plugin/widgets/perf_strip.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+#include "rviz_attitude_plugin/widgets/hud_fonts.hpp"
+
+#include <QColor>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPen>
+#include <QSizePolicy>
+#include <QTransform>
+
+#include <algorithm>
+#include <cstring>
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+// Sparkline width as a fraction of the strip
+static constexpr double SPARKLINE_FRACTION = 0.28;
+
+// Sparkline full scale never drops below this, so idle noise stays flat
+static constexpr float SPARKLINE_MIN_SCALE_MS = 1.0f;
+
+namespace
+{
+
+QString formatBytes(double bytes_per_s)
+{
+  if (bytes_per_s >= 1024.0 * 1024.0) {
+    return QString("%1MB/s").arg(bytes_per_s / (1024.0 * 1024.0), 0, 'f', 1);
+  }
+  return QString("%1KB/s").arg(bytes_per_s / 1024.0, 0, 'f', 1);
+}
+
+}  // namespace
+
+PerfStrip::PerfStrip(QWidget * parent)
+: QWidget(parent),
+  font_height_(QFontMetrics(HudFonts::monospace(7)).height()),
+  costs_ms_{},
+  cost_count_(0),
+  renderer_(std::make_shared<PerfStripRenderer>())
+{
+  setObjectName("PerfStrip");
+  setAttribute(Qt::WA_TranslucentBackground, true);
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+QSize PerfStrip::sizeHint() const
+{
+  return QSize(200, 2 * font_height_ + 6);
+}
+
+bool PerfStrip::setSnapshot(const PerfSnapshot & snapshot)
+{
+  const QString lines[2] = {
+    QString("IN %1Hz  FPS %2  x%3  p99 %4ms")
+    .arg(snapshot.message_hz, 0, 'f', 0)
+    .arg(snapshot.render_fps, 0, 'f', 0)
+    .arg(snapshot.coalescing, 0, 'f', 1)
+    .arg(snapshot.latency_p99_ms, 0, 'f', 1),
+    QString("RAS %1ms  UP %2ms  %3")
+    .arg(snapshot.raster_ms, 0, 'f', 2)
+    .arg(snapshot.upload_ms, 0, 'f', 2)
+    .arg(formatBytes(snapshot.upload_bytes_per_s)),
+  };
+
+  bool changed = false;
+  for (int i = 0; i < 2; ++i) {
+    if (lines[i] != lines_[i]) {
+      lines_[i] = lines[i];
+      changed = true;
+    }
+  }
+
+  const size_t count = std::min(snapshot.frame_cost_count, costs_ms_.size());
+  if (count != cost_count_ ||
+    std::memcmp(costs_ms_.data(), snapshot.frame_cost_ms.data(), count * sizeof(float)) != 0)
+  {
+    std::copy_n(snapshot.frame_cost_ms.begin(), count, costs_ms_.begin());
+    cost_count_ = count;
+    changed = true;
+  }
+
+  if (changed) {
+    update();
+  }
+  return changed;
+}
+
+ComponentFrame PerfStrip::frame() const
+{
+  return makeFrame(
+    renderer_, size(), PerfStripRenderer::State{{lines_[0], lines_[1]}, costs_ms_, cost_count_});
+}
+
+void PerfStrip::paintEvent(QPaintEvent * /*event*/)
+{
+  QPainter painter(this);
+  frame()(painter);
+}
+
+// ============================================================================
+// PerfStripRenderer Implementation
+// ============================================================================
+
+PerfStripRenderer::PerfStripRenderer()
+: font_(HudFonts::monospace(7)),
+  font_height_(QFontMetrics(font_).height())
+{
+  for (auto & text : line_text_) {
+    text.setTextFormat(Qt::PlainText);
+  }
+  sparkline_.reserve(static_cast<int>(PerfSnapshot::SPARKLINE_LENGTH));
+}
+
+void PerfStripRenderer::paint(QPainter & painter, const QSize & size, const State & state)
+{
+  ATTITUDE_PROFILE_SCOPE("PerfStripRenderer::paint");
+  const int width = size.width();
+  const int height = size.height();
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    if (state.lines[i] != lines_[i]) {
+      lines_[i] = state.lines[i];
+      line_text_[i].setText(lines_[i]);
+      line_text_[i].prepare(QTransform(), font_);
+    }
+  }
+
+  painter.setRenderHint(QPainter::Antialiasing, true);
+
+  const QRectF frame = QRectF(QPointF(0, 0), QSizeF(size)).adjusted(0.5, 0.5, -0.5, -0.5);
+  painter.setPen(QPen(QColor(255, 255, 255, 60), 1.0));
+  painter.setBrush(QColor(12, 12, 16, 200));
+  painter.drawRoundedRect(frame, 4.0, 4.0);
+
+  // Figures
+  painter.setFont(font_);
+  painter.setPen(QColor(190, 230, 190));
+  const double line_top = std::max(1.0, (height - 2.0 * font_height_) / 2.0);
+  for (int i = 0; i < 2; ++i) {
+    painter.drawStaticText(QPointF(6.0, line_top + i * font_height_), line_text_[i]);
+  }
+
+  // Frame cost sparkline, newest at the right edge
+  const size_t cost_count = state.cost_count;
+  if (cost_count < 2) {
+    return;
+  }
+  const double spark_width = width * SPARKLINE_FRACTION;
+  const QRectF area(width - spark_width - 4.0, 3.0, spark_width, height - 6.0);
+  const float scale = std::max(
+    SPARKLINE_MIN_SCALE_MS,
+    *std::max_element(state.costs_ms.begin(), state.costs_ms.begin() + cost_count));
+  const double step = area.width() / (PerfSnapshot::SPARKLINE_LENGTH - 1);
+  const double x0 = area.right() - step * static_cast<double>(cost_count - 1);
+
+  sparkline_.resize(static_cast<int>(cost_count));
+  for (size_t i = 0; i < cost_count; ++i) {
+    sparkline_[static_cast<int>(i)] = QPointF(
+      x0 + step * static_cast<double>(i),
+      area.bottom() - area.height() * std::min(1.0f, state.costs_ms[i] / scale));
+  }
+  painter.setPen(QPen(QColor(250, 204, 21), 1.0));
+  painter.drawPolyline(sparkline_);
+}
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
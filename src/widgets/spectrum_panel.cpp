@@ -0,0 +1,152 @@
+#include "rviz_attitude_plugin/widgets/spectrum_panel.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+#include "rviz_attitude_plugin/widgets/hud_fonts.hpp"
+
+#include <QColor>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPen>
+#include <QSizePolicy>
+#include <QTransform>
+
+#include <algorithm>
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+// Trace colours match the roll and pitch readouts
+static const QColor ROLL_COLOR(0x7D, 0xD3, 0xFC);
+static const QColor PITCH_COLOR(0xBB, 0xF7, 0xD0);
+
+SpectrumPanel::SpectrumPanel(QWidget * parent)
+: QWidget(parent),
+  result_(std::make_shared<const SpectrumResult>()),
+  label_("Spectrum: collecting samples"),
+  font_height_(QFontMetrics(HudFonts::monospace(7)).height()),
+  renderer_(std::make_shared<SpectrumPanelRenderer>())
+{
+  setObjectName("SpectrumPanel");
+  setAttribute(Qt::WA_TranslucentBackground, true);
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+QSize SpectrumPanel::sizeHint() const
+{
+  return QSize(200, font_height_ + 44);
+}
+
+QString SpectrumPanel::peakText(
+  const char * axis, const std::array<SpectrumPeak, SPECTRUM_PEAKS> & peaks, size_t count)
+{
+  QString text = QString::fromLatin1(axis);
+  if (count == 0) {
+    return text + " --";
+  }
+  for (size_t i = 0; i < count; ++i) {
+    text += QString(" %1").arg(peaks[i].frequency_hz, 0, 'f', 1);
+  }
+  return text + "Hz";
+}
+
+void SpectrumPanel::setResult(const SpectrumResult & result)
+{
+  // A frame in flight keeps the previous result alive
+  result_ = std::make_shared<const SpectrumResult>(result);
+  label_ = result.valid ?
+    QString("%1  %2  fs %3Hz")
+    .arg(peakText("R", result.roll_peaks, result.roll_peak_count))
+    .arg(peakText("P", result.pitch_peaks, result.pitch_peak_count))
+    .arg(result.sample_rate_hz, 0, 'f', 0) :
+    QString("Spectrum: collecting samples");
+  update();
+}
+
+ComponentFrame SpectrumPanel::frame() const
+{
+  return makeFrame(renderer_, size(), SpectrumPanelRenderer::State{result_, label_});
+}
+
+void SpectrumPanel::paintEvent(QPaintEvent * /*event*/)
+{
+  QPainter painter(this);
+  frame()(painter);
+}
+
+// ============================================================================
+// SpectrumPanelRenderer Implementation
+// ============================================================================
+
+SpectrumPanelRenderer::SpectrumPanelRenderer()
+: font_(HudFonts::monospace(7)),
+  font_height_(QFontMetrics(font_).height())
+{
+  label_.setTextFormat(Qt::PlainText);
+  roll_trace_.reserve(static_cast<int>(SPECTRUM_BINS));
+  pitch_trace_.reserve(static_cast<int>(SPECTRUM_BINS));
+}
+
+void SpectrumPanelRenderer::buildTrace(
+  const std::array<float, SPECTRUM_BINS> & db, const QRectF & area,
+  float top_db, QPolygonF & trace)
+{
+  // Bin 0 holds the removed mean and is left out
+  const int points = static_cast<int>(SPECTRUM_BINS) - 1;
+  trace.resize(points);
+  const double step = area.width() / std::max(1, points - 1);
+  for (int i = 0; i < points; ++i) {
+    const float level = std::clamp(
+      (top_db - db[static_cast<size_t>(i) + 1]) / SpectrumPanel::DYNAMIC_RANGE_DB, 0.0f, 1.0f);
+    trace[i] = QPointF(area.left() + step * i, area.top() + area.height() * level);
+  }
+}
+
+void SpectrumPanelRenderer::paint(QPainter & painter, const QSize & size, const State & state)
+{
+  ATTITUDE_PROFILE_SCOPE("SpectrumPanelRenderer::paint");
+  const int width = size.width();
+  const int height = size.height();
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+
+  if (state.label != label_.text()) {
+    label_.setText(state.label);
+    label_.prepare(QTransform(), font_);
+  }
+
+  painter.setRenderHint(QPainter::Antialiasing, true);
+
+  const QRectF frame = QRectF(QPointF(0, 0), QSizeF(size)).adjusted(0.5, 0.5, -0.5, -0.5);
+  painter.setPen(QPen(QColor(255, 255, 255, 60), 1.0));
+  painter.setBrush(QColor(12, 12, 16, 200));
+  painter.drawRoundedRect(frame, 4.0, 4.0);
+
+  painter.setFont(font_);
+  painter.setPen(QColor(220, 220, 230));
+  painter.drawStaticText(QPointF(6.0, 2.0), label_);
+
+  const SpectrumResult & result = *state.result;
+  if (!result.valid) {
+    return;
+  }
+
+  const QRectF area(6.0, font_height_ + 4.0, width - 12.0, height - font_height_ - 8.0);
+  painter.setPen(QPen(QColor(255, 255, 255, 40), 1.0));
+  painter.drawLine(area.bottomLeft(), area.bottomRight());
+
+  const float top_db = std::max(
+    *std::max_element(result.roll_db.begin() + 1, result.roll_db.end()),
+    *std::max_element(result.pitch_db.begin() + 1, result.pitch_db.end()));
+  buildTrace(result.roll_db, area, top_db, roll_trace_);
+  buildTrace(result.pitch_db, area, top_db, pitch_trace_);
+
+  painter.setPen(QPen(PITCH_COLOR, 1.0));
+  painter.drawPolyline(pitch_trace_);
+  painter.setPen(QPen(ROLL_COLOR, 1.0));
+  painter.drawPolyline(roll_trace_);
+}
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
@@ -0,0 +1,107 @@
+#include "rviz_attitude_plugin/widgets/stats_readout.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+#include "rviz_attitude_plugin/widgets/hud_fonts.hpp"
+
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPen>
+#include <QSizePolicy>
+#include <QTransform>
+
+#include <algorithm>
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+StatsReadout::StatsReadout(const QString & color, QWidget * parent)
+: QWidget(parent),
+  color_(color),
+  font_height_(QFontMetrics(HudFonts::monospace(7)).height()),
+  renderer_(std::make_shared<StatsReadoutRenderer>())
+{
+  setObjectName("StatsReadout");
+  setAttribute(Qt::WA_TranslucentBackground, true);
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+  if (!color_.isValid()) {
+    color_ = QColor(59, 130, 246);
+  }
+}
+
+QSize StatsReadout::sizeHint() const
+{
+  return QSize(60, 2 * font_height_ + 6);
+}
+
+bool StatsReadout::setLines(const QString & first, const QString & second)
+{
+  if (first == lines_[0] && second == lines_[1]) {
+    return false;
+  }
+  lines_[0] = first;
+  lines_[1] = second;
+  update();
+  return true;
+}
+
+ComponentFrame StatsReadout::frame() const
+{
+  return makeFrame(renderer_, size(), StatsReadoutRenderer::State{color_, {lines_[0], lines_[1]}});
+}
+
+void StatsReadout::paintEvent(QPaintEvent * /*event*/)
+{
+  QPainter painter(this);
+  frame()(painter);
+}
+
+// ============================================================================
+// StatsReadoutRenderer Implementation
+// ============================================================================
+
+StatsReadoutRenderer::StatsReadoutRenderer()
+: font_(HudFonts::monospace(7)),
+  font_height_(QFontMetrics(font_).height())
+{
+  for (auto & text : line_text_) {
+    text.setTextFormat(Qt::PlainText);
+  }
+}
+
+void StatsReadoutRenderer::paint(QPainter & painter, const QSize & size, const State & state)
+{
+  ATTITUDE_PROFILE_SCOPE("StatsReadoutRenderer::paint");
+  const int width = size.width();
+  const int height = size.height();
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    if (state.lines[i] != lines_[i]) {
+      lines_[i] = state.lines[i];
+      line_text_[i].setText(lines_[i]);
+      line_text_[i].prepare(QTransform(), font_);
+    }
+  }
+
+  painter.setRenderHint(QPainter::Antialiasing, true);
+
+  const QRectF frame = QRectF(QPointF(0, 0), QSizeF(size)).adjusted(2.5, 0.5, -2.5, -0.5);
+  painter.setPen(QPen(QColor(65, 70, 85), 1.0));
+  painter.setBrush(QColor(16, 18, 24, 200));
+  painter.drawRoundedRect(frame, 3.0, 3.0);
+
+  painter.setFont(font_);
+  painter.setPen(state.color.lighter(110));
+  const double line_top = std::max(1.0, (height - 2.0 * font_height_) / 2.0);
+  for (int i = 0; i < 2; ++i) {
+    const double line_width = line_text_[i].size().width();
+    painter.drawStaticText(
+      QPointF((width - line_width) / 2.0, line_top + i * font_height_), line_text_[i]);
+  }
+}
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
@@ -0,0 +1,342 @@
+#include "rviz_attitude_plugin/widgets/tape_indicator.hpp"
+#include "rviz_attitude_plugin/profiler.hpp"
+#include "rviz_attitude_plugin/widgets/hud_fonts.hpp"
+
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QPen>
+#include <QPolygonF>
+#include <QResizeEvent>
+#include <QSizePolicy>
+#include <QTransform>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace rviz_attitude_plugin
+{
+namespace widgets
+{
+
+// The strip covers this many tape heights; the window may drift one page
+// either way from the centre before the strip is re-rendered
+static constexpr int STRIP_PAGES = 3;
+
+namespace
+{
+
+QFont titleFont(const QSize & size)
+{
+  const double scale = std::max(0.6, size.height() / 200.0);
+  return HudFonts::monospace(std::max(6, static_cast<int>(7 * scale)), QFont::Bold);
+}
+
+}  // namespace
+
+TapeIndicator::TapeIndicator(const QString & title, Side side, QWidget * parent)
+: QWidget(parent),
+  title_(title),
+  side_(side),
+  visible_span_(40.0),
+  minor_step_(1.0),
+  label_every_(5),
+  decimals_(1),
+  minimum_(-std::numeric_limits<double>::infinity()),
+  value_(0.0),
+  painted_value_(0.0),
+  has_value_(false),
+  text_("---"),
+  pixels_per_unit_(0.0),
+  renderer_(std::make_shared<TapeIndicatorRenderer>())
+{
+  setObjectName("TapeIndicator");
+  setAttribute(Qt::WA_TranslucentBackground, true);
+  setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
+}
+
+void TapeIndicator::setScale(double visible_span, double minor_step, int label_every, int decimals)
+{
+  visible_span_ = std::max(visible_span, 1e-6);
+  minor_step_ = std::max(minor_step, 1e-6);
+  label_every_ = std::max(label_every, 1);
+  decimals_ = std::max(decimals, 0);
+  updatePixelsPerUnit();
+  if (has_value_) {
+    text_ = QString::number(value_, 'f', decimals_);
+  }
+  update();
+}
+
+void TapeIndicator::setMinimum(double minimum)
+{
+  minimum_ = minimum;
+  update();
+}
+
+bool TapeIndicator::setValue(double value)
+{
+  // NaN/inf would reach the strip layout; show them as no value
+  if (!std::isfinite(value)) {
+    return clearValue();
+  }
+
+  const QString text = QString::number(value, 'f', decimals_);
+  const bool moved = !has_value_ ||
+    std::abs(value - painted_value_) * pixels_per_unit_ >= PIXEL_QUANTUM;
+  value_ = value;
+  has_value_ = true;
+  if (!moved && text == text_) {
+    return false;
+  }
+  text_ = text;
+  update();
+  return true;
+}
+
+bool TapeIndicator::clearValue()
+{
+  if (!has_value_) {
+    return false;
+  }
+  has_value_ = false;
+  text_ = "---";
+  update();
+  return true;
+}
+
+QSize TapeIndicator::sizeHint() const
+{
+  return QSize(52, 160);
+}
+
+QSize TapeIndicator::minimumSizeHint() const
+{
+  return QSize(40, 80);
+}
+
+void TapeIndicator::resizeEvent(QResizeEvent * event)
+{
+  QWidget::resizeEvent(event);
+  updatePixelsPerUnit();
+}
+
+void TapeIndicator::updatePixelsPerUnit()
+{
+  const double tape_height = TapeIndicatorRenderer::tapeRect(size(), title_).height();
+  pixels_per_unit_ = tape_height > 0.0 ? tape_height / visible_span_ : 0.0;
+}
+
+ComponentFrame TapeIndicator::frame()
+{
+  painted_value_ = value_;
+  return makeFrame(
+    renderer_, size(),
+    TapeIndicatorRenderer::State{
+      title_, side_, visible_span_, minor_step_, label_every_, minimum_,
+      value_, has_value_, text_});
+}
+
+void TapeIndicator::paintEvent(QPaintEvent * /*event*/)
+{
+  QPainter painter(this);
+  frame()(painter);
+}
+
+// ============================================================================
+// TapeIndicatorRenderer Implementation
+// ============================================================================
+
+TapeIndicatorRenderer::TapeIndicatorRenderer()
+: strip_low_(0.0),
+  strip_dirty_(true),
+  strip_state_()
+{
+  value_text_.setTextFormat(Qt::PlainText);
+  title_text_.setTextFormat(Qt::PlainText);
+}
+
+QRectF TapeIndicatorRenderer::tapeRect(const QSize & size, const QString & title)
+{
+  QStaticText title_text(title);
+  title_text.setTextFormat(Qt::PlainText);
+  title_text.prepare(QTransform(), titleFont(size));
+
+  const double title_height = title_text.size().height() + 2.0;
+  return QRectF(1.0, title_height, size.width() - 2.0, size.height() - title_height - 1.0);
+}
+
+void TapeIndicatorRenderer::rebuildGeometryCache(const QSize & size, const QString & title)
+{
+  geometry_size_ = size;
+  title_ = title;
+  const double scale = std::max(0.6, size.height() / 200.0);
+
+  title_font_ = titleFont(size);
+  label_font_ = HudFonts::monospace(std::max(6, static_cast<int>(7 * scale)));
+  value_font_ = HudFonts::monospace(std::max(7, static_cast<int>(8 * scale)), QFont::Bold);
+
+  title_text_.setText(title_);
+  title_text_.prepare(QTransform(), title_font_);
+  value_text_.prepare(QTransform(), value_font_);
+
+  tape_rect_ = tapeRect(size, title_);
+  strip_dirty_ = true;
+}
+
+bool TapeIndicatorRenderer::stripMatches(const State & state) const
+{
+  return state.side == strip_state_.side &&
+         state.visible_span == strip_state_.visible_span &&
+         state.minor_step == strip_state_.minor_step &&
+         state.label_every == strip_state_.label_every &&
+         state.minimum == strip_state_.minimum;
+}
+
+void TapeIndicatorRenderer::rebuildStrip(const State & state, double centre)
+{
+  ATTITUDE_PROFILE_SCOPE("TapeIndicatorRenderer::rebuildStrip");
+  const int strip_width = std::max(1, static_cast<int>(std::ceil(tape_rect_.width())));
+  const int strip_height =
+    std::max(1, static_cast<int>(std::ceil(tape_rect_.height() * STRIP_PAGES)));
+  strip_ = QImage(strip_width, strip_height, QImage::Format_ARGB32_Premultiplied);
+  strip_.fill(QColor(16, 18, 24, 200));
+
+  const double minor_step = state.minor_step;
+  const int label_every = state.label_every;
+  const double minimum = state.minimum;
+  const double pixels_per_unit = tape_rect_.height() / state.visible_span;
+
+  // Snapped to a tick so ticks keep their sub-pixel phase across rebuilds
+  const double span = state.visible_span * STRIP_PAGES;
+  strip_low_ = std::floor((centre - span / 2.0) / minor_step) * minor_step;
+  strip_dirty_ = false;
+  strip_state_ = state;
+
+  QPainter painter(&strip_);
+  painter.setRenderHint(QPainter::Antialiasing, true);
+  painter.setFont(label_font_);
+  const QFontMetricsF metrics(label_font_);
+
+  const double major_length = strip_width * 0.28;
+  const double minor_length = strip_width * 0.14;
+  const double major_step = minor_step * label_every;
+  const int label_decimals = std::abs(major_step - std::round(major_step)) < 1e-9 ? 0 : 1;
+  const bool ticks_right = state.side == TapeIndicator::Side::Left;
+  const double edge = ticks_right ? strip_width - 0.5 : 0.5;
+  const double direction = ticks_right ? -1.0 : 1.0;
+
+  const long long first = static_cast<long long>(std::ceil(strip_low_ / minor_step - 1e-9));
+  const long long last =
+    static_cast<long long>(std::floor((strip_low_ + span) / minor_step + 1e-9));
+  for (long long k = first; k <= last; ++k) {
+    const double value = k * minor_step;
+    if (value < minimum - 1e-9) {
+      continue;
+    }
+    const double y = strip_height - (value - strip_low_) * pixels_per_unit;
+    const bool major = ((k % label_every) + label_every) % label_every == 0;
+    const double length = major ? major_length : minor_length;
+
+    painter.setPen(QPen(major ? QColor(230, 230, 235) : QColor(150, 150, 160), 1.0));
+    painter.drawLine(QPointF(edge, y), QPointF(edge + direction * length, y));
+    if (!major) {
+      continue;
+    }
+
+    const QString label = QString::number(value, 'f', label_decimals);
+    const double label_width = metrics.horizontalAdvance(label);
+    const double gap = 2.0;
+    const double x = ticks_right ?
+      edge - length - gap - label_width :
+      edge + length + gap;
+    painter.drawText(QPointF(x, y + (metrics.ascent() - metrics.descent()) / 2.0), label);
+  }
+
+  // Floor of the scale, e.g. zero speed
+  if (std::isfinite(minimum) && minimum > strip_low_ && minimum < strip_low_ + span) {
+    const double y = strip_height - (minimum - strip_low_) * pixels_per_unit;
+    painter.setPen(QPen(QColor(230, 230, 235), 1.5));
+    painter.drawLine(QPointF(0.0, y), QPointF(strip_width, y));
+  }
+}
+
+void TapeIndicatorRenderer::paint(QPainter & painter, const QSize & size, const State & state)
+{
+  ATTITUDE_PROFILE_SCOPE("TapeIndicatorRenderer::paint");
+  if (size != geometry_size_ || state.title != title_) {
+    rebuildGeometryCache(size, state.title);
+  }
+  if (tape_rect_.width() <= 0.0 || tape_rect_.height() <= 0.0) {
+    return;
+  }
+  if (state.text != text_) {
+    text_ = state.text;
+    value_text_.setText(text_);
+    value_text_.prepare(QTransform(), value_font_);
+  }
+
+  painter.setRenderHint(QPainter::Antialiasing, true);
+
+  const QSizeF title_size = title_text_.size();
+  painter.setFont(title_font_);
+  painter.setPen(QColor(160, 165, 185));
+  painter.drawStaticText(QPointF((size.width() - title_size.width()) / 2.0, 0.0), title_text_);
+
+  const double centre_y = tape_rect_.center().y();
+  if (state.has_value) {
+    // Re-render only once the window nears the strip's ends
+    const double value = state.value;
+    const double span = state.visible_span * STRIP_PAGES;
+    const double margin = state.visible_span / 2.0;
+    if (strip_dirty_ || strip_.isNull() || !stripMatches(state) ||
+      value - margin < strip_low_ || value + margin > strip_low_ + span)
+    {
+      rebuildStrip(state, value);
+    }
+
+    // One blit of the window centred on the value
+    const double pixels_per_unit = tape_rect_.height() / state.visible_span;
+    const double value_row = strip_.height() - (value - strip_low_) * pixels_per_unit;
+    const QRectF source(
+      0.0, value_row - tape_rect_.height() / 2.0, strip_.width(), tape_rect_.height());
+    painter.drawImage(tape_rect_, strip_, source);
+  } else {
+    painter.fillRect(tape_rect_, QColor(16, 18, 24, 200));
+  }
+
+  painter.setPen(QPen(QColor(65, 70, 85), 1.0));
+  painter.setBrush(Qt::NoBrush);
+  painter.drawRect(tape_rect_.adjusted(0.5, 0.5, -0.5, -0.5));
+
+  // Value box with a pointer towards the attitude indicator
+  const bool left = state.side == TapeIndicator::Side::Left;
+  const QSizeF text_size = value_text_.size();
+  const double box_height = text_size.height() + 4.0;
+  const double pointer = box_height / 2.0;
+  const double box_width = std::min(tape_rect_.width() - pointer, text_size.width() + 6.0);
+  const double box_left = left ?
+    tape_rect_.right() - pointer - box_width : tape_rect_.left() + pointer;
+  const QRectF box(box_left, centre_y - box_height / 2.0, box_width, box_height);
+
+  QPolygonF outline;
+  if (left) {
+    outline << box.topLeft() << box.topRight() << QPointF(box.right() + pointer, centre_y)
+            << box.bottomRight() << box.bottomLeft();
+  } else {
+    outline << box.topLeft() << box.topRight() << box.bottomRight() << box.bottomLeft()
+            << QPointF(box.left() - pointer, centre_y);
+  }
+  painter.setPen(QPen(QColor(230, 230, 235), 1.0));
+  painter.setBrush(QColor(0, 0, 0, 230));
+  painter.drawPolygon(outline);
+
+  painter.setFont(value_font_);
+  painter.setPen(state.has_value ? QColor(255, 255, 255) : QColor(150, 150, 160));
+  painter.drawStaticText(
+    QPointF(box.center().x() - text_size.width() / 2.0, centre_y - text_size.height() / 2.0),
+    value_text_);
+}
+
+}  // namespace widgets
+}  // namespace rviz_attitude_plugin
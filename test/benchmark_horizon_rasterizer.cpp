@@ -0,0 +1,123 @@
+/*
+ * Times the horizon disk: QPainter baseline vs HorizonRasterizer, and the
+ * SSE2 span filler vs its scalar reference. Run by hand; not part of ctest.
+ */
+#include "rviz_attitude_plugin/widgets/horizon_rasterizer.hpp"
+
+#include <QBrush>
+#include <QColor>
+#include <QImage>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPen>
+#include <QPointF>
+#include <QRectF>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+using rviz_attitude_plugin::widgets::HorizonRasterizer;
+
+namespace
+{
+
+constexpr int FRAMES = 500;
+
+double millisecondsPerRun(int runs, const std::function<void(int)> & body)
+{
+  body(0);  // warm up caches and lazily built tables
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; ++i) {
+    body(i);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - begin).count() / runs;
+}
+
+void paintBaseline(QImage & image, double radius, double pitch_offset, double roll)
+{
+  image.fill(Qt::transparent);
+  QPainter painter(&image);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.translate(image.width() / 2.0, image.height() / 2.0);
+  QPainterPath clip;
+  clip.addEllipse(QPointF(0.0, 0.0), radius, radius);
+  painter.setClipPath(clip);
+  painter.rotate(roll);
+  painter.translate(0.0, -pitch_offset);
+
+  QLinearGradient sky_gradient(0, -radius, 0, 0);
+  sky_gradient.setColorAt(0.0, QColor(0, 80, 160));
+  sky_gradient.setColorAt(0.3, QColor(0, 120, 200));
+  sky_gradient.setColorAt(0.7, QColor(30, 150, 220));
+  sky_gradient.setColorAt(1.0, QColor(135, 206, 250));
+  QLinearGradient ground_gradient(0, 0, 0, radius);
+  ground_gradient.setColorAt(0.0, QColor(85, 140, 85));
+  ground_gradient.setColorAt(0.3, QColor(65, 120, 65));
+  ground_gradient.setColorAt(0.7, QColor(45, 100, 45));
+  ground_gradient.setColorAt(1.0, QColor(25, 80, 25));
+
+  const double half_width = radius + 2.0;
+  const double depth = 2.0 * radius + 2.0;
+  painter.fillRect(QRectF(-half_width, -depth, 2.0 * half_width, depth), QBrush(sky_gradient));
+  painter.fillRect(QRectF(-half_width, 0.0, 2.0 * half_width, depth), QBrush(ground_gradient));
+  painter.setPen(QPen(QColor(255, 255, 255, 60), 6));
+  painter.drawLine(QPointF(-radius, 0), QPointF(radius, 0));
+  painter.setPen(QPen(QColor(255, 255, 255), 3));
+  painter.drawLine(QPointF(-radius, 0), QPointF(radius, 0));
+  painter.setPen(QPen(QColor(255, 255, 100), 1));
+  painter.drawLine(QPointF(-radius, 0), QPointF(radius, 0));
+}
+
+}  // namespace
+
+int main()
+{
+  std::printf("%8s %14s %14s %14s %14s\n",
+    "radius", "qpainter ms", "raster ms", "span sse ms", "span scalar ms");
+
+  for (const double radius : {60.0, 120.0, 240.0, 400.0}) {
+    const int side = HorizonRasterizer::imageSide(radius);
+    QImage image(side, side, QImage::Format_ARGB32_Premultiplied);
+    HorizonRasterizer rasterizer;
+    rasterizer.configure(radius, 1.0);
+
+    // Slowly rolling and pitching, like a live attitude stream
+    auto roll = [](int i) {return -60.0 + (i % 120);};
+    auto pitch = [radius](int i) {return radius * 0.5 * std::sin(i * 0.05);};
+
+    const double baseline = millisecondsPerRun(FRAMES, [&](int i) {
+          paintBaseline(image, radius, pitch(i), roll(i));
+        });
+    const double raster = millisecondsPerRun(FRAMES, [&](int i) {
+          rasterizer.render(
+            image, QPointF(side / 2.0, side / 2.0), pitch(i), roll(i));
+        });
+
+    // One disk's worth of interior spans through a table of the same size
+    std::vector<uint32_t> lut(static_cast<size_t>(8.0 * (radius + 8.0)) + 1, 0xff336699u);
+    std::vector<uint32_t> row(static_cast<size_t>(side));
+    const int count = static_cast<int>(2.0 * radius);
+    auto spans = [&](decltype(&HorizonRasterizer::fillSpan) fill, int i) {
+        const float step = static_cast<float>(-4.0 * std::sin(roll(i) * M_PI / 180.0));
+        for (int y = 0; y < count; ++y) {
+          fill(lut.data(), lut.size(), row.data(), count, 4.0f * y, step);
+        }
+      };
+    const double span_sse = millisecondsPerRun(FRAMES, [&](int i) {
+          spans(&HorizonRasterizer::fillSpan, i);
+        });
+    const double span_scalar = millisecondsPerRun(FRAMES, [&](int i) {
+          spans(&HorizonRasterizer::fillSpanScalar, i);
+        });
+
+    std::printf("%8.0f %14.3f %14.3f %14.3f %14.3f\n",
+      radius, baseline, raster, span_sse, span_scalar);
+  }
+  return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Times delivery from an in-process publisher to an AttitudeSubscriber with
+ * intra-process delivery on and off. Run by hand; not part of ctest.
+ */
+#include "rviz_attitude_plugin/supported_types.hpp"
+#include "rviz_attitude_plugin/topic_utilities.hpp"
+
+#include <rclcpp/rclcpp.hpp>
+#include <geometry_msgs/msg/pose_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using rviz_attitude_plugin::AttitudeSample;
+using rviz_attitude_plugin::AttitudeSubscriber;
+using rviz_attitude_plugin::SupportedTypes;
+
+namespace
+{
+
+constexpr int WARMUP = 100;
+constexpr int MESSAGES = 5000;
+constexpr auto RECEIVE_TIMEOUT = std::chrono::seconds(1);
+
+struct Result
+{
+  double mean_us{0.0};
+  double p50_us{0.0};
+  double p99_us{0.0};
+  double messages_per_s{0.0};
+  int lost{0};
+};
+
+// One message in flight at a time: publish, then spin until it arrives
+template<typename MessageT>
+Result run(const std::string & type, bool intra_process)
+{
+  auto node = std::make_shared<rclcpp::Node>("benchmark_intra_process");
+  const std::string topic = "/benchmark_intra_process/attitude";
+
+  // The publisher always allows intra-process delivery; the subscription decides
+  rclcpp::PublisherOptions publisher_options;
+  publisher_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+  auto publisher = node->create_publisher<MessageT>(topic, rclcpp::QoS(10), publisher_options);
+
+  bool received = false;
+  AttitudeSubscriber subscriber;
+  subscriber.start(
+    node.get(), topic, type, [&received](const AttitudeSample &) {received = true;},
+    intra_process);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+
+  // Wait for discovery on the middleware path
+  while (publisher->get_subscription_count() == 0) {
+    executor.spin_some(std::chrono::milliseconds(10));
+  }
+
+  Result result;
+  std::vector<double> latencies_us;
+  latencies_us.reserve(MESSAGES);
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < WARMUP + MESSAGES; ++i) {
+    if (i == WARMUP) {
+      latencies_us.clear();
+      begin = std::chrono::steady_clock::now();
+    }
+
+    auto msg = std::make_unique<MessageT>();
+    msg->header.frame_id = "base_link";
+    received = false;
+    const auto sent = std::chrono::steady_clock::now();
+    publisher->publish(std::move(msg));
+    while (!received && std::chrono::steady_clock::now() - sent < RECEIVE_TIMEOUT) {
+      executor.spin_once(RECEIVE_TIMEOUT);
+    }
+    if (!received) {
+      result.lost += i >= WARMUP;
+      continue;
+    }
+    latencies_us.push_back(
+      std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+  }
+  const auto end = std::chrono::steady_clock::now();
+  subscriber.stop();
+
+  if (latencies_us.empty()) {
+    return result;
+  }
+  double sum = 0.0;
+  for (const double latency : latencies_us) {
+    sum += latency;
+  }
+  result.mean_us = sum / latencies_us.size();
+  std::sort(latencies_us.begin(), latencies_us.end());
+  result.p50_us = latencies_us[latencies_us.size() / 2];
+  result.p99_us = latencies_us[latencies_us.size() * 99 / 100];
+  result.messages_per_s = (MESSAGES - result.lost) /
+    std::chrono::duration<double>(end - begin).count();
+  return result;
+}
+
+template<typename MessageT>
+void report(const std::string & type)
+{
+  for (const bool intra_process : {true, false}) {
+    const Result result = run<MessageT>(type, intra_process);
+    std::printf("%-28s %6s %10.1f %10.1f %10.1f %12.0f %6d\n",
+      type.c_str(), intra_process ? "intra" : "rmw",
+      result.mean_us, result.p50_us, result.p99_us, result.messages_per_s, result.lost);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+
+  std::printf("%-28s %6s %10s %10s %10s %12s %6s\n",
+    "type", "path", "mean us", "p50 us", "p99 us", "msg/s", "lost");
+  report<geometry_msgs::msg::PoseStamped>(std::string(SupportedTypes::PoseStamped));
+  report<nav_msgs::msg::Odometry>(std::string(SupportedTypes::Odometry));
+
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,161 @@
+#include "rviz_attitude_plugin/atlas_packer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using rviz_attitude_plugin::AtlasPacker;
+
+namespace
+{
+
+// Panels of one 320x240 HUD with every optional component shown, besides
+// the background capsule: heading, attitude, two tapes, three readouts,
+// three statistics readouts, spectrum and perf strip
+const std::vector<QSize> & componentSizes()
+{
+  static const std::vector<QSize> sizes = {
+    {120, 120}, {150, 150}, {44, 150}, {44, 150},
+    {95, 40}, {95, 40}, {95, 40},
+    {95, 40}, {95, 40}, {95, 40},
+    {316, 60}, {316, 24},
+  };
+  return sizes;
+}
+
+// The capsule behind the indicators, drawn by the root panel
+const QSize CAPSULE_SIZE(316, 150);
+
+QSize bucketed(const QSize & size, unsigned int step)
+{
+  return QSize(
+    static_cast<int>(AtlasPacker::bucketedExtent(static_cast<unsigned int>(size.width()), step)),
+    static_cast<int>(AtlasPacker::bucketedExtent(static_cast<unsigned int>(size.height()), step)));
+}
+
+// Region sizes one display reserves, as OverlayPanel asks for them
+std::vector<QSize> displayRegions(unsigned int component_step)
+{
+  std::vector<QSize> regions = {bucketed(CAPSULE_SIZE, AtlasPacker::HUD_BUCKET_PX)};
+  for (const QSize & size : componentSizes()) {
+    regions.push_back(bucketed(size, component_step));
+  }
+  return regions;
+}
+
+// Packs whole displays until one no longer fits; returns how many did
+int fillWithDisplays(AtlasPacker & packer, unsigned int component_step, std::vector<QRect> & rects)
+{
+  const std::vector<QSize> regions = displayRegions(component_step);
+  for (int displays = 0;; ++displays) {
+    for (const QSize & size : regions) {
+      QRect rect;
+      if (!packer.pack(size.width(), size.height(), rect)) {
+        return displays;
+      }
+      rects.push_back(rect);
+    }
+  }
+}
+
+void expectDisjointAndInside(const std::vector<QRect> & rects)
+{
+  const QRect atlas(0, 0, AtlasPacker::ATLAS_WIDTH_PX, AtlasPacker::ATLAS_MAX_HEIGHT_PX);
+  for (size_t i = 0; i < rects.size(); ++i) {
+    ASSERT_TRUE(atlas.contains(rects[i])) << "rect " << i;
+    for (size_t j = i + 1; j < rects.size(); ++j) {
+      ASSERT_FALSE(rects[i].intersects(rects[j])) << "rects " << i << " and " << j;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(AtlasPacker, BucketsRoundUpAndStopAtTheOverlayMaximum)
+{
+  EXPECT_EQ(AtlasPacker::bucketedExtent(95, AtlasPacker::COMPONENT_BUCKET_PX), 96u);
+  EXPECT_EQ(AtlasPacker::bucketedExtent(40, AtlasPacker::COMPONENT_BUCKET_PX), 48u);
+  EXPECT_EQ(AtlasPacker::bucketedExtent(320, AtlasPacker::HUD_BUCKET_PX), 384u);
+  EXPECT_EQ(AtlasPacker::bucketedExtent(790, AtlasPacker::HUD_BUCKET_PX), 800u);
+  EXPECT_EQ(AtlasPacker::bucketedExtent(900, AtlasPacker::HUD_BUCKET_PX), 900u);
+  EXPECT_EQ(AtlasPacker::bucketedExtent(1, AtlasPacker::HUD_BUCKET_PX), 128u);
+}
+
+TEST(AtlasPacker, ComponentPanelsStayCloseToTheirSize)
+{
+  long long content = 0;
+  long long reserved = 0;
+  for (const QSize & size : componentSizes()) {
+    const QSize region = bucketed(size, AtlasPacker::COMPONENT_BUCKET_PX);
+    content += static_cast<long long>(size.width()) * size.height();
+    reserved += static_cast<long long>(region.width()) * region.height();
+  }
+  EXPECT_LT(reserved, content * 5 / 4);
+}
+
+TEST(AtlasPacker, FitsManyDisplays)
+{
+  AtlasPacker packer;
+  std::vector<QRect> rects;
+  const int displays = fillWithDisplays(packer, AtlasPacker::COMPONENT_BUCKET_PX, rects);
+  expectDisjointAndInside(rects);
+
+  // Components bucketed like the whole HUD reserve several times their size
+  AtlasPacker coarse;
+  std::vector<QRect> coarse_rects;
+  const int coarse_displays = fillWithDisplays(coarse, AtlasPacker::HUD_BUCKET_PX, coarse_rects);
+
+  EXPECT_GE(displays, 32);
+  EXPECT_GT(displays, coarse_displays * 3 / 2);
+  EXPECT_LE(packer.usedHeight(), AtlasPacker::ATLAS_MAX_HEIGHT_PX);
+}
+
+TEST(AtlasPacker, RepackReclaimsReleasedDisplays)
+{
+  AtlasPacker packer;
+  std::vector<QRect> rects;
+  fillWithDisplays(packer, AtlasPacker::COMPONENT_BUCKET_PX, rects);
+
+  // Every other display goes away; shelves never reuse the holes by themselves
+  const size_t per_display = displayRegions(AtlasPacker::COMPONENT_BUCKET_PX).size();
+  std::vector<QSize> live;
+  for (size_t i = 0; i + per_display <= rects.size(); i += 2 * per_display) {
+    for (size_t k = 0; k < per_display; ++k) {
+      live.push_back(rects[i + k].size());
+    }
+  }
+  const QSize large = bucketed(QSize(640, 480), AtlasPacker::HUD_BUCKET_PX);
+  QRect rect;
+  ASSERT_FALSE(packer.pack(large.width(), large.height(), rect));
+
+  std::vector<QRect> placed;
+  ASSERT_TRUE(packer.repack(live, placed, large.width(), large.height(), rect));
+  ASSERT_EQ(placed.size(), live.size());
+  for (size_t i = 0; i < live.size(); ++i) {
+    EXPECT_EQ(placed[i].size(), live[i]);
+  }
+  placed.push_back(rect);
+  expectDisjointAndInside(placed);
+  EXPECT_LT(packer.usedHeight(), AtlasPacker::ATLAS_MAX_HEIGHT_PX);
+}
+
+TEST(AtlasPacker, FailedRepackKeepsTheLayout)
+{
+  AtlasPacker packer;
+  QRect first;
+  ASSERT_TRUE(packer.pack(400, 300, first));
+  const int used = packer.usedHeight();
+
+  // More than the atlas holds
+  const std::vector<QSize> live(40, QSize(800, 800));
+  std::vector<QRect> placed;
+  QRect rect;
+  EXPECT_FALSE(packer.repack(live, placed, 100, 100, rect));
+  EXPECT_TRUE(placed.empty());
+  EXPECT_EQ(packer.usedHeight(), used);
+
+  // The old shelf still takes a rectangle beside the first one
+  QRect second;
+  ASSERT_TRUE(packer.pack(400, 300, second));
+  EXPECT_EQ(second, QRect(400, 0, 400, 300));
+}
@@ -0,0 +1,187 @@
+#include "rviz_attitude_plugin/attitude_history.hpp"
+#include "rviz_attitude_plugin/euler_converter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using rviz_attitude_plugin::AttitudeHistory;
+using rviz_attitude_plugin::AttitudeStats;
+using rviz_attitude_plugin::EulerConverter;
+
+namespace
+{
+
+constexpr int64_t NS_PER_S = 1000000000;
+
+void quaternionFromRpy(double roll, double pitch, double yaw, double q[4])
+{
+  const double cr = std::cos(roll / 2.0), sr = std::sin(roll / 2.0);
+  const double cp = std::cos(pitch / 2.0), sp = std::sin(pitch / 2.0);
+  const double cy = std::cos(yaw / 2.0), sy = std::sin(yaw / 2.0);
+  q[0] = sr * cp * cy - cr * sp * sy;
+  q[1] = cr * sp * cy + sr * cp * sy;
+  q[2] = cr * cp * sy - sr * sp * cy;
+  q[3] = cr * cp * cy + sr * sp * sy;
+}
+
+// Statistics recomputed from scratch over the stored (decoded) samples
+AttitudeStats bruteForce(const AttitudeHistory & history)
+{
+  const size_t n = history.size();
+  std::vector<int64_t> time_ns(n);
+  std::vector<float> x(n), y(n), z(n), w(n);
+  history.read(0, n, time_ns.data(), x.data(), y.data(), z.data(), w.data());
+
+  EulerConverter converter;
+  std::vector<double> roll(n), pitch(n), yaw(n);
+  for (size_t i = 0; i < n; ++i) {
+    converter.convert(x[i], y[i], z[i], w[i], roll[i], pitch[i], yaw[i]);
+  }
+
+  auto moments = [n](const std::vector<double> & values, double & mean, double & stddev) {
+      mean = 0.0;
+      for (const double value : values) {
+        mean += value;
+      }
+      mean /= n;
+      double m2 = 0.0;
+      for (const double value : values) {
+        m2 += (value - mean) * (value - mean);
+      }
+      stddev = n > 1 ? std::sqrt(m2 / n) : 0.0;
+    };
+
+  AttitudeStats stats;
+  stats.count = n;
+  stats.span_s = n > 0 ? (time_ns.back() - time_ns.front()) * 1e-9 : 0.0;
+  moments(roll, stats.roll_mean, stats.roll_stddev);
+  moments(pitch, stats.pitch_mean, stats.pitch_stddev);
+  stats.roll_min = *std::min_element(roll.begin(), roll.end());
+  stats.roll_max = *std::max_element(roll.begin(), roll.end());
+  stats.pitch_min = *std::min_element(pitch.begin(), pitch.end());
+  stats.pitch_max = *std::max_element(pitch.begin(), pitch.end());
+
+  double sin_sum = 0.0;
+  double cos_sum = 0.0;
+  for (const double value : yaw) {
+    sin_sum += std::sin(value);
+    cos_sum += std::cos(value);
+  }
+  stats.yaw_mean = std::atan2(sin_sum, cos_sum);
+  stats.yaw_resultant = std::min(1.0, std::hypot(sin_sum, cos_sum) / n);
+  return stats;
+}
+
+void expectMatches(const AttitudeStats & actual, const AttitudeStats & expected)
+{
+  ASSERT_EQ(actual.count, expected.count);
+  EXPECT_NEAR(actual.span_s, expected.span_s, 1e-9);
+  EXPECT_NEAR(actual.roll_mean, expected.roll_mean, 1e-9);
+  EXPECT_NEAR(actual.roll_stddev, expected.roll_stddev, 1e-9);
+  EXPECT_NEAR(actual.pitch_mean, expected.pitch_mean, 1e-9);
+  EXPECT_NEAR(actual.pitch_stddev, expected.pitch_stddev, 1e-9);
+  // Extremes are picked, not accumulated, so they are exact
+  EXPECT_EQ(actual.roll_min, expected.roll_min);
+  EXPECT_EQ(actual.roll_max, expected.roll_max);
+  EXPECT_EQ(actual.pitch_min, expected.pitch_min);
+  EXPECT_EQ(actual.pitch_max, expected.pitch_max);
+  EXPECT_NEAR(std::remainder(actual.yaw_mean - expected.yaw_mean, 2.0 * M_PI), 0.0, 1e-9);
+  EXPECT_NEAR(actual.yaw_resultant, expected.yaw_resultant, 1e-9);
+}
+
+}  // namespace
+
+TEST(AttitudeHistory, SlidingStatisticsMatchBruteForce)
+{
+  AttitudeHistory history;
+  history.setWindow(2.0);
+
+  std::mt19937 generator(73);
+  std::normal_distribution<double> noise(0.0, 0.05);
+  const int64_t step_ns = NS_PER_S / 1000;
+  std::vector<int64_t> pushed;
+
+  // 1 kHz for 90 s: enough removals to go through a sum rebuild
+  for (int i = 0; i < 90000; ++i) {
+    const int64_t time_ns = i * step_ns;
+    const double t = time_ns * 1e-9;
+
+    // Ramps grow the monotonic queues past their initial size; the yaw
+    // noise straddles the +-pi wrap
+    const double roll = (i / 4000) % 2 == 0 ?
+      -0.8 + 0.4 * std::fmod(t, 4.0) : 0.3 * std::sin(t * 3.0) + noise(generator);
+    const double pitch = 0.2 * std::cos(t * 0.7) + noise(generator);
+    const double yaw = std::remainder(M_PI + noise(generator), 2.0 * M_PI);
+    double q[4];
+    quaternionFromRpy(roll, pitch, yaw, q);
+    history.push(time_ns, q[0], q[1], q[2], q[3]);
+    pushed.push_back(time_ns);
+
+    if (i % 997 == 0 || i == 89999) {
+      SCOPED_TRACE(testing::Message() << "sample " << i);
+      // Whole-microsecond stamps are stored exactly, so eviction is by raw time
+      const size_t inside = static_cast<size_t>(
+        pushed.end() - std::lower_bound(pushed.begin(), pushed.end(), time_ns - 2 * NS_PER_S));
+      ASSERT_EQ(history.size(), inside);
+      expectMatches(history.stats(), bruteForce(history));
+    }
+  }
+}
+
+TEST(AttitudeHistory, StatisticsHoldWhileSumsAreRebuilt)
+{
+  AttitudeHistory history;
+  history.setWindow(0.2);
+
+  // 200 samples in the window; the sums are rebuilt every 65536 removals
+  // over the pushes that follow, each of which is checked
+  const int64_t step_ns = NS_PER_S / 1000;
+  for (int i = 0; i < 140000; ++i) {
+    const double t = i * 1e-3;
+    double q[4];
+    quaternionFromRpy(0.5 * std::sin(t * 5.0), 0.3 * std::cos(t * 2.0), 3.0 * std::sin(t), q);
+    history.push(i * step_ns, q[0], q[1], q[2], q[3]);
+
+    if (i % 65536 < 1000 || i % 1009 == 0) {
+      SCOPED_TRACE(testing::Message() << "sample " << i);
+      expectMatches(history.stats(), bruteForce(history));
+    }
+  }
+}
+
+TEST(AttitudeHistory, ShrinkingWindowEvictsAtOnce)
+{
+  AttitudeHistory history;
+  history.setWindow(10.0);
+  for (int i = 0; i < 5000; ++i) {
+    double q[4];
+    quaternionFromRpy(0.001 * i, -0.0005 * i, 0.002 * i, q);
+    history.push(i * (NS_PER_S / 200), q[0], q[1], q[2], q[3]);
+  }
+  ASSERT_EQ(history.size(), 2001u);
+
+  history.setWindow(1.0);
+  EXPECT_EQ(history.size(), 201u);
+  expectMatches(history.stats(), bruteForce(history));
+}
+
+TEST(AttitudeHistory, StepBackInTimeStartsOver)
+{
+  AttitudeHistory history;
+  double q[4];
+  quaternionFromRpy(0.1, 0.2, 0.3, q);
+  for (int i = 0; i < 100; ++i) {
+    history.push(NS_PER_S + i * 1000000, q[0], q[1], q[2], q[3]);
+  }
+  ASSERT_EQ(history.size(), 100u);
+
+  quaternionFromRpy(-0.4, 0.0, 1.0, q);
+  history.push(0, q[0], q[1], q[2], q[3]);
+  EXPECT_EQ(history.size(), 1u);
+  expectMatches(history.stats(), bruteForce(history));
+}
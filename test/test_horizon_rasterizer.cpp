@@ -0,0 +1,185 @@
+#include "rviz_attitude_plugin/widgets/horizon_rasterizer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <QBrush>
+#include <QColor>
+#include <QImage>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPen>
+#include <QPointF>
+#include <QRectF>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using rviz_attitude_plugin::widgets::HorizonRasterizer;
+
+namespace
+{
+
+// The sky/ground disk as it was painted before HorizonRasterizer: gradients
+// and horizon lines in the rolled frame, clipped to the circle
+QImage paintBaseline(
+  int side, const QPointF & centre, double radius, double opacity,
+  double pitch_offset, double roll)
+{
+  QImage image(side, side, QImage::Format_ARGB32_Premultiplied);
+  image.fill(Qt::transparent);
+
+  QPainter painter(&image);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.translate(centre);
+  QPainterPath clip;
+  clip.addEllipse(QPointF(0.0, 0.0), radius, radius);
+  painter.setClipPath(clip);
+  painter.rotate(roll);
+  painter.translate(0.0, -pitch_offset);
+  painter.setOpacity(opacity);
+
+  const double half_width = radius + 2.0;
+  const double depth = std::abs(pitch_offset) + radius + 2.0;
+
+  QLinearGradient sky_gradient(0, -radius, 0, 0);
+  sky_gradient.setColorAt(0.0, QColor(0, 80, 160));
+  sky_gradient.setColorAt(0.3, QColor(0, 120, 200));
+  sky_gradient.setColorAt(0.7, QColor(30, 150, 220));
+  sky_gradient.setColorAt(1.0, QColor(135, 206, 250));
+
+  QLinearGradient ground_gradient(0, 0, 0, radius);
+  ground_gradient.setColorAt(0.0, QColor(85, 140, 85));
+  ground_gradient.setColorAt(0.3, QColor(65, 120, 65));
+  ground_gradient.setColorAt(0.7, QColor(45, 100, 45));
+  ground_gradient.setColorAt(1.0, QColor(25, 80, 25));
+
+  painter.fillRect(QRectF(-half_width, -depth, 2.0 * half_width, depth), QBrush(sky_gradient));
+  painter.fillRect(QRectF(-half_width, 0.0, 2.0 * half_width, depth), QBrush(ground_gradient));
+
+  painter.setPen(QPen(QColor(255, 255, 255, 60), 6));
+  painter.drawLine(QPointF(-radius, 0), QPointF(radius, 0));
+  painter.setPen(QPen(QColor(255, 255, 255), 3));
+  painter.drawLine(QPointF(-radius, 0), QPointF(radius, 0));
+  painter.setPen(QPen(QColor(255, 255, 100), 1));
+  painter.drawLine(QPointF(-radius, 0), QPointF(radius, 0));
+  return image;
+}
+
+struct Difference
+{
+  double mean{0.0};        // per channel, 0..255
+  int large{0};            // pixels with a channel off by more than LARGE_DIFFERENCE
+  int compared{0};
+  double alpha_ratio{1.0}; // total coverage, rasterized / baseline
+};
+
+constexpr int LARGE_DIFFERENCE = 40;
+
+// The baseline clip is not antialiased, so the rim band only enters the
+// total coverage, not the per-pixel comparison
+Difference compare(
+  const QImage & actual, const QImage & expected, const QPointF & centre, double radius)
+{
+  Difference result;
+  double sum = 0.0;
+  double alpha_actual = 0.0;
+  double alpha_expected = 0.0;
+  for (int y = 0; y < actual.height(); ++y) {
+    const auto * a = reinterpret_cast<const uint32_t *>(actual.constScanLine(y));
+    const auto * e = reinterpret_cast<const uint32_t *>(expected.constScanLine(y));
+    for (int x = 0; x < actual.width(); ++x) {
+      alpha_actual += qAlpha(a[x]);
+      alpha_expected += qAlpha(e[x]);
+
+      const double distance = std::hypot(x + 0.5 - centre.x(), y + 0.5 - centre.y());
+      if (std::abs(distance - radius) < 1.5) {
+        continue;
+      }
+      const int channels[4] = {
+        std::abs(qAlpha(a[x]) - qAlpha(e[x])),
+        std::abs(qRed(a[x]) - qRed(e[x])),
+        std::abs(qGreen(a[x]) - qGreen(e[x])),
+        std::abs(qBlue(a[x]) - qBlue(e[x])),
+      };
+      sum += channels[0] + channels[1] + channels[2] + channels[3];
+      if (*std::max_element(channels, channels + 4) > LARGE_DIFFERENCE) {
+        ++result.large;
+      }
+      ++result.compared;
+    }
+  }
+  result.mean = result.compared > 0 ? sum / (4.0 * result.compared) : 0.0;
+  result.alpha_ratio = alpha_expected > 0.0 ? alpha_actual / alpha_expected : 1.0;
+  return result;
+}
+
+}  // namespace
+
+TEST(HorizonRasterizer, MatchesQPainterBaseline)
+{
+  struct Pose
+  {
+    double pitch;   // horizon offset as a fraction of the radius
+    double roll;    // degrees
+  };
+  const Pose poses[] = {
+    {0.0, 0.0}, {0.25, 0.0}, {-0.4, 30.0}, {0.6, -45.0},
+    {-0.9, 135.0}, {0.1, 180.0}, {0.3, -90.0}, {0.05, 7.5},
+  };
+
+  for (const double radius : {48.0, 120.5}) {
+    for (const double opacity : {1.0, 0.7}) {
+      HorizonRasterizer rasterizer;
+      rasterizer.configure(radius, opacity);
+      const int side = HorizonRasterizer::imageSide(radius);
+      const QPointF centre(side / 2.0 + 0.25, side / 2.0 - 0.125);
+
+      for (const Pose & pose : poses) {
+        SCOPED_TRACE(
+          testing::Message() << "radius " << radius << " opacity " << opacity <<
+            " pitch " << pose.pitch << " roll " << pose.roll);
+        const double pitch_offset = pose.pitch * radius;
+
+        QImage actual(side, side, QImage::Format_ARGB32_Premultiplied);
+        rasterizer.render(actual, centre, pitch_offset, pose.roll);
+        const QImage expected =
+          paintBaseline(side, centre, radius, opacity, pitch_offset, pose.roll);
+
+        const Difference difference = compare(actual, expected, centre, radius);
+        ASSERT_GT(difference.compared, 0);
+        EXPECT_LT(difference.mean, 2.0);
+        EXPECT_LE(difference.large, difference.compared / 100);
+        EXPECT_NEAR(difference.alpha_ratio, 1.0, 0.01);
+      }
+    }
+  }
+}
+
+TEST(HorizonRasterizer, FillSpanMatchesScalar)
+{
+  std::vector<uint32_t> lut(2048);
+  for (size_t i = 0; i < lut.size(); ++i) {
+    lut[i] = static_cast<uint32_t>(i * 2654435761u);
+  }
+
+  std::mt19937 generator(60);
+  std::uniform_real_distribution<float> index(-64.0f, 2112.0f);
+  std::uniform_real_distribution<float> step(-4.0f, 4.0f);
+  std::vector<uint32_t> actual(512);
+  std::vector<uint32_t> expected(512);
+  for (int run = 0; run < 10000; ++run) {
+    const int count = run % 512;
+    const float first = index(generator);
+    const float stride = run % 16 == 0 ? 0.0f : step(generator);
+    HorizonRasterizer::fillSpan(lut.data(), lut.size(), actual.data(), count, first, stride);
+    HorizonRasterizer::fillSpanScalar(
+      lut.data(), lut.size(), expected.data(), count, first, stride);
+    ASSERT_TRUE(std::equal(expected.begin(), expected.begin() + count, actual.begin())) <<
+      "index " << first << " step " << stride << " count " << count;
+  }
+}
@@ -0,0 +1,170 @@
+#include "rviz_attitude_plugin/imu_filter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+using rviz_attitude_plugin::ImuFilterConfig;
+using rviz_attitude_plugin::ImuFilterMode;
+using rviz_attitude_plugin::ImuOrientationFilter;
+
+namespace
+{
+
+constexpr int64_t NS_PER_S = 1000000000;
+constexpr int64_t STEP_NS = NS_PER_S / 100;  // 100 Hz IMU
+constexpr double GRAVITY = 9.80665;
+
+struct Rpy
+{
+  double roll;
+  double pitch;
+  double yaw;
+};
+
+// ZYX Euler angles of a unit quaternion
+Rpy rpyFromQuaternion(const geometry_msgs::msg::Quaternion & q)
+{
+  Rpy rpy;
+  rpy.roll = std::atan2(2.0 * (q.w * q.x + q.y * q.z), 1.0 - 2.0 * (q.x * q.x + q.y * q.y));
+  rpy.pitch = std::asin(std::max(-1.0, std::min(1.0, 2.0 * (q.w * q.y - q.z * q.x))));
+  rpy.yaw = std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+  return rpy;
+}
+
+sensor_msgs::msg::Imu sample(
+  double gx, double gy, double gz, double ax, double ay, double az)
+{
+  sensor_msgs::msg::Imu msg;
+  msg.orientation_covariance[0] = -1.0;
+  msg.angular_velocity.x = gx;
+  msg.angular_velocity.y = gy;
+  msg.angular_velocity.z = gz;
+  msg.linear_acceleration.x = ax;
+  msg.linear_acceleration.y = ay;
+  msg.linear_acceleration.z = az;
+  return msg;
+}
+
+// Specific force of a body at rest with the given roll and pitch
+sensor_msgs::msg::Imu restingAt(double roll, double pitch)
+{
+  return sample(
+    0.0, 0.0, 0.0,
+    -GRAVITY * std::sin(pitch),
+    GRAVITY * std::sin(roll) * std::cos(pitch),
+    GRAVITY * std::cos(roll) * std::cos(pitch));
+}
+
+ImuOrientationFilter makeFilter(ImuFilterMode mode, double gain)
+{
+  ImuFilterConfig config;
+  config.mode = mode;
+  config.gain = gain;
+  return ImuOrientationFilter(config);
+}
+
+}  // namespace
+
+TEST(ImuOrientationFilter, NeedsEstimateOnlyWithoutOrientation)
+{
+  sensor_msgs::msg::Imu msg;
+  EXPECT_FALSE(ImuOrientationFilter::needsEstimate(msg));
+  msg.orientation_covariance[0] = -1.0;
+  EXPECT_TRUE(ImuOrientationFilter::needsEstimate(msg));
+}
+
+TEST(ImuOrientationFilter, StaticTiltConvergesToGravity)
+{
+  const double roll = 0.4;
+  const double pitch = -0.25;
+
+  // Madgwick steps a fixed beta towards gravity and chatters by about
+  // beta * dt around it, so it gets the smaller gain
+  const std::pair<ImuFilterMode, double> modes[] = {
+    {ImuFilterMode::Madgwick, 0.1}, {ImuFilterMode::Complementary, 1.0}};
+  for (const auto & [mode, gain] : modes) {
+    SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode));
+    ImuOrientationFilter filter = makeFilter(mode, gain);
+
+    // Starts level, then the accelerometer alone has to pull it over. The
+    // last AVERAGED updates are averaged so Madgwick's chatter cancels out;
+    // yaw is unobservable and keeps whatever the correction path left
+    constexpr int STEPS = 3000;
+    constexpr int AVERAGED = 500;
+    filter.update(restingAt(0.0, 0.0), 0);
+    double roll_sum = 0.0;
+    double pitch_sum = 0.0;
+    double worst = 0.0;
+    for (int i = 1; i <= STEPS; ++i) {
+      const Rpy rpy = rpyFromQuaternion(filter.update(restingAt(roll, pitch), i * STEP_NS));
+      if (i > STEPS - AVERAGED) {
+        roll_sum += rpy.roll;
+        pitch_sum += rpy.pitch;
+        worst = std::max({worst, std::abs(rpy.roll - roll), std::abs(rpy.pitch - pitch)});
+      }
+    }
+
+    EXPECT_NEAR(roll_sum / AVERAGED, roll, 1e-3);
+    EXPECT_NEAR(pitch_sum / AVERAGED, pitch, 1e-3);
+
+    // Every single update stays within the chatter bound (2 * beta * dt for Madgwick)
+    EXPECT_LT(worst, std::max(3e-3, 4.0 * gain * STEP_NS * 1e-9));
+  }
+}
+
+TEST(ImuOrientationFilter, GyroWithoutGravityIntegratesYaw)
+{
+  const double yaw_rate = 0.5;
+
+  for (const ImuFilterMode mode : {ImuFilterMode::Madgwick, ImuFilterMode::Complementary}) {
+    SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode));
+    ImuOrientationFilter filter = makeFilter(mode, 0.5);
+
+    // Zero specific force: free fall, nothing to correct against
+    geometry_msgs::msg::Quaternion q = filter.update(sample(0.0, 0.0, yaw_rate, 0.0, 0.0, 0.0), 0);
+    for (int i = 1; i <= 200; ++i) {
+      q = filter.update(sample(0.0, 0.0, yaw_rate, 0.0, 0.0, 0.0), i * STEP_NS);
+    }
+
+    const Rpy rpy = rpyFromQuaternion(q);
+    EXPECT_NEAR(rpy.yaw, yaw_rate * 2.0, 1e-3);
+    EXPECT_NEAR(rpy.roll, 0.0, 1e-9);
+    EXPECT_NEAR(rpy.pitch, 0.0, 1e-9);
+  }
+}
+
+TEST(ImuOrientationFilter, LongGapRelevelsFromAccelerometer)
+{
+  const double roll = -0.3;
+  const double pitch = 0.6;
+
+  for (const ImuFilterMode mode : {ImuFilterMode::Madgwick, ImuFilterMode::Complementary}) {
+    SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode));
+    ImuOrientationFilter filter = makeFilter(mode, 0.1);
+
+    // Level, turning about z: the estimate picks up yaw
+    int64_t stamp_ns = 0;
+    for (int i = 0; i <= 100; ++i) {
+      stamp_ns = i * STEP_NS;
+      filter.update(sample(0.0, 0.0, 1.0, 0.0, 0.0, GRAVITY), stamp_ns);
+    }
+
+    // Just within the limit the sample is integrated, not re-levelled
+    const int64_t within_ns = static_cast<int64_t>(ImuOrientationFilter::MAX_STEP_S * NS_PER_S);
+    stamp_ns += within_ns;
+    Rpy rpy = rpyFromQuaternion(filter.update(restingAt(roll, pitch), stamp_ns));
+    EXPECT_GT(std::abs(rpy.yaw), 0.5);
+    EXPECT_GT(std::abs(rpy.roll - roll), 0.1);
+
+    // A longer gap restarts from gravity at once, dropping the yaw
+    stamp_ns += within_ns + STEP_NS;
+    rpy = rpyFromQuaternion(filter.update(restingAt(roll, pitch), stamp_ns));
+    EXPECT_NEAR(rpy.roll, roll, 1e-9);
+    EXPECT_NEAR(rpy.pitch, pitch, 1e-9);
+    EXPECT_NEAR(rpy.yaw, 0.0, 1e-9);
+  }
+}
@@ -0,0 +1,116 @@
+#include "rviz_attitude_plugin/attitude_widget.hpp"
+
+#include <gtest/gtest.h>
+
+#include <QApplication>
+#include <QColor>
+#include <QImage>
+#include <QLayout>
+#include <QPainter>
+#include <QPoint>
+#include <QRegion>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+using rviz_attitude_plugin::AttitudeWidget;
+
+namespace
+{
+
+// Straight alpha, as the overlay was blended before: (SRC_ALPHA, ONE_MINUS_SRC_ALPHA)
+int blendStraight(int source, int alpha, int dest)
+{
+  return static_cast<int>(std::lround((source * alpha + dest * (255 - alpha)) / 255.0));
+}
+
+// Premultiplied, as the atlas material blends now: (ONE, ONE_MINUS_SRC_ALPHA)
+int blendPremultiplied(int source, int alpha, int dest)
+{
+  return static_cast<int>(std::lround(source + dest * (255 - alpha) / 255.0));
+}
+
+QImage paintHud(AttitudeWidget & widget, QImage::Format format)
+{
+  QImage image(widget.size(), format);
+  image.fill(Qt::transparent);
+  QPainter painter(&image);
+  widget.render(&painter, QPoint(0, 0), QRegion(), QWidget::DrawChildren);
+  painter.end();
+  return image;
+}
+
+class OverlayBlendTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    if (QApplication::instance()) {
+      return;
+    }
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    static int argc = 1;
+    static char name[] = "test_overlay_blend";
+    static char * argv[] = {name, nullptr};
+    application_ = std::make_unique<QApplication>(argc, argv);
+  }
+
+  static std::unique_ptr<QApplication> application_;
+};
+
+std::unique_ptr<QApplication> OverlayBlendTest::application_;
+
+}  // namespace
+
+TEST_F(OverlayBlendTest, PremultipliedMatchesStraightAlpha)
+{
+  AttitudeWidget widget;
+  widget.setShowTapes(true);
+  widget.setSpeed(12.4);
+  widget.setAltitude(104.2);
+  widget.updateAngles(0.21, -0.13, 1.2);
+  widget.resize(360, 320);
+  widget.ensurePolished();
+  if (widget.layout()) {
+    widget.layout()->activate();
+  }
+
+  const QImage straight = paintHud(widget, QImage::Format_ARGB32);
+  const QImage premultiplied = paintHud(widget, QImage::Format_ARGB32_Premultiplied);
+  ASSERT_EQ(straight.size(), premultiplied.size());
+
+  // The HUD is translucent and antialiased, so partial alpha is everywhere
+  int translucent = 0;
+  for (const QColor & background : {QColor(0, 0, 0), QColor(255, 255, 255), QColor(90, 130, 170)}) {
+    const int dest[3] = {background.red(), background.green(), background.blue()};
+    int worst = 0;
+    for (int y = 0; y < straight.height(); ++y) {
+      const auto * s = reinterpret_cast<const QRgb *>(straight.constScanLine(y));
+      const auto * p = reinterpret_cast<const QRgb *>(premultiplied.constScanLine(y));
+      for (int x = 0; x < straight.width(); ++x) {
+        const int alpha_s = qAlpha(s[x]);
+        const int alpha_p = qAlpha(p[x]);
+        if (alpha_s > 0 && alpha_s < 255) {
+          ++translucent;
+        }
+        const int source_s[3] = {qRed(s[x]), qGreen(s[x]), qBlue(s[x])};
+        const int source_p[3] = {qRed(p[x]), qGreen(p[x]), qBlue(p[x])};
+        for (int c = 0; c < 3; ++c) {
+          const int difference = std::abs(
+            blendStraight(source_s[c], alpha_s, dest[c]) -
+            blendPremultiplied(source_p[c], alpha_p, dest[c]));
+          worst = std::max(worst, difference);
+        }
+      }
+    }
+    // Every layer painted into ARGB32 is unpremultiplied and rounded again,
+    // so overlapping translucent layers drift by a few steps
+    EXPECT_LE(worst, 4) << "background " << qPrintable(background.name());
+  }
+  EXPECT_GT(translucent, 0);
+}
@@ -0,0 +1,106 @@
+#include "rviz_attitude_plugin/quaternion_codec.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace codec = rviz_attitude_plugin::quaternion_codec;
+
+namespace
+{
+
+// Rotation angle between q and the decoded (not quite unit) quaternion
+double angleBetween(const double q[4], float x, float y, float z, float w)
+{
+  const double norm = std::sqrt(
+    double(x) * x + double(y) * y + double(z) * z + double(w) * w);
+  const double dot = std::abs(q[0] * x + q[1] * y + q[2] * z + q[3] * w) / norm;
+  return 2.0 * std::acos(std::min(1.0, dot));
+}
+
+}  // namespace
+
+TEST(QuaternionCodec, ErrorStaysWithinBound)
+{
+  std::mt19937 generator(71);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  const double h = std::sqrt(0.5);
+
+  // Identity, both signs, and ties between the two largest components
+  std::vector<std::array<double, 4>> quaternions = {
+    {0.0, 0.0, 0.0, 1.0}, {0.0, 0.0, 0.0, -1.0}, {1.0, 0.0, 0.0, 0.0},
+    {h, 0.0, 0.0, h}, {h, 0.0, 0.0, -h}, {0.0, -h, h, 0.0},
+    {0.5, 0.5, 0.5, 0.5}, {-0.5, 0.5, -0.5, 0.5},
+  };
+  // Uniform on the unit 3-sphere
+  for (int i = 0; i < 1000000; ++i) {
+    std::array<double, 4> q;
+    double norm = 0.0;
+    for (double & component : q) {
+      component = normal(generator);
+      norm += component * component;
+    }
+    norm = std::sqrt(norm);
+    for (double & component : q) {
+      component /= norm;
+    }
+    quaternions.push_back(q);
+  }
+
+  double worst = 0.0;
+  for (const auto & q : quaternions) {
+    uint16_t a, b, c;
+    codec::encode(q[0], q[1], q[2], q[3], a, b, c);
+    float x, y, z, w;
+    codec::decode(a, b, c, x, y, z, w);
+    worst = std::max(worst, angleBetween(q.data(), x, y, z, w));
+  }
+  EXPECT_LT(worst, codec::MAX_ANGLE_ERROR_RAD);
+}
+
+TEST(QuaternionCodec, ZeroDecodesAsIdentity)
+{
+  uint16_t a, b, c;
+  codec::encode(0.0, 0.0, 0.0, 0.0, a, b, c);
+  float x, y, z, w;
+  codec::decode(a, b, c, x, y, z, w);
+  EXPECT_NEAR(x, 0.0f, codec::STEP);
+  EXPECT_NEAR(y, 0.0f, codec::STEP);
+  EXPECT_NEAR(z, 0.0f, codec::STEP);
+  EXPECT_NEAR(w, 1.0f, codec::STEP);
+}
+
+TEST(QuaternionCodec, BatchDecodeMatchesScalar)
+{
+  // Arbitrary words, including ones no encoder produces; an odd count
+  // leaves a remainder for the scalar tail
+  const size_t count = 1000003;
+  std::mt19937 generator(72);
+  std::uniform_int_distribution<int> word(0, 0xffff);
+  std::vector<uint16_t> a(count), b(count), c(count);
+  for (size_t i = 0; i < count; ++i) {
+    a[i] = static_cast<uint16_t>(word(generator));
+    b[i] = static_cast<uint16_t>(word(generator));
+    c[i] = static_cast<uint16_t>(word(generator));
+  }
+
+  std::vector<float> x(count), y(count), z(count), w(count);
+  codec::decode(a.data(), b.data(), c.data(), count, x.data(), y.data(), z.data(), w.data());
+
+  size_t mismatches = 0;
+  for (size_t i = 0; i < count; ++i) {
+    float expected[4];
+    codec::decode(a[i], b[i], c[i], expected[0], expected[1], expected[2], expected[3]);
+    const float actual[4] = {x[i], y[i], z[i], w[i]};
+    if (std::memcmp(expected, actual, sizeof(actual)) != 0) {
+      ++mismatches;
+    }
+  }
+  EXPECT_EQ(mismatches, 0u);
+}
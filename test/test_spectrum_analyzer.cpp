@@ -0,0 +1,153 @@
+#include "rviz_attitude_plugin/spectrum_analyzer.hpp"
+#include "rviz_attitude_plugin/render_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <QThreadPool>
+
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+using rviz_attitude_plugin::RenderPool;
+using rviz_attitude_plugin::SPECTRUM_BINS;
+using rviz_attitude_plugin::SPECTRUM_WINDOW;
+using rviz_attitude_plugin::SpectrumAnalyzer;
+using rviz_attitude_plugin::SpectrumResult;
+
+namespace
+{
+
+constexpr int64_t NS_PER_S = 1000000000;
+constexpr double SAMPLE_RATE_HZ = 200.0;
+constexpr double BIN_HZ = SAMPLE_RATE_HZ / SPECTRUM_WINDOW;
+
+// Roll on a bin centre, pitch between bins so the parabolic fit has work to do
+constexpr double ROLL_HZ = 16.0 * BIN_HZ;
+constexpr double PITCH_HZ = 51.3 * BIN_HZ;
+constexpr double ROLL_AMPLITUDE = 1.0;
+constexpr double PITCH_AMPLITUDE = 0.5;
+constexpr double NOISE_STDDEV = 0.01;
+
+// Enough samples for a full Welch average of overlapping segments
+constexpr int SAMPLES = 1200;
+
+void pushSinusoids(SpectrumAnalyzer & analyzer, int samples)
+{
+  std::mt19937 generator(69);
+  std::normal_distribution<double> noise(0.0, NOISE_STDDEV);
+  for (int i = 0; i < samples; ++i) {
+    const double t = i / SAMPLE_RATE_HZ;
+    analyzer.push(
+      static_cast<int64_t>(std::llround(t * NS_PER_S)),
+      ROLL_AMPLITUDE * std::sin(2.0 * M_PI * ROLL_HZ * t) + noise(generator),
+      PITCH_AMPLITUDE * std::sin(2.0 * M_PI * PITCH_HZ * t) + noise(generator));
+  }
+}
+
+// Transforms everything queued and returns the newest result
+SpectrumResult compute(SpectrumAnalyzer & analyzer)
+{
+  analyzer.poll(SAMPLES * NS_PER_S);
+  RenderPool::instance().waitForDone();
+  SpectrumResult result;
+  EXPECT_TRUE(analyzer.takeResult(result));
+  return result;
+}
+
+double integrate(const std::array<float, SPECTRUM_BINS> & db, double bin_hz)
+{
+  double power = 0.0;
+  for (const float value : db) {
+    power += std::pow(10.0, value / 10.0) * bin_hz;
+  }
+  return power;
+}
+
+size_t binOf(double frequency_hz)
+{
+  return static_cast<size_t>(std::lround(frequency_hz / BIN_HZ));
+}
+
+}  // namespace
+
+TEST(SpectrumAnalyzer, PeaksLandOnTheirOwnChannel)
+{
+  SpectrumAnalyzer analyzer;
+  pushSinusoids(analyzer, SAMPLES);
+  const SpectrumResult result = compute(analyzer);
+  ASSERT_TRUE(result.valid);
+  EXPECT_NEAR(result.sample_rate_hz, SAMPLE_RATE_HZ, 1e-6);
+
+  ASSERT_GE(result.roll_peak_count, 1u);
+  ASSERT_GE(result.pitch_peak_count, 1u);
+  EXPECT_NEAR(result.roll_peaks[0].frequency_hz, ROLL_HZ, 0.1 * BIN_HZ);
+  EXPECT_NEAR(result.pitch_peaks[0].frequency_hz, PITCH_HZ, 0.1 * BIN_HZ);
+
+  // Unpacking the shared transform leaves no trace of one channel in the other
+  const size_t roll_bin = binOf(ROLL_HZ);
+  const size_t pitch_bin = binOf(PITCH_HZ);
+  EXPECT_LT(result.pitch_db[roll_bin], result.roll_db[roll_bin] - 40.0f);
+  EXPECT_LT(result.roll_db[pitch_bin], result.pitch_db[pitch_bin] - 40.0f);
+  for (size_t i = 0; i < result.roll_peak_count; ++i) {
+    EXPECT_GT(std::abs(result.roll_peaks[i].frequency_hz - PITCH_HZ), 2.0 * BIN_HZ);
+  }
+  for (size_t i = 0; i < result.pitch_peak_count; ++i) {
+    EXPECT_GT(std::abs(result.pitch_peaks[i].frequency_hz - ROLL_HZ), 2.0 * BIN_HZ);
+  }
+}
+
+TEST(SpectrumAnalyzer, IntegratedPsdMatchesVariance)
+{
+  SpectrumAnalyzer analyzer;
+  pushSinusoids(analyzer, SAMPLES);
+  const SpectrumResult result = compute(analyzer);
+  ASSERT_TRUE(result.valid);
+
+  // A sinusoid of amplitude A carries A^2 / 2 on top of the noise variance
+  const double noise_variance = NOISE_STDDEV * NOISE_STDDEV;
+  const double roll_variance = 0.5 * ROLL_AMPLITUDE * ROLL_AMPLITUDE + noise_variance;
+  const double pitch_variance = 0.5 * PITCH_AMPLITUDE * PITCH_AMPLITUDE + noise_variance;
+  const double bin_hz = result.sample_rate_hz / SPECTRUM_WINDOW;
+  EXPECT_NEAR(integrate(result.roll_db, bin_hz), roll_variance, 0.02 * roll_variance);
+  EXPECT_NEAR(integrate(result.pitch_db, bin_hz), pitch_variance, 0.02 * pitch_variance);
+}
+
+TEST(SpectrumAnalyzer, ResetDropsTheOldStream)
+{
+  SpectrumAnalyzer analyzer;
+  SpectrumResult result;
+  analyzer.takeResult(result);
+
+  // Hold every pool worker so the transform is still queued at reset()
+  QThreadPool & pool = RenderPool::instance();
+  std::mutex mutex;
+  std::condition_variable released;
+  bool release = false;
+  for (int i = 0; i < pool.maxThreadCount(); ++i) {
+    RenderPool::post(
+      [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [&]() {return release;});
+      });
+  }
+
+  pushSinusoids(analyzer, SAMPLES);
+  analyzer.poll(SAMPLES * NS_PER_S);
+  analyzer.reset();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    release = true;
+  }
+  released.notify_all();
+  pool.waitForDone();
+
+  // Only the cleared result of the reset is published
+  ASSERT_TRUE(analyzer.takeResult(result));
+  EXPECT_FALSE(result.valid);
+  EXPECT_EQ(result.roll_peak_count, 0u);
+  EXPECT_EQ(result.pitch_peak_count, 0u);
+  EXPECT_FALSE(analyzer.takeResult(result));
+}